@@ -1,17 +1,17 @@
-
-/**
- * @file	Boolean.h
- * @brief	Defines boolean type.
- * @details	Allows boolean types to be used in a c++ style.
- * @author	Matt Drage
- * @date	11/03/2012
- */
-
-#ifndef BOOLEAN_H
-#define BOOLEAN_H
-
-#define bool int
-#define false 0
-#define true 1
-
-#endif
+
+/**
+ * @file	Boolean.h
+ * @brief	Defines boolean type.
+ * @details	Allows boolean types to be used in a c++ style.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ */
+
+#ifndef BOOLEAN_H
+#define BOOLEAN_H
+
+#define bool int
+#define false 0
+#define true 1
+
+#endif
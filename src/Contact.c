@@ -0,0 +1,433 @@
+#include "Contact.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+const float CONTACT_MARGIN = 0.01f;
+const float CONTACT_FRICTION = 0.5f;
+const float PENETRATION_SLOP = 0.005f;
+const float PENETRATION_CORRECTION = 0.2f;
+const float BOUNCE_THRESHOLD = 1.0f;
+
+/* order contacts are added in - first body, second body, feature */
+static int ContactCompare(Contact *contact, int bodyA, int bodyB, unsigned feature)
+{
+	if (contact->bodyA != bodyA)
+		return contact->bodyA < bodyA ? -1 : 1;
+	if (contact->bodyB != bodyB)
+		return contact->bodyB < bodyB ? -1 : 1;
+	if (contact->feature != feature)
+		return contact->feature < feature ? -1 : 1;
+	return 0;
+}
+
+/* qsort comparison of contacts in the order they are added */
+static int CompareContacts(const void *a, const void *b)
+{
+	const Contact *other = (const Contact*)b;
+	return ContactCompare((Contact*)a, other->bodyA, other->bodyB, other->feature);
+}
+
+/* effective mass of a body at a point in a direction, 0 for the floor */
+static float InverseMass(Rigidbody *rb, Vector3 offset, Vector3 direction)
+{
+	if (rb == NULL)
+		return 0;
+
+	return 1.0f / rb->mass + Vec3Dot(Vec3Cross(M3TransformVector(rb->inverseWorldInertiaTensor, Vec3Cross(offset, direction)), offset), direction);
+}
+
+/* applies equal and opposite impulses to the bodies of a contact */
+static void ApplyImpulse(Contact *contact, Rigidbody *a, Rigidbody *b, Vector3 impulse)
+{
+	RBApplyImpulse(a, impulse, contact->offsetA);
+	if (b != NULL)
+		RBApplyImpulse(b, Vec3Mult(impulse, -1), contact->offsetB);
+}
+
+/* velocity of the first body relative to the second at a contact */
+static Vector3 RelativeVelocity(Contact *contact, Rigidbody *a, Rigidbody *b)
+{
+	Vector3 velocity = RBPointVelocity(a, contact->offsetA);
+
+	if (b != NULL)
+		velocity = Vec3Sub(velocity, RBPointVelocity(b, contact->offsetB));
+
+	return velocity;
+}
+
+/* gap within which a point is a contact - the margin, plus how far the point closes on the
+   other body (or the floor) this step so fast bodies are caught before they pass into it */
+static float ContactMargin(Rigidbody *a, Rigidbody *b, Vector3 point, Vector3 normal, ContactParams *params, float deltaTime)
+{
+	Vector3 velocity = RBPointVelocity(a, Vec3Sub(point, a->position));
+
+	if (b != NULL)
+		velocity = Vec3Sub(velocity, RBPointVelocity(b, Vec3Sub(point, b->position)));
+
+	return params->margin + deltaTime * fmaxf(-Vec3Dot(velocity, normal), 0);
+}
+
+void ContactParamsInit(ContactParams *params)
+{
+	params->margin = CONTACT_MARGIN;
+	params->friction = CONTACT_FRICTION;
+	params->penetrationSlop = PENETRATION_SLOP;
+	params->penetrationCorrection = PENETRATION_CORRECTION;
+	params->bounceThreshold = BOUNCE_THRESHOLD;
+}
+
+void ContactCacheReset(ContactCache *cache)
+{
+	cache->numContacts = 0;
+	cache->numPrevious = 0;
+	cache->match = 0;
+}
+
+void ContactCacheRemoveBody(ContactCache *cache, int removed, int last)
+{
+	Contact *contact;
+	int i, numKept = 0;
+
+	for (i = 0; i < cache->numContacts; i++)
+	{
+		contact = &cache->contacts[i];
+		if (contact->bodyA == removed || contact->bodyB == removed || (contact->bodyB == last && contact->bodyA > removed))
+			continue;
+
+		if (contact->bodyA == last)
+			contact->bodyA = removed;
+		else if (contact->bodyB == last)
+			contact->bodyB = removed;
+		cache->contacts[numKept++] = *contact;
+	}
+	cache->numContacts = numKept;
+
+	/* the moved body's contacts go back where ContactAdd expects them */
+	qsort(cache->contacts, cache->numContacts, sizeof(Contact), CompareContacts);
+	cache->numPrevious = 0;
+	cache->match = 0;
+}
+
+void ContactBegin(ContactCache *cache)
+{
+	memcpy(cache->previous, cache->contacts, cache->numContacts * sizeof(Contact));
+	cache->numPrevious = cache->numContacts;
+	cache->numContacts = 0;
+	cache->match = 0;
+}
+
+unsigned ContactFeature(unsigned type, unsigned vertex, unsigned face)
+{
+	return (type << 16) | (vertex << 8) | face;
+}
+
+bool ContactAdd(ContactCache *cache, int bodyA, int bodyB, unsigned feature, Vector3 point, Vector3 normal, float separation)
+{
+	Contact *contact;
+	int order = 1;
+
+	if (cache->numContacts == MAX_CONTACTS)
+		return false;
+
+	contact = &cache->contacts[cache->numContacts++];
+	contact->bodyA = bodyA;
+	contact->bodyB = bodyB;
+	contact->feature = feature;
+	contact->point = point;
+	contact->normal = normal;
+	contact->separation = separation;
+	contact->normalImpulse = 0;
+	contact->tangentImpulse[0] = contact->tangentImpulse[1] = 0;
+
+	/* both lists are in the same order, so the match is found by walking forward */
+	while (cache->match < cache->numPrevious && (order = ContactCompare(&cache->previous[cache->match], bodyA, bodyB, feature)) < 0)
+		cache->match++;
+
+	if (cache->match < cache->numPrevious && order == 0)
+	{
+		contact->normalImpulse = cache->previous[cache->match].normalImpulse;
+		contact->tangentImpulse[0] = cache->previous[cache->match].tangentImpulse[0];
+		contact->tangentImpulse[1] = cache->previous[cache->match].tangentImpulse[1];
+		cache->warmStarted++;
+	}
+	cache->found++;
+
+	return true;
+}
+
+/* how far a mesh contact's normal may point into the solid side - a die resting on top of a wall
+   is pushed straight up, across the wall's normal */
+static const float MESH_BACKFACE = 0.1f;
+
+/* feature ID of a mesh contact - a vertex of the body (type 0), or a corner (0-2) or point on an
+   edge (3-8) of the triangle (type 1) */
+static unsigned MeshFeature(int triangle, unsigned type, unsigned vertex)
+{
+	return ((unsigned)triangle << 8) | (type << 7) | vertex;
+}
+
+/* true if a point's projection onto a triangle's plane is inside the triangle */
+static bool InsideTriangle(StaticTriangle *triangle, Vector3 point)
+{
+	int i;
+
+	for (i = 0; i < 3; i++)
+	{
+		if (Vec3Dot(Vec3Cross(Vec3Sub(triangle->vertices[(i + 1) % 3], triangle->vertices[i]), Vec3Sub(point, triangle->vertices[i])), triangle->normal) < 0)
+			return false;
+	}
+
+	return true;
+}
+
+/* distance from a point to the nearest point of a line segment */
+static float SegmentPointDistance(Vector3 start, Vector3 end, Vector3 point)
+{
+	Vector3 direction = Vec3Sub(end, start);
+	float t = Vec3Dot(Vec3Sub(point, start), direction) / Vec3Dot(direction, direction);
+
+	t = fmaxf(0, fminf(t, 1));
+	return Vec3Magnitude(Vec3Sub(point, Vec3Add(start, Vec3Mult(direction, t))));
+}
+
+void ContactFindMesh(ContactCache *cache, Rigidbody *rb, int index, StaticMesh *mesh, ContactParams *params, float deltaTime)
+{
+	int triangles[MAX_CONTACT_TRIANGLES], corners[MAX_CONTACT_TRIANGLES * 3];
+	StaticTriangle *triangle;
+	Vector3 normal, extend, start, end, point;
+	float reach, distance, fraction, first = 0;
+	int numTriangles, numCorners = 0, face, t, k;
+	unsigned i;
+
+	/* bounds of the rigidbody, grown by as far as it can move this step */
+	reach = params->margin + deltaTime * (Vec3Magnitude(rb->velocity) + Vec3Magnitude(rb->angularVelocity) * rb->outsideRadius);
+	extend = Vec3New(reach, reach, reach);
+	numTriangles = StaticMeshQuery(mesh, Vec3Sub(rb->boundsMin, extend), Vec3Add(rb->boundsMax, extend), triangles, MAX_CONTACT_TRIANGLES);
+	for (t = 0; t < numTriangles; t++)
+	{
+		triangle = &mesh->triangles[triangles[t]];
+
+		/* vertices of the rigidbody over the triangle - a vertex deep behind it has come
+		   through from the other side, or belongs to another triangle */
+		for (i = 0; i < rb->numVerts; i++)
+		{
+			distance = Vec3Dot(Vec3Sub(rb->vertices[i], triangle->vertices[0]), triangle->normal);
+			if (distance < reach && distance > -rb->insideRadius && distance < ContactMargin(rb, NULL, rb->vertices[i], triangle->normal, params, deltaTime) &&
+				InsideTriangle(triangle, rb->vertices[i]))
+				ContactAdd(cache, index, CONTACT_STATIC, MeshFeature(triangles[t], 0, i), rb->vertices[i], triangle->normal, distance);
+		}
+
+		/* corners of the triangle near faces of the rigidbody - a corner shared with an earlier
+		   triangle has been tested already */
+		for (i = 0; i < 3; i++)
+		{
+			for (k = 0; k < numCorners && corners[k] != triangle->indices[i]; k++)
+				;
+			if (k < numCorners)
+				continue;
+			corners[numCorners++] = triangle->indices[i];
+
+			if (Vec3Magnitude(Vec3Sub(triangle->vertices[i], rb->position)) > rb->outsideRadius + reach)
+				continue;
+
+			distance = RBPointDistance(rb, triangle->vertices[i], Vec3Mult(triangle->normal, -1), &face);
+			normal = Vec3Mult(M3TransformVector(rb->orientation, rb->bodyNormals[face]), -1);
+			if (distance < ContactMargin(rb, NULL, triangle->vertices[i], normal, params, deltaTime) && Vec3Dot(normal, triangle->normal) > -MESH_BACKFACE)
+				ContactAdd(cache, index, CONTACT_STATIC, MeshFeature(triangles[t], 1, i), triangle->vertices[i], normal, distance);
+		}
+
+		/* sharp edges across faces of the rigidbody - the point of the edge deepest in it, and
+		   where an edge lies along a face, both ends of where it does. Corners are done above */
+		for (i = 0; i < 3; i++)
+		{
+			if (!(triangle->sharpEdges & (1u << i)))
+				continue;
+
+			start = triangle->vertices[i];
+			end = triangle->vertices[(i + 1) % 3];
+			if (SegmentPointDistance(start, end, rb->position) > rb->outsideRadius + reach)
+				continue;
+
+			for (k = 0; k < 2; k++)
+			{
+				distance = RBSegmentDistance(rb, k == 0 ? start : end, k == 0 ? end : start, &fraction, &face);
+				if (k == 1)
+				{
+					fraction = 1 - fraction;
+					if (fraction - first < 0.01f)
+						continue;
+				}
+				else
+					first = fraction;
+
+				if (fraction <= 0 || fraction >= 1)
+					continue;
+
+				point = Vec3Add(start, Vec3Mult(Vec3Sub(end, start), fraction));
+				normal = Vec3Mult(M3TransformVector(rb->orientation, rb->bodyNormals[face]), -1);
+				if (distance < ContactMargin(rb, NULL, point, normal, params, deltaTime) && Vec3Dot(normal, triangle->normal) > -MESH_BACKFACE)
+					ContactAdd(cache, index, CONTACT_STATIC, MeshFeature(triangles[t], 1, 3 + i * 2 + k), point, normal, distance);
+			}
+		}
+	}
+}
+
+void ContactFindFloor(ContactCache *cache, Rigidbody *rb, int index, ContactParams *params, float deltaTime)
+{
+	Vector3 floorNormal = Vec3New(0, 1, 0);
+	float reach;
+	unsigned i;
+
+	/* furthest any vertex can fall this step - skip bodies that can't reach the floor */
+	reach = params->margin + deltaTime * (fmaxf(-rb->velocity.y, 0) + Vec3Magnitude(rb->angularVelocity) * rb->outsideRadius);
+	if (rb->boundsMin.y > reach)
+		return;
+
+	/* floor is at y = 0, so a vertex's height is its separation */
+	for (i = 0; i < rb->numVerts; i++)
+	{
+		if (rb->vertices[i].y < ContactMargin(rb, NULL, rb->vertices[i], floorNormal, params, deltaTime))
+			ContactAdd(cache, index, CONTACT_FLOOR, ContactFeature(0, i, 0), rb->vertices[i], floorNormal, rb->vertices[i].y);
+	}
+}
+
+void ContactFindBodies(ContactCache *cache, Rigidbody *a, int indexA, Rigidbody *b, int indexB, GJKCache *gjk, ContactParams *params, float deltaTime)
+{
+	GJKResult result;
+	Vector3 normal;
+	float distance, reach, deepest = FLT_MAX;
+	int face, vertexA = 0, vertexB = 0;
+	bool found = false;
+	unsigned i;
+
+	/* furthest the bodies can close on each other this step */
+	reach = params->margin + deltaTime * (Vec3Magnitude(Vec3Sub(a->velocity, b->velocity))
+		+ Vec3Magnitude(a->angularVelocity) * a->outsideRadius + Vec3Magnitude(b->angularVelocity) * b->outsideRadius);
+
+	if (!RBBoundsOverlap(a, b, reach))
+		return;
+
+	cache->pairsTested++;
+	GJKQuery(a, b, gjk, &result);
+	if (result.distance > reach)
+		return;
+
+	/* vertices of a near faces of b - normal is b's face, preferring the one facing a */
+	for (i = 0; i < a->numVerts; i++)
+	{
+		distance = RBPointDistance(b, a->vertices[i], Vec3Mult(result.normal, -1), &face);
+		deepest = fminf(deepest, distance);
+		normal = M3TransformVector(b->orientation, b->bodyNormals[face]);
+		if (distance < ContactMargin(a, b, a->vertices[i], normal, params, deltaTime))
+			found |= ContactAdd(cache, indexA, indexB, ContactFeature(0, i, face), a->vertices[i], normal, distance);
+	}
+
+	/* vertices of b near faces of a - normal is a's face, reversed */
+	for (i = 0; i < b->numVerts; i++)
+	{
+		distance = RBPointDistance(a, b->vertices[i], result.normal, &face);
+		deepest = fminf(deepest, distance);
+		normal = Vec3Mult(M3TransformVector(a->orientation, a->bodyNormals[face]), -1);
+		if (distance < ContactMargin(a, b, b->vertices[i], normal, params, deltaTime))
+			found |= ContactAdd(cache, indexA, indexB, ContactFeature(1, i, face), b->vertices[i], normal, distance);
+	}
+
+	/* edge against edge, which no vertex sees (or sees less deeply) - use the closest points
+	   from GJK, named by the vertex of each body nearest the other */
+	normal = Vec3Mult(result.normal, -1);
+	if (result.distance < ContactMargin(a, b, result.pointA, normal, params, deltaTime) && (!found || result.distance < deepest - params->penetrationSlop))
+	{
+		RBSupport(a, result.normal, &vertexA);
+		RBSupport(b, normal, &vertexB);
+		ContactAdd(cache, indexA, indexB, ContactFeature(2, vertexA, vertexB), Vec3Mult(Vec3Add(result.pointA, result.pointB), 0.5f),
+			normal, result.distance);
+	}
+}
+
+void ContactPrepare(ContactCache *cache, Rigidbody *bodies, ContactParams *params, float deltaTime)
+{
+	Contact *contact;
+	Rigidbody *a, *b;
+	Vector3 normal, impulse;
+	float normalVelocity, restitution;
+	int i, j;
+
+	for (i = 0; i < cache->numContacts; i++)
+	{
+		contact = &cache->contacts[i];
+		a = &bodies[contact->bodyA];
+		b = contact->bodyB < 0 ? NULL : &bodies[contact->bodyB];
+		normal = contact->normal;
+
+		contact->offsetA = Vec3Sub(contact->point, a->position);
+		contact->offsetB = b != NULL ? Vec3Sub(contact->point, b->position) : Vec3New(0, 0, 0);
+
+		/* any two directions across the normal */
+		if (fabsf(normal.x) >= 0.57735f)
+			contact->tangents[0] = Vec3Normalize(Vec3New(normal.y, -normal.x, 0));
+		else
+			contact->tangents[0] = Vec3Normalize(Vec3New(0, normal.z, -normal.y));
+		contact->tangents[1] = Vec3Cross(normal, contact->tangents[0]);
+
+		contact->normalMass = 1.0f / (InverseMass(a, contact->offsetA, normal) + InverseMass(b, contact->offsetB, normal));
+		for (j = 0; j < 2; j++)
+			contact->tangentMass[j] = 1.0f / (InverseMass(a, contact->offsetA, contact->tangents[j]) + InverseMass(b, contact->offsetB, contact->tangents[j]));
+
+		/* a gap may close this step but no more (speculative), penetration is pushed out a
+		   little at a time */
+		if (contact->separation > 0)
+			contact->bias = -contact->separation / deltaTime;
+		else
+			contact->bias = params->penetrationCorrection / deltaTime * fmaxf(-contact->separation - params->penetrationSlop, 0);
+
+		/* bounce off hard impacts that happen this step - resting contacts don't bounce, or
+		   stacks would jitter, and gaps that won't close yet shouldn't bounce off thin air */
+		normalVelocity = Vec3Dot(RelativeVelocity(contact, a, b), normal);
+		restitution = b != NULL ? fminf(a->coefficientOfRestitution, b->coefficientOfRestitution) : a->coefficientOfRestitution;
+		if (normalVelocity < -params->bounceThreshold && contact->separation + normalVelocity * deltaTime < 0)
+			contact->bias = fmaxf(contact->bias, -restitution * normalVelocity);
+
+		/* warm start - apply what the contact needed last step */
+		impulse = Vec3Add(Vec3Mult(normal, contact->normalImpulse),
+			Vec3Add(Vec3Mult(contact->tangents[0], contact->tangentImpulse[0]), Vec3Mult(contact->tangents[1], contact->tangentImpulse[1])));
+		ApplyImpulse(contact, a, b, impulse);
+	}
+}
+
+void ContactSolve(ContactCache *cache, Rigidbody *bodies, ContactParams *params, bool backwards)
+{
+	Contact *contact;
+	Rigidbody *a, *b;
+	Vector3 velocity;
+	float lambda, total, limit;
+	int i, j;
+
+	for (i = 0; i < cache->numContacts; i++)
+	{
+		contact = &cache->contacts[backwards ? cache->numContacts - 1 - i : i];
+		a = &bodies[contact->bodyA];
+		b = contact->bodyB < 0 ? NULL : &bodies[contact->bodyB];
+
+		/* friction - limited by the normal impulse */
+		limit = params->friction * contact->normalImpulse;
+		for (j = 0; j < 2; j++)
+		{
+			velocity = RelativeVelocity(contact, a, b);
+			lambda = -Vec3Dot(velocity, contact->tangents[j]) * contact->tangentMass[j];
+			total = fmaxf(-limit, fminf(contact->tangentImpulse[j] + lambda, limit));
+			lambda = total - contact->tangentImpulse[j];
+			contact->tangentImpulse[j] = total;
+			ApplyImpulse(contact, a, b, Vec3Mult(contact->tangents[j], lambda));
+		}
+
+		/* normal - push apart only */
+		velocity = RelativeVelocity(contact, a, b);
+		lambda = (contact->bias - Vec3Dot(velocity, contact->normal)) * contact->normalMass;
+		total = fmaxf(contact->normalImpulse + lambda, 0);
+		lambda = total - contact->normalImpulse;
+		contact->normalImpulse = total;
+		ApplyImpulse(contact, a, b, Vec3Mult(contact->normal, lambda));
+	}
+}
@@ -0,0 +1,241 @@
+/**
+ * @file	Contact.h
+ * @brief	Contacts between rigidbodys and the floor, kept between steps and solved with impulses.
+ */
+
+#ifndef CONTACT_H
+#define CONTACT_H
+
+#include "Rigidbody.h"
+#include "GJK.h"
+#include "StaticMesh.h"
+#include "Vector3.h"
+#include "Boolean.h"
+
+extern const float CONTACT_MARGIN;
+extern const float CONTACT_FRICTION;
+extern const float PENETRATION_SLOP;
+extern const float PENETRATION_CORRECTION;
+extern const float BOUNCE_THRESHOLD;
+
+/**
+ * @brief	How contacts are found and solved, which can be set per scene.
+ * @details	ContactParamsInit fills in the defaults above.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct ContactParams
+{
+	float margin;					/* gap within which points are contacts */
+	float friction;					/* friction impulse allowed per unit of normal impulse */
+	float penetrationSlop;			/* penetration left alone, so resting contacts persist */
+	float penetrationCorrection;	/* fraction of the rest pushed out each step */
+	float bounceThreshold;			/* closing speed below which contacts don't bounce */
+};
+typedef struct ContactParams ContactParams;
+
+/**
+ * @brief	Maximum number of contacts in a scene, and the body indices used for the floor and
+ * 			the static mesh.
+ */
+enum { MAX_CONTACTS = 512, CONTACT_FLOOR = -1, CONTACT_STATIC = -2 };
+
+/**
+ * @brief	Maximum number of static mesh triangles tested against one rigidbody.
+ */
+enum { MAX_CONTACT_TRIANGLES = 256 };
+
+/**
+ * @brief	A point where two bodies, or a body and the floor, touch.
+ * @details	The feature says which vertex of one body touches which face of the other, so the
+ * 			same contact can be found again next step and start from the impulses it ended with.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct Contact
+{
+	int bodyA;						/* index of the first body */
+	int bodyB;						/* index of the second body, CONTACT_FLOOR or CONTACT_STATIC */
+	unsigned feature;				/* touching vertex and face - see ContactFeature */
+	Vector3 point;					/* world position */
+	Vector3 normal;					/* unit normal from the second body towards the first */
+	float separation;				/* gap along the normal, negative if penetrating */
+
+	float normalImpulse;			/* accumulated while solving, kept for the next step */
+	float tangentImpulse[2];		/* accumulated friction, kept for the next step */
+
+	/* calculated by ContactPrepare */
+	Vector3 offsetA, offsetB;		/* point relative to each body */
+	Vector3 tangents[2];
+	float normalMass, tangentMass[2];
+	float bias;						/* normal velocity the solver aims for */
+};
+typedef struct Contact Contact;
+
+/**
+ * @brief	The contacts of a scene, kept from one step to the next.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct ContactCache
+{
+	Contact contacts[MAX_CONTACTS];
+	int numContacts;
+
+	Contact previous[MAX_CONTACTS];	/* last step's contacts, matched by ContactAdd */
+	int numPrevious;
+	int match;						/* next previous contact to match against */
+
+	unsigned long pairsTested;		/* pairs of rigidbodys run through GJK, for reporting */
+	unsigned long found;			/* contacts found, for reporting */
+	unsigned long warmStarted;		/* contacts that matched one from the last step */
+};
+typedef struct ContactCache ContactCache;
+
+/**
+ * @brief	Fills in the defaults.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	params	The params.
+ */
+void ContactParamsInit(ContactParams *params);
+
+/**
+ * @brief	Forgets every contact.
+ * @details	Call when bodies are replaced, as contacts refer to bodies by index.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache	The cache.
+ */
+void ContactCacheReset(ContactCache *cache);
+
+/**
+ * @brief	Renumbers the contacts when the last body takes the index of a removed one.
+ * @details	Contacts of the removed body are dropped and the moved body's keep their impulses,
+ * 			except those with a body it now comes before, whose features name the two bodies the
+ * 			other way round.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache  	The cache.
+ * @param 	removed	Index of the removed body.
+ * @param 	last   	Index of the body that takes its place - the last body before removal.
+ */
+void ContactCacheRemoveBody(ContactCache *cache, int removed, int last);
+
+/**
+ * @brief	Starts collecting the contacts of a new step.
+ * @details	Contacts must then be added in order of first body, second body (static mesh then
+ * 			floor first), then feature. ContactFindMesh, ContactFindFloor and ContactFindBodies
+ * 			add them in that order.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache	The cache.
+ */
+void ContactBegin(ContactCache *cache);
+
+/**
+ * @brief	Builds a feature ID.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	type  	0 for a vertex of the first body, 1 for a vertex of the second, 2 for edges.
+ * @param 	vertex	The vertex (or first body's edge vertex).
+ * @param 	face  	The face of the other body (or second body's edge vertex).
+ * @return	The feature ID.
+ */
+unsigned ContactFeature(unsigned type, unsigned vertex, unsigned face);
+
+/**
+ * @brief	Adds a contact, carrying over its impulses if it was there last step.
+ * @details	Used internally by ContactFindFloor and ContactFindBodies.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache	  	The cache.
+ * @param 	bodyA	  	Index of the first body.
+ * @param 	bodyB	  	Index of the second body, CONTACT_FLOOR or CONTACT_STATIC.
+ * @param 	feature   	The feature ID.
+ * @param 	point	  	The world position.
+ * @param 	normal	  	Unit normal from the second body towards the first.
+ * @param 	separation	Gap along the normal, negative if penetrating.
+ * @return	false if the cache is full.
+ */
+bool ContactAdd(ContactCache *cache, int bodyA, int bodyB, unsigned feature, Vector3 point, Vector3 normal, float separation);
+
+/**
+ * @brief	Adds contacts between a rigidbody and a static mesh.
+ * @details	The mesh's BVH finds the triangles near the rigidbody. Each vertex of the rigidbody
+ * 			near the solid side of a triangle is a contact, as is each triangle corner near a
+ * 			face of the rigidbody. Edges crossing edges (eg. a die's edge across the top of a
+ * 			wall) are not found.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache	 	The cache.
+ * @param 	rb   	 	The rigidbody. Vertices and velocities must be calculated.
+ * @param 	index	 	Index of the rigidbody.
+ * @param 	mesh 	 	The mesh.
+ * @param 	params	 	The margin.
+ * @param 	deltaTime	The step.
+ */
+void ContactFindMesh(ContactCache *cache, Rigidbody *rb, int index, StaticMesh *mesh, ContactParams *params, float deltaTime);
+
+/**
+ * @brief	Adds a contact for each vertex of a rigidbody near the floor.
+ * @details	Near is within the margin plus however far the vertex will fall this step. The
+ * 			solver lets such a speculative contact close its gap but no more, so a fast body
+ * 			stops at the floor rather than passing into it.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache	 	The cache.
+ * @param 	rb   	 	The rigidbody. Vertices and velocities must be calculated.
+ * @param 	index	 	Index of the rigidbody.
+ * @param 	params	 	The margin.
+ * @param 	deltaTime	The step.
+ */
+void ContactFindFloor(ContactCache *cache, Rigidbody *rb, int index, ContactParams *params, float deltaTime);
+
+/**
+ * @brief	Adds contacts between two rigidbodys.
+ * @details	Bodies whose bounds are too far apart to meet this step are rejected without running
+ * 			GJK, and GJK rejects the rest that can't. Otherwise each vertex of either
+ * 			body near a face of the other is a contact, as with ContactFindFloor, and if there
+ * 			are none (edge against edge) the closest points from GJK are used.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache 	 	The cache.
+ * @param 	a     	 	The first rigidbody. Vertices and velocities must be calculated.
+ * @param 	indexA	 	Index of the first rigidbody.
+ * @param 	b     	 	The second rigidbody. Vertices and velocities must be calculated.
+ * @param 	indexB	 	Index of the second rigidbody.
+ * @param 	gjk   	 	GJK state kept for this pair, or NULL.
+ * @param 	params	 	The margin and slop.
+ * @param 	deltaTime	The step.
+ */
+void ContactFindBodies(ContactCache *cache, Rigidbody *a, int indexA, Rigidbody *b, int indexB, GJKCache *gjk, ContactParams *params, float deltaTime);
+
+/**
+ * @brief	Prepares contacts for solving and applies the impulses carried over from last step.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache	 	The cache.
+ * @param 	bodies	 	The rigidbodys the contacts index.
+ * @param 	params	 	The penetration correction and bounce threshold.
+ * @param 	deltaTime	The step.
+ */
+void ContactPrepare(ContactCache *cache, Rigidbody *bodies, ContactParams *params, float deltaTime);
+
+/**
+ * @brief	Runs one iteration of the impulse solver over every contact.
+ * @details	Accumulated impulses are clamped rather than each correction, so an iteration can
+ * 			take back what an earlier one (or the last step) applied too much of. Contacts are
+ * 			solved one after another, so the first to be solved takes more than its share -
+ * 			alternate the direction between iterations so that evens out rather than twisting
+ * 			bodies, eg. a box resting on four corners.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache 	 	The cache.
+ * @param 	bodies	 	The rigidbodys the contacts index.
+ * @param 	params	 	The friction.
+ * @param 	backwards	Solve the contacts in reverse order.
+ */
+void ContactSolve(ContactCache *cache, Rigidbody *bodies, ContactParams *params, bool backwards);
+
+#endif
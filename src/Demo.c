@@ -0,0 +1,101 @@
+
+#include "Demo.h"
+#include "MathUtils.h"
+#include <string.h>
+
+void DemoInit(Demo *demo, unsigned seed, ShapeType shape)
+{
+	/* init camera */
+	demo->camera.position = Vec3New(10, 3, 0);
+	demo->camera.focus = Vec3New(0, 0, 0);
+	demo->camera.speed = 80;
+	demo->camera.orbitAngle = 0;
+	demo->camera.orbitRadius = 10;
+	demo->camera.minY = 3;
+	demo->camera.maxY = 10;
+
+	/* init light */
+	demo->light.enabled = true;
+	demo->light.type = DIRECTIONAL_LIGHT;
+	demo->light.position = Vec3New(1, 1, 0);
+	demo->light.ambient = ColourNew(0.5f, 0.5f, 0.5f, 1);
+	demo->light.diffuse = ColourNew(1, 1, 1, 1);
+	demo->light.specular = ColourNew(1, 1, 1, 1);
+
+	/* no actions in progress */
+	memset(&demo->input, 0, sizeof(demo->input));
+
+	/* init objects */
+	SceneInit(&demo->scene, seed);
+	demo->numObjectsCreate = 8;
+	demo->shapeCreate = shape;
+	DemoCreateRigidbodys(demo);
+}
+
+void DemoUpdate(Demo *demo, float deltaTime)
+{
+	/* reset objects, increase/decrease quantity */
+	DemoHandleInput(demo);
+
+	SceneUpdate(&demo->scene, deltaTime);
+
+	/* camera movement */
+	CameraUpdate(&demo->camera, &demo->input, deltaTime);
+}
+
+void DemoHandleInput(Demo *demo)
+{
+	int presses;
+
+	/* create new rigidbodys */
+	if (ActionPresses(&demo->input, ACTION_CREATE) > 0)
+		DemoCreateRigidbodys(demo);
+
+	/* increase number of rigidbodys */
+	presses = ActionPresses(&demo->input, ACTION_MORE_OBJECTS);
+	demo->numObjectsCreate += presses;
+	if (demo->numObjectsCreate > MAX_OBJECTS)
+		demo->numObjectsCreate = MAX_OBJECTS;
+
+	/* decrease number of rigidbodys */
+	presses = ActionPresses(&demo->input, ACTION_FEWER_OBJECTS);
+	demo->numObjectsCreate -= presses;
+	if (demo->numObjectsCreate < 1)
+		demo->numObjectsCreate = 1;
+
+	/* change shape of created rigidbodys */
+	presses = ActionPresses(&demo->input, ACTION_NEXT_SHAPE);
+	demo->shapeCreate = (ShapeType)((demo->shapeCreate + presses) % NUM_SHAPES);
+}
+
+void DemoCreateRigidbodys(Demo *demo)
+{
+	RigidbodyState states[MAX_OBJECTS];
+	float size;
+	Vector3 rotation;
+	int i;
+
+	/* random initialization of rigidbodys - each value is drawn in its own statement because
+	   the order function arguments are evaluated in differs between compilers */
+	memset(states, 0, sizeof(states));
+	for (i = 0; i < demo->numObjectsCreate; i++)
+	{
+		size = GetRandomFloat(&demo->scene.random, 0.5f, 1);
+		states[i].position.x = GetRandomFloat(&demo->scene.random, -1.2f, 1.2f);
+		states[i].position.y = GetRandomFloat(&demo->scene.random, 5, 20);
+		states[i].position.z = GetRandomFloat(&demo->scene.random, -1, 1);
+		rotation.x = GetRandomFloat(&demo->scene.random, 0, 90);
+		rotation.y = GetRandomFloat(&demo->scene.random, 0, 90);
+		rotation.z = GetRandomFloat(&demo->scene.random, 0, 90);
+
+		/* dropped from rest */
+		states[i].shape = demo->shapeCreate;
+		states[i].density = 3;
+		states[i].dimensions = Vec3New(size, size, size);
+		states[i].orientation = M3FromEuler(rotation);
+	}
+
+	demo->scene.numObjects = 0;
+	SceneResetContacts(&demo->scene);
+	SceneSpawnRigidbodys(&demo->scene, states, demo->numObjectsCreate);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file	Demo.h
+ * @brief	The interactive demo: a physics scene with a camera, light and keyboard actions.
+ */
+
+#ifndef DEMO_H
+#define DEMO_H
+
+#include "Scene.h"
+#include "Camera.h"
+#include "Light.h"
+#include "KeyInput.h"
+#include "Shape.h"
+
+/**
+ * @brief	Everything the demo draws and controls.
+ * @details	The scene is only the simulation - anything to do with viewing or input lives here.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct Demo
+{
+	Scene scene;
+
+	Camera camera;
+	Light light;
+
+	InputState input;			/* actions of the current frame, fed from an InputQueue before each update */
+	int numObjectsCreate;		/* number of objects created by ACTION_CREATE */
+	ShapeType shapeCreate;		/* shape of objects created, changed by ACTION_NEXT_SHAPE */
+};
+typedef struct Demo Demo;
+
+/**
+ * @brief	Initializes the demo and drops its first objects.
+ * @details	The scene has no static mesh; set demo->scene.staticMesh after.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param	demo	The demo.
+ * @param	seed	Seed of the scene's random generator, which places every object dropped.
+ * @param	shape	Shape of the objects dropped.
+ */
+void DemoInit(Demo *demo, unsigned seed, ShapeType shape);
+
+/**
+ * @brief	Acts on input, steps the scene and moves the camera.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	demo		The demo.
+ * @param	deltaTime	Time elapsed since last update.
+ */
+void DemoUpdate(Demo *demo, float deltaTime);
+
+/**
+ * @brief	Handle user input.
+ * @details	Acts on the actions started this frame in demo->input.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	demo	The demo.
+ */
+void DemoHandleInput(Demo *demo);
+
+/**
+ * @brief	Replaces the scene's objects with numObjectsCreate randomly placed ones.
+ * @details	Uses the scene's random generator, so a seed gives the same drops every run.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param 	demo	The demo.
+ */
+void DemoCreateRigidbodys(Demo *demo);
+
+#endif
@@ -0,0 +1,59 @@
+
+#include "FramePacer.h"
+#include <math.h>
+#include <time.h>
+
+double FramePacerTime()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+void FramePacerInit(FramePacer *pacer, int fps)
+{
+	pacer->period = 1000.0 / fps;
+	pacer->deadline = FramePacerTime();
+	pacer->frameStart = pacer->deadline;
+	FramePacerResetStats(pacer);
+}
+
+void FramePacerBeginFrame(FramePacer *pacer)
+{
+	double now = FramePacerTime();
+
+	if (pacer->frames > 0 && now - pacer->frameStart > pacer->maxInterval)
+		pacer->maxInterval = now - pacer->frameStart;
+	pacer->frameStart = now;
+}
+
+int FramePacerEndFrame(FramePacer *pacer)
+{
+	double now = FramePacerTime();
+	double frameTime = now - pacer->frameStart;
+
+	pacer->frames++;
+	pacer->totalFrameTime += frameTime;
+	if (frameTime > pacer->maxFrameTime)
+		pacer->maxFrameTime = frameTime;
+
+	/* due a fixed period after the last deadline, not after this frame */
+	pacer->deadline += pacer->period;
+	if (now <= pacer->deadline)
+		return (int)ceil(pacer->deadline - now);
+
+	pacer->lateFrames++;
+	if (now - pacer->deadline > pacer->period)
+		pacer->deadline = now;
+	return 0;
+}
+
+void FramePacerResetStats(FramePacer *pacer)
+{
+	pacer->statsStart = FramePacerTime();
+	pacer->frames = 0;
+	pacer->lateFrames = 0;
+	pacer->totalFrameTime = 0;
+	pacer->maxFrameTime = 0;
+	pacer->maxInterval = 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file	FramePacer.h
+ * @brief	Schedules frames against a fixed rate of deadlines and measures how long they take.
+ */
+
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+/**
+ * @brief	Frame deadlines and timing statistics.
+ * @details	Deadlines are a fixed period apart, so the time a frame takes doesn't push later
+ * 			frames back. Times are in milliseconds from FramePacerTime.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct FramePacer
+{
+	double period;					/* time between frames */
+	double deadline;				/* when the next frame is due */
+	double frameStart;				/* when the current frame started */
+
+	/* since the last FramePacerResetStats */
+	double statsStart;
+	int frames;
+	int lateFrames;					/* frames that finished after the next one was due */
+	double totalFrameTime;			/* time spent in frames */
+	double maxFrameTime;
+	double maxInterval;				/* longest time from one frame's start to the next */
+};
+typedef struct FramePacer FramePacer;
+
+/**
+ * @brief	Gets the time from a monotonic clock.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @return	Milliseconds from an arbitrary fixed point.
+ */
+double FramePacerTime();
+
+/**
+ * @brief	Initializes a frame pacer with the first frame due now.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	pacer	The pacer.
+ * @param 	fps  	Frames per second.
+ */
+void FramePacerInit(FramePacer *pacer, int fps);
+
+/**
+ * @brief	Marks the start of a frame.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	pacer	The pacer.
+ */
+void FramePacerBeginFrame(FramePacer *pacer);
+
+/**
+ * @brief	Marks the end of a frame and moves on to the next deadline.
+ * @details	If frames have fallen more than a period behind, the missed deadlines are dropped
+ * 			instead of running frames back to back to catch up.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	pacer	The pacer.
+ * @return	Milliseconds until the next frame is due, rounded up. 0 if it is already due.
+ */
+int FramePacerEndFrame(FramePacer *pacer);
+
+/**
+ * @brief	Starts collecting timing statistics again.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	pacer	The pacer.
+ */
+void FramePacerResetStats(FramePacer *pacer);
+
+#endif
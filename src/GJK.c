@@ -0,0 +1,563 @@
+#include "GJK.h"
+#include "Rigidbody.h"
+#include <stddef.h>
+
+enum { GJK_MAX_ITERATIONS = 32, EPA_MAX_ITERATIONS = 32, EPA_MAX_VERTS = 48, EPA_MAX_FACES = 96 };
+
+static const float GJK_TOLERANCE = 1e-5f;		/* relative convergence of the closest distance */
+static const float GJK_TOUCHING = 1e-4f;		/* closer than this counts as touching, left to EPA */
+static const float EPA_TOLERANCE = 1e-4f;		/* absolute convergence of the penetration depth */
+static const float EPA_VISIBLE = 1e-5f;			/* a face must be this far below a new point to be removed */
+static const float DEGENERATE = 1e-12f;
+
+/* a point of the Minkowski difference a - b and the vertices it came from */
+typedef struct
+{
+	Vector3 w, a, b;
+	int vertexA, vertexB;
+} SupportPoint;
+
+typedef struct
+{
+	int v[3];
+	Vector3 normal;
+	float distance;
+} EPAFace;
+
+static SupportPoint Support(Rigidbody *a, Rigidbody *b, Vector3 direction, int *hintA, int *hintB)
+{
+	SupportPoint p;
+
+	p.a = RBSupport(a, direction, hintA);
+	p.b = RBSupport(b, Vec3Mult(direction, -1), hintB);
+	p.w = Vec3Sub(p.a, p.b);
+	p.vertexA = *hintA;
+	p.vertexB = *hintB;
+
+	return p;
+}
+
+/* closest point to the origin on a segment, as weights of its ends */
+static void ClosestOnSegment(Vector3 a, Vector3 b, float weights[2])
+{
+	Vector3 ab = Vec3Sub(b, a);
+	float length = Vec3Dot(ab, ab);
+	float t = length > DEGENERATE ? -Vec3Dot(a, ab) / length : 0;
+
+	if (t < 0)
+		t = 0;
+	if (t > 1)
+		t = 1;
+
+	weights[0] = 1 - t;
+	weights[1] = t;
+}
+
+/* closest point to the origin on a triangle, as weights of its corners - by Voronoi regions */
+static void ClosestOnTriangle(Vector3 a, Vector3 b, Vector3 c, float weights[3])
+{
+	static const int edges[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+	Vector3 ab = Vec3Sub(b, a), ac = Vec3Sub(c, a);
+	float d1, d2, d3, d4, d5, d6, va, vb, vc, v, w, denom;
+	float edge[2];
+	Vector3 corners[3], p, best;
+	int i;
+
+	weights[0] = weights[1] = weights[2] = 0;
+
+	d1 = -Vec3Dot(ab, a);
+	d2 = -Vec3Dot(ac, a);
+	if (d1 <= 0 && d2 <= 0)
+	{
+		weights[0] = 1;
+		return;
+	}
+
+	d3 = -Vec3Dot(ab, b);
+	d4 = -Vec3Dot(ac, b);
+	if (d3 >= 0 && d4 <= d3)
+	{
+		weights[1] = 1;
+		return;
+	}
+
+	vc = d1 * d4 - d3 * d2;
+	if (vc <= 0 && d1 >= 0 && d3 <= 0)
+	{
+		v = d1 / (d1 - d3);
+		weights[0] = 1 - v;
+		weights[1] = v;
+		return;
+	}
+
+	d5 = -Vec3Dot(ab, c);
+	d6 = -Vec3Dot(ac, c);
+	if (d6 >= 0 && d5 <= d6)
+	{
+		weights[2] = 1;
+		return;
+	}
+
+	vb = d5 * d2 - d1 * d6;
+	if (vb <= 0 && d2 >= 0 && d6 <= 0)
+	{
+		w = d2 / (d2 - d6);
+		weights[0] = 1 - w;
+		weights[2] = w;
+		return;
+	}
+
+	va = d3 * d6 - d5 * d4;
+	if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+	{
+		w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+		weights[1] = 1 - w;
+		weights[2] = w;
+		return;
+	}
+
+	denom = va + vb + vc;
+	if (denom > DEGENERATE)
+	{
+		v = vb / denom;
+		w = vc / denom;
+		weights[0] = 1 - v - w;
+		weights[1] = v;
+		weights[2] = w;
+		return;
+	}
+
+	/* flat triangle - use the closest of its edges */
+	corners[0] = a;
+	corners[1] = b;
+	corners[2] = c;
+	for (i = 0; i < 3; i++)
+	{
+		ClosestOnSegment(corners[edges[i][0]], corners[edges[i][1]], edge);
+		p = Vec3Add(Vec3Mult(corners[edges[i][0]], edge[0]), Vec3Mult(corners[edges[i][1]], edge[1]));
+		if (i == 0 || Vec3Dot(p, p) < Vec3Dot(best, best))
+		{
+			best = p;
+			weights[0] = weights[1] = weights[2] = 0;
+			weights[edges[i][0]] = edge[0];
+			weights[edges[i][1]] = edge[1];
+		}
+	}
+}
+
+/* reduces the simplex to the smallest feature containing the point closest to the origin, which
+   is returned; returns false in closest if the origin is inside a tetrahedron */
+static bool ReduceSimplex(SupportPoint *simplex, int *numPoints, Vector3 *closest)
+{
+	static const int faces[4][4] = { { 0, 1, 2, 3 }, { 0, 1, 3, 2 }, { 0, 2, 3, 1 }, { 1, 2, 3, 0 } };
+	SupportPoint kept[4];
+	float weights[4] = { 1, 0, 0, 0 }, faceWeights[3], distance, bestDistance = -1;
+	int order[4] = { 0, 1, 2, 3 };
+	Vector3 normal, p;
+	int i, j, n;
+	bool outside;
+
+	if (*numPoints == 2)
+		ClosestOnSegment(simplex[0].w, simplex[1].w, weights);
+	else if (*numPoints == 3)
+		ClosestOnTriangle(simplex[0].w, simplex[1].w, simplex[2].w, weights);
+	else if (*numPoints == 4)
+	{
+		/* check each face the origin is in front of */
+		for (i = 0; i < 4; i++)
+		{
+			Vector3 a = simplex[faces[i][0]].w, b = simplex[faces[i][1]].w, c = simplex[faces[i][2]].w;
+			Vector3 d = simplex[faces[i][3]].w;
+			float side, opposite;
+
+			normal = Vec3Cross(Vec3Sub(b, a), Vec3Sub(c, a));
+			side = -Vec3Dot(normal, a);
+			opposite = Vec3Dot(normal, Vec3Sub(d, a));
+			outside = side * opposite < 0 || opposite * opposite <= DEGENERATE;
+			if (!outside)
+				continue;
+
+			ClosestOnTriangle(a, b, c, faceWeights);
+			p = Vec3Add(Vec3Add(Vec3Mult(a, faceWeights[0]), Vec3Mult(b, faceWeights[1])), Vec3Mult(c, faceWeights[2]));
+			distance = Vec3Dot(p, p);
+			if (bestDistance < 0 || distance < bestDistance)
+			{
+				bestDistance = distance;
+				for (j = 0; j < 3; j++)
+				{
+					order[j] = faces[i][j];
+					weights[j] = faceWeights[j];
+				}
+				order[3] = faces[i][3];
+				weights[3] = 0;
+			}
+		}
+
+		/* inside every face */
+		if (bestDistance < 0)
+		{
+			*closest = Vec3New(0, 0, 0);
+			return false;
+		}
+	}
+
+	/* keep the points that contribute */
+	n = 0;
+	*closest = Vec3New(0, 0, 0);
+	for (i = 0; i < *numPoints; i++)
+	{
+		if (weights[i] > 0)
+		{
+			kept[n] = simplex[order[i]];
+			*closest = Vec3Add(*closest, Vec3Mult(kept[n].w, weights[i]));
+			n++;
+		}
+	}
+
+	for (i = 0; i < n; i++)
+		simplex[i] = kept[i];
+	*numPoints = n;
+
+	return true;
+}
+
+/* closest points on each body for a point of the simplex, from the weights that give it */
+static void WitnessPoints(SupportPoint *points, int numPoints, Vector3 target, GJKResult *result)
+{
+	float weights[3] = { 1, 0, 0 };
+	Vector3 ab, ac, ap;
+	float d00, d01, d11, d20, d21, denom;
+	int i;
+
+	if (numPoints == 2)
+		ClosestOnSegment(Vec3Sub(points[0].w, target), Vec3Sub(points[1].w, target), weights);
+	else if (numPoints == 3)
+	{
+		/* barycentric coordinates of the target in the triangle */
+		ab = Vec3Sub(points[1].w, points[0].w);
+		ac = Vec3Sub(points[2].w, points[0].w);
+		ap = Vec3Sub(target, points[0].w);
+		d00 = Vec3Dot(ab, ab);	d01 = Vec3Dot(ab, ac);	d11 = Vec3Dot(ac, ac);
+		d20 = Vec3Dot(ap, ab);	d21 = Vec3Dot(ap, ac);
+		denom = d00 * d11 - d01 * d01;
+		if (denom > DEGENERATE)
+		{
+			weights[1] = (d11 * d20 - d01 * d21) / denom;
+			weights[2] = (d00 * d21 - d01 * d20) / denom;
+			weights[0] = 1 - weights[1] - weights[2];
+		}
+	}
+
+	result->pointA = Vec3New(0, 0, 0);
+	result->pointB = Vec3New(0, 0, 0);
+	for (i = 0; i < numPoints; i++)
+	{
+		result->pointA = Vec3Add(result->pointA, Vec3Mult(points[i].a, weights[i]));
+		result->pointB = Vec3Add(result->pointB, Vec3Mult(points[i].b, weights[i]));
+	}
+}
+
+static bool AddFace(EPAFace *faces, int *numFaces, SupportPoint *verts, int a, int b, int c)
+{
+	EPAFace *face;
+	Vector3 normal = Vec3Cross(Vec3Sub(verts[b].w, verts[a].w), Vec3Sub(verts[c].w, verts[a].w));
+	float length = Vec3Magnitude(normal);
+
+	if (*numFaces == EPA_MAX_FACES || length * length <= DEGENERATE)
+		return false;
+
+	face = &faces[(*numFaces)++];
+	face->v[0] = a;
+	face->v[1] = b;
+	face->v[2] = c;
+	face->normal = Vec3Mult(normal, 1.0f / length);
+	face->distance = Vec3Dot(face->normal, verts[a].w);
+
+	return true;
+}
+
+/* direction reported when there is no penetration direction to find - along the centre line, or up if the centres meet */
+static Vector3 FallbackNormal(Rigidbody *a, Rigidbody *b)
+{
+	Vector3 direction = Vec3Sub(b->position, a->position);
+
+	if (Vec3Dot(direction, direction) <= DEGENERATE)
+		return Vec3New(0, 1, 0);
+
+	return Vec3Normalize(direction);
+}
+
+/* expands a tetrahedron containing the origin until its closest face is on the boundary of a - b */
+static void EPA(Rigidbody *a, Rigidbody *b, SupportPoint *simplex, int *hintA, int *hintB, GJKResult *result)
+{
+	SupportPoint verts[EPA_MAX_VERTS], corners[3];
+	EPAFace faces[EPA_MAX_FACES];
+	int edges[EPA_MAX_FACES * 3][2];
+	int numVerts = 4, numFaces = 0, numEdges, iteration, closest, i, j, k, e0, e1;
+	SupportPoint p;
+	bool found;
+
+	for (i = 0; i < 4; i++)
+		verts[i] = simplex[i];
+
+	/* wind every face outwards - the origin may be almost on one, so its side can't be trusted */
+	if (Vec3Dot(Vec3Cross(Vec3Sub(verts[1].w, verts[0].w), Vec3Sub(verts[2].w, verts[0].w)), Vec3Sub(verts[3].w, verts[0].w)) > 0)
+	{
+		verts[1] = simplex[2];
+		verts[2] = simplex[1];
+	}
+
+	AddFace(faces, &numFaces, verts, 0, 1, 2);
+	AddFace(faces, &numFaces, verts, 0, 3, 1);
+	AddFace(faces, &numFaces, verts, 0, 2, 3);
+	AddFace(faces, &numFaces, verts, 1, 3, 2);
+
+	closest = 0;
+	for (iteration = 0; iteration < EPA_MAX_ITERATIONS && numFaces > 0; iteration++)
+	{
+		closest = 0;
+		for (i = 1; i < numFaces; i++)
+			if (faces[i].distance < faces[closest].distance)
+				closest = i;
+
+		p = Support(a, b, faces[closest].normal, hintA, hintB);
+		if (Vec3Dot(p.w, faces[closest].normal) - faces[closest].distance < EPA_TOLERANCE || numVerts == EPA_MAX_VERTS)
+			break;
+
+		/* remove every face the new point can see, keeping the edges of the hole - faces level with
+		   the point are kept, or coplanar faces (sides of a box) could be split and the hole torn */
+		verts[numVerts] = p;
+		numEdges = 0;
+		for (i = 0; i < numFaces; )
+		{
+			if (Vec3Dot(faces[i].normal, Vec3Sub(p.w, verts[faces[i].v[0]].w)) > EPA_VISIBLE)
+			{
+				for (j = 0; j < 3; j++)
+				{
+					e0 = faces[i].v[j];
+					e1 = faces[i].v[(j + 1) % 3];
+
+					/* an edge shared with another removed face is inside the hole */
+					found = false;
+					for (k = 0; k < numEdges && !found; k++)
+					{
+						if (edges[k][0] == e1 && edges[k][1] == e0)
+						{
+							edges[k][0] = edges[numEdges - 1][0];
+							edges[k][1] = edges[numEdges - 1][1];
+							numEdges--;
+							found = true;
+						}
+					}
+					if (!found)
+					{
+						edges[numEdges][0] = e0;
+						edges[numEdges][1] = e1;
+						numEdges++;
+					}
+				}
+				faces[i] = faces[--numFaces];
+			}
+			else
+				i++;
+		}
+
+		/* fill the hole with faces joining its edges to the new point */
+		for (i = 0; i < numEdges; i++)
+			AddFace(faces, &numFaces, verts, edges[i][0], edges[i][1], numVerts);
+		numVerts++;
+	}
+
+	/* every face was too thin to give a direction */
+	if (numFaces == 0)
+	{
+		result->distance = 0;
+		result->normal = FallbackNormal(a, b);
+		result->pointA = result->pointB = simplex[0].a;
+		return;
+	}
+
+	/* a touching origin may be just outside the closest face */
+	result->normal = faces[closest].normal;
+	result->distance = faces[closest].distance > 0 ? -faces[closest].distance : 0;
+	for (i = 0; i < 3; i++)
+		corners[i] = verts[faces[closest].v[i]];
+	WitnessPoints(corners, 3, Vec3Mult(faces[closest].normal, faces[closest].distance), result);
+}
+
+/* adds points until the simplex is a tetrahedron, for EPA when GJK stopped with the origin on its boundary */
+static bool FillSimplex(Rigidbody *a, Rigidbody *b, SupportPoint *simplex, int *numPoints, int *hintA, int *hintB)
+{
+	static const Vector3 axes[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+	Vector3 direction, edge, normal;
+	SupportPoint p;
+	int i, j;
+	bool added;
+
+	while (*numPoints < 4)
+	{
+		added = false;
+		for (i = 0; i < 6 && !added; i++)
+		{
+			direction = axes[i];
+
+			/* search away from the current line or plane */
+			if (*numPoints == 2)
+			{
+				edge = Vec3Sub(simplex[1].w, simplex[0].w);
+				direction = Vec3Cross(edge, axes[i]);
+			}
+			else if (*numPoints == 3)
+			{
+				normal = Vec3Cross(Vec3Sub(simplex[1].w, simplex[0].w), Vec3Sub(simplex[2].w, simplex[0].w));
+				direction = i % 2 == 0 ? normal : Vec3Mult(normal, -1);
+			}
+
+			if (Vec3Dot(direction, direction) <= DEGENERATE)
+				continue;
+
+			p = Support(a, b, direction, hintA, hintB);
+
+			/* must add volume, not repeat a point */
+			added = Vec3Dot(Vec3Sub(p.w, simplex[0].w), direction) > 1e-6f;
+			for (j = 0; j < *numPoints && added; j++)
+				added = p.vertexA != simplex[j].vertexA || p.vertexB != simplex[j].vertexB;
+		}
+
+		if (!added)
+			return false;
+
+		simplex[(*numPoints)++] = p;
+	}
+
+	return true;
+}
+
+void GJKCacheReset(GJKCache *cache)
+{
+	cache->valid = false;
+	cache->numPoints = 0;
+}
+
+void GJKCacheSwap(GJKCache *cache)
+{
+	int temp, i;
+
+	/* the simplex of b - a is the negated simplex of a - b, so it is still a good start */
+	for (i = 0; i < 4; i++)
+	{
+		temp = cache->vertexA[i];
+		cache->vertexA[i] = cache->vertexB[i];
+		cache->vertexB[i] = temp;
+	}
+}
+
+bool GJKQuery(Rigidbody *a, Rigidbody *b, GJKCache *cache, GJKResult *result)
+{
+	SupportPoint simplex[4], p;
+	GJKCache local;
+	Vector3 v, direction;
+	int numPoints = 0, hintA = 0, hintB = 0, i;
+	bool intersecting = false;
+	float lengthSq, length;
+
+	if (cache == NULL)
+	{
+		GJKCacheReset(&local);
+		cache = &local;
+	}
+
+	/* start from the last simplex, moved with the bodies */
+	if (cache->valid)
+	{
+		for (i = 0; i < cache->numPoints; i++)
+		{
+			if (cache->vertexA[i] < 0 || cache->vertexA[i] >= (int)a->numVerts || cache->vertexB[i] < 0 || cache->vertexB[i] >= (int)b->numVerts)
+				break;
+
+			simplex[i].vertexA = cache->vertexA[i];
+			simplex[i].vertexB = cache->vertexB[i];
+			simplex[i].a = a->vertices[simplex[i].vertexA];
+			simplex[i].b = b->vertices[simplex[i].vertexB];
+			simplex[i].w = Vec3Sub(simplex[i].a, simplex[i].b);
+		}
+
+		if (i == cache->numPoints && i > 0)
+		{
+			numPoints = i;
+			hintA = simplex[0].vertexA;
+			hintB = simplex[0].vertexB;
+		}
+	}
+
+	if (numPoints == 0)
+	{
+		direction = Vec3Sub(a->position, b->position);
+		if (Vec3Dot(direction, direction) <= DEGENERATE)
+			direction = Vec3New(1, 0, 0);
+		simplex[0] = Support(a, b, direction, &hintA, &hintB);
+		numPoints = 1;
+	}
+
+	intersecting = !ReduceSimplex(simplex, &numPoints, &v);
+
+	result->iterations = 0;
+	while (!intersecting && result->iterations < GJK_MAX_ITERATIONS)
+	{
+		result->iterations++;
+
+		lengthSq = Vec3Dot(v, v);
+		if (lengthSq <= GJK_TOUCHING * GJK_TOUCHING)
+		{
+			/* origin on the simplex - touching */
+			intersecting = true;
+			break;
+		}
+
+		/* no point of a - b is closer to the origin than v in its direction - v is the closest */
+		p = Support(a, b, Vec3Mult(v, -1), &hintA, &hintB);
+		if (lengthSq - Vec3Dot(v, p.w) <= GJK_TOLERANCE * lengthSq)
+			break;
+
+		/* a point already in the simplex can't get any closer - rounding on a thin simplex */
+		for (i = 0; i < numPoints; i++)
+			if (p.vertexA == simplex[i].vertexA && p.vertexB == simplex[i].vertexB)
+				break;
+		if (i < numPoints)
+			break;
+
+		simplex[numPoints++] = p;
+		intersecting = !ReduceSimplex(simplex, &numPoints, &v);
+	}
+
+	cache->valid = true;
+	cache->numPoints = numPoints;
+	for (i = 0; i < numPoints; i++)
+	{
+		cache->vertexA[i] = simplex[i].vertexA;
+		cache->vertexB[i] = simplex[i].vertexB;
+	}
+
+	result->intersecting = intersecting;
+
+	if (!intersecting)
+	{
+		length = Vec3Magnitude(v);
+		result->distance = length;
+		result->normal = Vec3Mult(v, -1.0f / length);
+		WitnessPoints(simplex, numPoints, v, result);
+		return false;
+	}
+
+	if (!FillSimplex(a, b, simplex, &numPoints, &hintA, &hintB))
+	{
+		/* flat contact with nothing to expand - report touching along the centre line */
+		result->distance = 0;
+		result->normal = FallbackNormal(a, b);
+		result->pointA = result->pointB = simplex[0].a;
+		return true;
+	}
+
+	EPA(a, b, simplex, &hintA, &hintB, result);
+	return true;
+}
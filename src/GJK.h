@@ -0,0 +1,77 @@
+/**
+ * @file	GJK.h
+ * @brief	Distance and penetration queries between convex rigidbodys.
+ */
+
+#ifndef GJK_H
+#define GJK_H
+
+#include "Vector3.h"
+#include "Boolean.h"
+
+struct Rigidbody;
+
+/**
+ * @brief	State kept between queries on the same pair of rigidbodys.
+ * @details	Holds the vertices of the last simplex. Bodies move little between steps, so starting
+ * 			from the last simplex usually confirms the result in one iteration.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct GJKCache
+{
+	bool valid;
+	int numPoints;
+	int vertexA[4];					/* vertex of each simplex point on the first body */
+	int vertexB[4];					/* vertex of each simplex point on the second body */
+};
+typedef struct GJKCache GJKCache;
+
+/**
+ * @brief	Result of a query. 
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct GJKResult
+{
+	bool intersecting;
+	float distance;					/* gap between the bodies, negative penetration depth if intersecting */
+	Vector3 normal;					/* unit direction from the first body towards the second */
+	Vector3 pointA;					/* closest (or deepest) point on the first body */
+	Vector3 pointB;					/* closest (or deepest) point on the second body */
+	int iterations;					/* GJK iterations, not including EPA */
+};
+typedef struct GJKResult GJKResult;
+
+/**
+ * @brief	Marks a cache as empty.
+ * @details	Call when either body is replaced or its shape changes.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache	The cache.
+ */
+void GJKCacheReset(GJKCache *cache);
+
+/**
+ * @brief	Swaps the bodies of a cache, for when the pair is next queried the other way round.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache	The cache.
+ */
+void GJKCacheSwap(GJKCache *cache);
+
+/**
+ * @brief	Finds the distance between two rigidbodys, or their penetration if they intersect.
+ * @details	GJK finds the closest points of the bodies. If they intersect, EPA expands the final
+ * 			simplex to find the penetration depth and direction.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	a	  	The first rigidbody. Vertices must be calculated.
+ * @param 	b	  	The second rigidbody. Vertices must be calculated.
+ * @param 	cache 	State from the last query of this pair (updated), or NULL.
+ * @param 	result	The result.
+ * @return	true if the bodies intersect.
+ */
+bool GJKQuery(struct Rigidbody *a, struct Rigidbody *b, GJKCache *cache, GJKResult *result);
+
+#endif
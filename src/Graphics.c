@@ -1,359 +1,859 @@
-
-#include "Graphics.h"
-#include "ImageTGA.h"
-#include <stdlib.h>
-#include <string.h>
-#include <stdio.h>
-#include <limits.h>
-
-#ifdef __APPLE__
-#include <OpenGL/gl.h> 
-#include <GLUT/glut.h>
-#else
-#include <GL/gl.h> 
-#include <GL/glut.h>
-#endif
-
-void GlutDisplay() {}
-
-void GraphicsInit(char *path)
-{
-	int argc = 0;
-	char** argv = 0;
-	float ambientColor[] = {0.2f, 0.2f, 0.2f, 1.0f};
-
-	glutInit(&argc, argv);
-	glutInitDisplayMode(GLUT_RGBA | GLUT_DOUBLE | GLUT_DEPTH | GLUT_STENCIL | GLUT_MULTISAMPLE);
-
-	/* create window */
-	glutInitWindowSize(DisplayProperties.windowWidth, DisplayProperties.windowHeight);
-	glutCreateWindow(DisplayProperties.windowCaption);
-	GraphicsUpdateDisplayProperties();
-
-	/* depth settings */
-	glEnable(GL_DEPTH_TEST);
-	glClearDepth(1.0f);
-    glDepthFunc(GL_LEQUAL);
-    glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
-
-	/* light/shadow settings */
-	glLightModelfv(GL_LIGHT_MODEL_AMBIENT, ambientColor);
-	glEnable(GL_LIGHTING);
-	glClearStencil(0);
-
-	/* blend settings */
-	glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
-	glEnable(GL_COLOR_MATERIAL);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_BLEND);
-
-	/* load textures */
-	glEnable(GL_TEXTURE_2D);
-	LoadTextures(path);
-
-	/* set update timer function */
-	glutTimerFunc(1000 / DisplayProperties.FPS, GlutTimerCallback, 0);
-	
-	/* keep glut happy */
-	glutDisplayFunc(GlutDisplay);
-}
-
-void LoadTextures(char *path)
-{
-	ImageTGA tga;
-	int i;
-	char filename[] = "Assets/Dice00.tga";
-
-	for (i = 0; i < 6; i++)
-	{
-		/* create filename */
-		filename[strlen(filename)-5] = (char)((int)'1' + i);
-
-		/* load tga */
-		TGALoad(&tga, filename);
-
-		/* create openGL texture */
-		glGenTextures(1, (GLuint*)&Textures.dice[i]);
-		glBindTexture(GL_TEXTURE_2D, (GLuint)Textures.dice[i]);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-		if (tga.bpp == 32)
-			gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGBA, tga.width, tga.height, GL_RGBA, GL_UNSIGNED_BYTE, tga.image);
-		else if (tga.bpp == 24)
-			gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGB, tga.width, tga.height, GL_RGB, GL_UNSIGNED_BYTE, tga.image);
-	}
-}
-
-void CreateShadowMatrix(Vector3 lightPosition)
-{
-	DisplayProperties.shadowMatrix[0]  = lightPosition.y;
-	DisplayProperties.shadowMatrix[4]  = -lightPosition.x;
-	DisplayProperties.shadowMatrix[8]  = 0;
-	DisplayProperties.shadowMatrix[12] = 0;
-
-	DisplayProperties.shadowMatrix[1]  = 0;
-	DisplayProperties.shadowMatrix[5]  = 0;
-	DisplayProperties.shadowMatrix[9]  = 0;
-	DisplayProperties.shadowMatrix[13] = 0;
-
-	DisplayProperties.shadowMatrix[2]  = 0;
-	DisplayProperties.shadowMatrix[6]  = -lightPosition.z;
-	DisplayProperties.shadowMatrix[10] = lightPosition.y;
-	DisplayProperties.shadowMatrix[14] = 0;
-
-	DisplayProperties.shadowMatrix[3]  = 0;
-	DisplayProperties.shadowMatrix[7]  = -lightPosition.z;
-	DisplayProperties.shadowMatrix[11] = 0;
-	DisplayProperties.shadowMatrix[15] = lightPosition.y;
-}
-
-void GraphicsStartLoop(LoopCallbackType updateFunction)
-{
-	loop = updateFunction;
-	glutMainLoop();
-}
-
-void GraphicsUpdateDisplayProperties()
-{
-	int w, h;
-	float aspectRatio;
-
-	glutSetWindowTitle(DisplayProperties.windowCaption);
-
-	glClearColor(DisplayProperties.clearColour.r, DisplayProperties.clearColour.g, DisplayProperties.clearColour.b, DisplayProperties.clearColour.a);
-
-	if (DisplayProperties.fullscreen)
-	{
-		glutFullScreen();
-		w = glutGet(GLUT_SCREEN_WIDTH);
-		h = glutGet(GLUT_SCREEN_HEIGHT);
-	}
-	else
-	{
-		w = DisplayProperties.windowWidth;
-		h = DisplayProperties.windowHeight;
-	}
-
-	aspectRatio = 1.0f * w / h;
-
-	/* update projection and display port */
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
-	glViewport(0, 0, DisplayProperties.windowWidth, DisplayProperties.windowHeight);
-	gluPerspective(DisplayProperties.fov, aspectRatio, DisplayProperties.zNear, DisplayProperties.zFar);
-	glMatrixMode(GL_MODELVIEW);
-}
-
-void RenderScene(Scene *scene)
-{
-	int i;
-
-	/* set lighting */
-	SetLighting(&scene->light);
-
-	/* clear buffer */
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-	glLoadIdentity();
-
-	/* set view */
-	gluLookAt(scene->camera.position.x, scene->camera.position.y, scene->camera.position.z, scene->camera.focus.x, scene->camera.focus.y, scene->camera.focus.z, 0, 1, 0);
-
-	/* render floor */
-	glEnable(GL_STENCIL_TEST);
-	glStencilFunc(GL_ALWAYS, 1, 0xFF);
-	glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-		RenderFloor();
-	glDisable(GL_STENCIL_TEST);
-	
-	/* render shadows */
-	glEnable(GL_STENCIL_TEST);
-	glStencilFunc(GL_EQUAL, 1, 0xFF);
-	glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
-	glDisable(GL_LIGHTING);
-	glDisable(GL_TEXTURE);
-	glDisable(GL_DEPTH_TEST);
-	glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
-	CreateShadowMatrix(scene->light.position);
-	glPushMatrix();
-		glMultMatrixf(DisplayProperties.shadowMatrix);
-		for (i = 0; i < scene->numObjects; i++)
-			RenderRigidbody(&scene->objects[i]);
-	glPopMatrix();
-	glDisable(GL_STENCIL_TEST);
-	glEnable(GL_LIGHTING);
-	glEnable(GL_TEXTURE);
-	glEnable(GL_DEPTH_TEST);
-
-	/* render objects */
-	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
-	glPushMatrix();
-		for (i = 0; i < scene->numObjects; i++)
-			RenderRigidbody(&scene->objects[i]);
-	glPopMatrix();
-	
-	glFlush();
-	glutSwapBuffers();
-}
-
-void RenderFloor()
-{
-	glPushMatrix();
-		glBindTexture(GL_TEXTURE_2D, Textures.dice[2]);
-		glColor4f(0.2f, 0.2f, 0.2f, 0.5f);
-		glBegin(GL_QUADS);
-			glNormal3f(0, 1, 0); glVertex3f(-100, 0,-100);
-			glNormal3f(0, 1, 0); glVertex3f(-100, 0, 100);
-			glNormal3f(0, 1, 0); glVertex3f( 100, 0, 100);
-			glNormal3f(0, 1, 0); glVertex3f( 100, 0,-100);
-		glEnd();
-	glPopMatrix();
-}
-
-void RenderRigidbody(Rigidbody *rb)
-{
-	float m[16];
-	float x, y, z;
-
-	x = rb->dimensions.x / 2;
-	y = rb->dimensions.y / 2;
-	z = rb->dimensions.z / 2;
-
-    glPushMatrix();
-		/* convert orientation and poisition to openGL matrix */
-        CreateOpenGLTransform(rb->orientation, rb->position, m);
-        glMultMatrixf(m);
-        
-		glBindTexture(GL_TEXTURE_2D, Textures.dice[0]);
-		glBegin(GL_QUADS);
-			glNormal3f(-1.0f, 0.0f, 0.0f); glTexCoord2f(0.0f, 1.0f); glVertex3f(-x,-y,-z);
-			glNormal3f(-1.0f, 0.0f, 0.0f); glTexCoord2f(0.0f, 0.0f); glVertex3f(-x,-y, z);
-			glNormal3f(-1.0f, 0.0f, 0.0f); glTexCoord2f(1.0f, 0.0f); glVertex3f(-x, y, z);
-			glNormal3f(-1.0f, 0.0f, 0.0f); glTexCoord2f(1.0f, 1.0f); glVertex3f(-x, y,-z);
-		glEnd();
-                
-		glBindTexture(GL_TEXTURE_2D, Textures.dice[1]);
-		glBegin(GL_QUADS);
-			glNormal3f( 1.0f, 0.0f, 0.0f); glTexCoord2f(1.0f, 1.0f); glVertex3f( x, y, z);
-			glNormal3f( 1.0f, 0.0f, 0.0f); glTexCoord2f(0.0f, 1.0f); glVertex3f( x,-y, z);
-			glNormal3f( 1.0f, 0.0f, 0.0f); glTexCoord2f(0.0f, 0.0f); glVertex3f( x,-y,-z);
-			glNormal3f( 1.0f, 0.0f, 0.0f); glTexCoord2f(1.0f, 0.0f); glVertex3f( x, y,-z);
-		glEnd();
-
-		glBindTexture(GL_TEXTURE_2D, Textures.dice[2]);
-		glBegin(GL_QUADS);
-			glNormal3f( 0.0f,-1.0f, 0.0f); glTexCoord2f(0.0f, 1.0f); glVertex3f(-x,-y,-z);
-			glNormal3f( 0.0f,-1.0f, 0.0f); glTexCoord2f(0.0f, 0.0f); glVertex3f( x,-y,-z);
-			glNormal3f( 0.0f,-1.0f, 0.0f); glTexCoord2f(1.0f, 0.0f); glVertex3f( x,-y, z);
-			glNormal3f( 0.0f,-1.0f, 0.0f); glTexCoord2f(1.0f, 1.0f); glVertex3f(-x,-y, z);
-		glEnd();
-
-		glBindTexture(GL_TEXTURE_2D, Textures.dice[3]);
-		glBegin(GL_QUADS);
-			glNormal3f( 0.0f, 1.0f, 0.0f); glTexCoord2f(1.0f, 1.0f); glVertex3f( x, y, z);
-			glNormal3f( 0.0f, 1.0f, 0.0f); glTexCoord2f(0.0f, 1.0f); glVertex3f( x, y,-z);
-			glNormal3f( 0.0f, 1.0f, 0.0f); glTexCoord2f(0.0f, 0.0f); glVertex3f(-x, y,-z);
-			glNormal3f( 0.0f, 1.0f, 0.0f); glTexCoord2f(1.0f, 0.0f); glVertex3f(-x, y, z);
-		glEnd();
-
-		glBindTexture(GL_TEXTURE_2D, Textures.dice[4]);
-		glBegin(GL_QUADS);
-			glNormal3f( 0.0f, 0.0f,-1.0f); glTexCoord2f(0.0f, 1.0f); glVertex3f(-x,-y,-z);
-			glNormal3f( 0.0f, 0.0f,-1.0f); glTexCoord2f(0.0f, 0.0f); glVertex3f(-x, y,-z);
-			glNormal3f( 0.0f, 0.0f,-1.0f); glTexCoord2f(1.0f, 0.0f); glVertex3f( x, y,-z);
-			glNormal3f( 0.0f, 0.0f,-1.0f); glTexCoord2f(1.0f, 1.0f); glVertex3f( x,-y,-z);
-        glEnd();
-
-		glBindTexture(GL_TEXTURE_2D, Textures.dice[5]);
-		glBegin(GL_QUADS);
-			glNormal3f( 0.0f, 0.0f, 1.0f); glTexCoord2f(1.0f, 1.0f); glVertex3f( x, y, z);
-			glNormal3f( 0.0f, 0.0f, 1.0f); glTexCoord2f(0.0f, 1.0f); glVertex3f(-x, y, z);
-			glNormal3f( 0.0f, 0.0f, 1.0f); glTexCoord2f(0.0f, 0.0f); glVertex3f(-x,-y, z);
-			glNormal3f( 0.0f, 0.0f, 1.0f); glTexCoord2f(1.0f, 0.0f); glVertex3f( x,-y, z);
-		glEnd();
-    glPopMatrix();
-}
-
-void ExitProgram()
-{
-	exit(0);
-}
-
-void SetLighting(Light *light)
-{
-	if (light->enabled)
-	{
-		float ambientLight[] = { light->ambient.r, light->ambient.b, light->ambient.g, light->ambient.a };
-		float diffuseLight[] = { light->diffuse.r, light->diffuse.b, light->diffuse.g, light->diffuse.a };
-		float specularLight[] = { light->specular.r, light->specular.b, light->specular.g, light->specular.a };
-		float position[] = { light->position.x, light->position.y, light->position.z, light->type };   
-
-		glEnable(GL_LIGHTING);
-		glEnable(GL_LIGHT0);
-
-		glLightfv(GL_LIGHT0, GL_AMBIENT, ambientLight);
-		glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuseLight);
-		glLightfv(GL_LIGHT0, GL_SPECULAR, specularLight);
-		glLightfv(GL_LIGHT0, GL_POSITION, position);
-	}
-	else
-	{
-		glDisable(GL_LIGHT0);
-	}
-}
-
-void CreateOpenGLTransform(Matrix3x3 orientation, Vector3 position, float transform[])
-{
-	/* create float[4][4] alias for float[16] array - easier to use loops */
-	float (*m)[4] = (float(*)[4])transform;
-    int i, j;
-    
-	/* set rotation */
-    for (i = 0; i < 3; i++)
-    {
-        for (j = 0; j < 3; j++)
-        {
-            m[j][i] = orientation.elements[i][j];
-        }
-    }
-
-	/* fourth column values set to identity - no scaling */
-    m[0][3] = 0;
-	m[1][3] = 0;
-	m[2][3] = 0; 
-	m[3][3] = 1;
-
-	/* set translation */
-    for (i = 0; i < 3; i++)
-        m[3][i] = Vec3GetElement(&position, i);
-}
-
-void GlutTimerCallback(int x)
-{
-	/* set timer for next loop */
-	glutTimerFunc(1000 / DisplayProperties.FPS, GlutTimerCallback, 0);
-
-	/* check if window size has changed */
-	UpdateWindowSize();
-
-	/* call simulation update function via pointer */
-	(*loop)();
-}
-
-void UpdateWindowSize()
-{
-	int w, h;
-
-	w = glutGet(GLUT_WINDOW_WIDTH);
-	h = glutGet(GLUT_WINDOW_HEIGHT);
-
-	/* update display if window size has changed */
-	if (DisplayProperties.windowWidth != w || DisplayProperties.windowHeight != h)
-	{
-		DisplayProperties.windowWidth = w;
-		DisplayProperties.windowHeight = h;
-		GraphicsUpdateDisplayProperties();
-	}
-}
+
+#include "Graphics.h"
+#include "ImageTGA.h"
+#include "TextureLoader.h"
+#include "TextureCache.h"
+#include "RenderQueue.h"
+#include "FramePacer.h"
+#include "MathUtils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <limits.h>
+#include <math.h>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h> 
+#include <OpenGL/glext.h>
+#include <GLUT/glut.h>
+#define GL_TIME_ELAPSED GL_TIME_ELAPSED_EXT
+#define glGetQueryObjectui64v glGetQueryObjectui64vEXT
+#else
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h> 
+#include <GL/glext.h>
+#include <GL/glut.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+DisplayPropertiesType DisplayProperties;
+TexturesType Textures;
+RenderStatsType RenderStats;
+LoopCallbackType loop;
+
+const float LOD_PIXEL_RADIUS = 8.0f;
+
+/* how a body is drawn this frame */
+enum BodyDetail { DETAIL_CULLED = 0, DETAIL_FLAT, DETAIL_FULL };
+typedef enum BodyDetail BodyDetail;
+
+/* textures being loaded in the background during startup */
+static TextureLoadItem textureLoads[6];
+static int textureLoadIndex[6];
+static int numTextureLoads;
+
+/* prebuilt mip chains, see tools/TextureCacheBuild.c */
+static TextureCache textureCache;
+
+/* offscreen render target */
+static GLuint offscreenFramebuffer;
+static GLuint offscreenColourBuffer;
+static GLuint offscreenDepthBuffer;
+
+/* light position DisplayProperties.shadowMatrix was made for */
+static Vector3 shadowLightPosition;
+static bool shadowMatrixValid;
+
+/* light as last given to openGL, and the view its position was transformed by */
+static Light uploadedLight;
+static float uploadedView[16];
+static bool uploadedLightValid;
+
+/* GL_TIME_ELAPSED queries of each pass, for the last few frames - a frame's are read back when
+   its slot comes round again, by when the GPU has finished them */
+enum { PASS_TIMER_FRAMES = 3 };
+static GLuint passQueries[PASS_TIMER_FRAMES][NUM_RENDER_PASSES];
+static double passTimes[NUM_RENDER_PASSES];
+static int passTimerFrame;
+static bool passTimersSupported;
+
+/* deadlines and timing of the window's frames */
+static FramePacer framePacer;
+
+/* draws of the frame being rendered, in the order of their layers */
+enum RenderLayer { LAYER_FLOOR = 0, LAYER_SHADOWS, LAYER_STATIC_MESH, LAYER_BODIES };
+static RenderQueue renderQueue;
+
+/* the floor marks the stencil, so shadows only darken the floor and each part of it once */
+static const RenderState floorState = { RENDER_LIGHTING | RENDER_DEPTH_TEST | RENDER_STENCIL_TEST | RENDER_TEXTURE | RENDER_BLEND, GL_ALWAYS, 1, GL_REPLACE, { 0.2f, 0.2f, 0.2f, 0.5f } };
+static const RenderState shadowState = { RENDER_STENCIL_TEST | RENDER_BLEND, GL_EQUAL, 1, GL_ZERO, { 0.0f, 0.0f, 0.0f, 0.5f } };
+static const RenderState staticMeshState = { RENDER_LIGHTING | RENDER_DEPTH_TEST | RENDER_BLEND, GL_ALWAYS, 0, GL_KEEP, { 0.45f, 0.3f, 0.2f, 1.0f } };
+static const RenderState bodyState = { RENDER_LIGHTING | RENDER_DEPTH_TEST | RENDER_TEXTURE | RENDER_BLEND, GL_ALWAYS, 0, GL_KEEP, { 1.0f, 1.0f, 1.0f, 1.0f } };
+static const RenderState flatBodyState = { RENDER_LIGHTING | RENDER_DEPTH_TEST | RENDER_BLEND, GL_ALWAYS, 0, GL_KEEP, { 1.0f, 1.0f, 1.0f, 1.0f } };
+
+void GlutDisplay() {}
+
+void GraphicsInit(char *path)
+{
+	int argc = 0;
+	char** argv = 0;
+
+	DisplayProperties.offscreen = false;
+
+	/* decode textures while the window and context are created */
+	BeginLoadTextures(path);
+
+	glutInit(&argc, argv);
+	glutInitDisplayMode(GLUT_RGBA | GLUT_DOUBLE | GLUT_DEPTH | GLUT_STENCIL | GLUT_MULTISAMPLE);
+
+	/* create window */
+	glutInitWindowSize(DisplayProperties.windowWidth, DisplayProperties.windowHeight);
+	glutCreateWindow(DisplayProperties.windowCaption);
+	GraphicsUpdateDisplayProperties();
+
+	InitRenderState();
+
+	/* set update timer function - the first frame is due now */
+	FramePacerInit(&framePacer, DisplayProperties.FPS);
+	glutTimerFunc(0, GlutTimerCallback, 0);
+	
+	/* keep glut happy */
+	glutDisplayFunc(GlutDisplay);
+}
+
+bool GraphicsInitOffscreen(char *path)
+{
+#ifdef __APPLE__
+	/* no surfaceless contexts - use a hidden window to own the context */
+	int argc = 0;
+	char** argv = 0;
+
+	BeginLoadTextures(path);
+
+	glutInit(&argc, argv);
+	glutInitDisplayMode(GLUT_RGBA | GLUT_DEPTH | GLUT_STENCIL);
+	glutInitWindowSize(1, 1);
+	glutCreateWindow(DisplayProperties.windowCaption);
+	glutHideWindow();
+#else
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay;
+	EGLDisplay display;
+	EGLContext context;
+	EGLConfig config;
+	EGLint numConfigs;
+	EGLint configAttributes[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+
+	/* decode textures while the context is created */
+	BeginLoadTextures(path);
+
+	/* surfaceless display - no window system or GPU required */
+	getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay == NULL)
+		return false;
+
+	display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL))
+		return false;
+
+	if (!eglChooseConfig(display, configAttributes, &config, 1, &numConfigs) || numConfigs < 1)
+		return false;
+
+	/* legacy openGL context to match the fixed function renderer */
+	eglBindAPI(EGL_OPENGL_API);
+	context = eglCreateContext(display, config, EGL_NO_CONTEXT, NULL);
+	if (context == EGL_NO_CONTEXT)
+		return false;
+
+	if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+		return false;
+#endif
+
+	DisplayProperties.offscreen = true;
+	DisplayProperties.fullscreen = false;
+
+	/* create framebuffer - created once and reused for every frame */
+	glGenRenderbuffers(1, &offscreenColourBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, offscreenColourBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, DisplayProperties.windowWidth, DisplayProperties.windowHeight);
+
+	glGenRenderbuffers(1, &offscreenDepthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, offscreenDepthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, DisplayProperties.windowWidth, DisplayProperties.windowHeight);
+
+	glGenFramebuffers(1, &offscreenFramebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, offscreenFramebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, offscreenColourBuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, offscreenDepthBuffer);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		return false;
+
+	GraphicsUpdateDisplayProperties();
+	InitRenderState();
+
+	return true;
+}
+
+bool GraphicsCaptureFrame(char *filename)
+{
+	ImageTGA tga;
+	bool result;
+
+	tga.width = (short)DisplayProperties.windowWidth;
+	tga.height = (short)DisplayProperties.windowHeight;
+	tga.bpp = 24;
+	tga.imageSize = tga.width * tga.height * 3;
+	tga.encoding = (char)RAW_RGB_ENCODING;
+	tga.image = (unsigned char*)malloc(tga.imageSize);
+
+	if (tga.image == NULL)
+		return false;
+
+	/* read back rendered frame - rows are bottom-up, matching the TGA default origin */
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, tga.width, tga.height, GL_RGB, GL_UNSIGNED_BYTE, tga.image);
+
+	result = TGASave(&tga, filename);
+
+	free(tga.image);
+	return result;
+}
+
+/* true if openGL 3.3 or an extension provides GL_TIME_ELAPSED queries */
+static bool TimerQueriesSupported()
+{
+	const char *version = (const char*)glGetString(GL_VERSION);
+	const char *extensions = (const char*)glGetString(GL_EXTENSIONS);
+	int major = 0, minor = 0;
+
+	if (version != NULL && sscanf(version, "%d.%d", &major, &minor) == 2 && (major > 3 || (major == 3 && minor >= 3)))
+		return true;
+	return extensions != NULL && (strstr(extensions, "GL_ARB_timer_query") != NULL || strstr(extensions, "GL_EXT_timer_query") != NULL);
+}
+
+void InitRenderState()
+{
+	float ambientColor[] = {0.2f, 0.2f, 0.2f, 1.0f};
+	int i;
+
+	/* depth settings */
+	glEnable(GL_DEPTH_TEST);
+	glClearDepth(1.0f);
+    glDepthFunc(GL_LEQUAL);
+    glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
+
+	/* light/shadow settings */
+	glLightModelfv(GL_LIGHT_MODEL_AMBIENT, ambientColor);
+	glEnable(GL_LIGHTING);
+	glClearStencil(0);
+
+	/* blend settings */
+	glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+	glEnable(GL_COLOR_MATERIAL);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glEnable(GL_BLEND);
+
+	/* upload textures */
+	glEnable(GL_TEXTURE_2D);
+	FinishLoadTextures();
+
+	RenderQueueInit(&renderQueue);
+
+	/* pass timers */
+	passTimersSupported = TimerQueriesSupported();
+	if (passTimersSupported)
+		glGenQueries(PASS_TIMER_FRAMES * NUM_RENDER_PASSES, &passQueries[0][0]);
+	for (i = 0; i < NUM_RENDER_PASSES; i++)
+		passTimes[i] = -1;
+	passTimerFrame = 0;
+}
+
+void BeginLoadTextures(char *path)
+{
+	char filename[256];
+	int i;
+
+	TextureCacheOpen(&textureCache, "Assets/textures.cache");
+
+	/* only decode textures that are missing from the cache or out of date */
+	numTextureLoads = 0;
+	for (i = 0; i < 6; i++)
+	{
+		sprintf(filename, "Assets/Dice%02d.tga", i + 1);
+		if (TextureCacheFind(&textureCache, filename) != NULL)
+			continue;
+
+		strcpy(textureLoads[numTextureLoads].filename, filename);
+		textureLoadIndex[numTextureLoads] = i;
+		numTextureLoads++;
+	}
+
+	TextureLoaderStart(textureLoads, numTextureLoads);
+}
+
+void FinishLoadTextures()
+{
+	TextureCacheEntry *entry;
+	char filename[256];
+	int i;
+
+	/* cached textures upload straight from the mapped file */
+	for (i = 0; i < 6; i++)
+	{
+		sprintf(filename, "Assets/Dice%02d.tga", i + 1);
+		entry = TextureCacheFind(&textureCache, filename);
+		if (entry != NULL)
+			UploadCachedTexture(&textureCache, entry, &Textures.dice[i]);
+	}
+	TextureCacheClose(&textureCache);
+
+	TextureLoaderWait();
+
+	for (i = 0; i < numTextureLoads; i++)
+	{
+		if (!textureLoads[i].loaded)
+			continue;
+
+		UploadTexture(&textureLoads[i].tga, &Textures.dice[textureLoadIndex[i]]);
+		TGAFree(&textureLoads[i].tga);
+	}
+}
+
+void UploadCachedTexture(TextureCache *cache, TextureCacheEntry *entry, unsigned *texture)
+{
+	unsigned char *pixels;
+	unsigned level, width, height;
+
+	glGenTextures(1, (GLuint*)texture);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)*texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, entry->numLevels - 1);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	for (level = 0; level < entry->numLevels; level++)
+	{
+		pixels = TextureCacheGetLevel(cache, entry, level, &width, &height);
+		glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	}
+}
+
+void UploadTexture(ImageTGA *tga, unsigned *texture)
+{
+	static int generateMipmap = -1;
+	GLenum internalFormat, format;
+	const char *version, *renderer, *extensions;
+
+	/* mipmaps can be built on the GPU from openGL 3.0 - software renderers do it slower than GLU.
+	   Any of the strings can be NULL, and core profiles don't give the extensions this way */
+	if (generateMipmap < 0)
+	{
+		version = (const char*)glGetString(GL_VERSION);
+		renderer = (const char*)glGetString(GL_RENDERER);
+		extensions = (const char*)glGetString(GL_EXTENSIONS);
+		generateMipmap = ((version != NULL && atoi(version) >= 3) || 
+			(extensions != NULL && strstr(extensions, "GL_ARB_framebuffer_object") != NULL)) &&
+			renderer != NULL && strstr(renderer, "llvmpipe") == NULL && strstr(renderer, "softpipe") == NULL;
+	}
+
+	/* create openGL texture */
+	glGenTextures(1, (GLuint*)texture);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)*texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	/* rows are tightly packed in the file */
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	if (tga->bpp == 32)
+	{
+		internalFormat = GL_RGBA;
+		format = tga->bgr ? GL_BGRA : GL_RGBA;
+	}
+	else
+	{
+		internalFormat = GL_RGB;
+		format = tga->bgr ? GL_BGR : GL_RGB;
+	}
+
+	if (generateMipmap)
+	{
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, tga->width, tga->height, 0, format, GL_UNSIGNED_BYTE, tga->image);
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+	else
+		gluBuild2DMipmaps(GL_TEXTURE_2D, internalFormat, tga->width, tga->height, format, GL_UNSIGNED_BYTE, tga->image);
+}
+
+void CreateShadowMatrix(Vector3 lightPosition)
+{
+	DisplayProperties.shadowMatrix[0]  = lightPosition.y;
+	DisplayProperties.shadowMatrix[4]  = -lightPosition.x;
+	DisplayProperties.shadowMatrix[8]  = 0;
+	DisplayProperties.shadowMatrix[12] = 0;
+
+	DisplayProperties.shadowMatrix[1]  = 0;
+	DisplayProperties.shadowMatrix[5]  = 0;
+	DisplayProperties.shadowMatrix[9]  = 0;
+	DisplayProperties.shadowMatrix[13] = 0;
+
+	DisplayProperties.shadowMatrix[2]  = 0;
+	DisplayProperties.shadowMatrix[6]  = -lightPosition.z;
+	DisplayProperties.shadowMatrix[10] = lightPosition.y;
+	DisplayProperties.shadowMatrix[14] = 0;
+
+	DisplayProperties.shadowMatrix[3]  = 0;
+	DisplayProperties.shadowMatrix[7]  = -lightPosition.z;
+	DisplayProperties.shadowMatrix[11] = 0;
+	DisplayProperties.shadowMatrix[15] = lightPosition.y;
+}
+
+void GraphicsStartLoop(LoopCallbackType updateFunction)
+{
+	loop = updateFunction;
+	glutMainLoop();
+}
+
+void GraphicsUpdateDisplayProperties()
+{
+	int w, h;
+	float aspectRatio;
+
+	if (!DisplayProperties.offscreen)
+		glutSetWindowTitle(DisplayProperties.windowCaption);
+
+	glClearColor(DisplayProperties.clearColour.r, DisplayProperties.clearColour.g, DisplayProperties.clearColour.b, DisplayProperties.clearColour.a);
+
+	if (DisplayProperties.fullscreen)
+	{
+		glutFullScreen();
+		w = glutGet(GLUT_SCREEN_WIDTH);
+		h = glutGet(GLUT_SCREEN_HEIGHT);
+	}
+	else
+	{
+		w = DisplayProperties.windowWidth;
+		h = DisplayProperties.windowHeight;
+	}
+
+	aspectRatio = 1.0f * w / h;
+
+	/* update projection and display port */
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glViewport(0, 0, DisplayProperties.windowWidth, DisplayProperties.windowHeight);
+	gluPerspective(DisplayProperties.fov, aspectRatio, DisplayProperties.zNear, DisplayProperties.zFar);
+	glMatrixMode(GL_MODELVIEW);
+}
+
+/* finds the planes of the view frustum from the current projection and modelview matrices, as
+   (normal, distance) with normals pointing inwards */
+static void FindFrustumPlanes(float planes[6][4])
+{
+	float projection[16], modelview[16], m[16];
+	float length;
+	int i, j, k;
+
+	glGetFloatv(GL_PROJECTION_MATRIX, projection);
+	glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+
+	/* m = projection * modelview, column major */
+	for (i = 0; i < 4; i++)
+	{
+		for (j = 0; j < 4; j++)
+		{
+			m[j * 4 + i] = 0;
+			for (k = 0; k < 4; k++)
+				m[j * 4 + i] += projection[k * 4 + i] * modelview[j * 4 + k];
+		}
+	}
+
+	/* left, right, bottom, top, near, far - the last row plus or minus each of the others */
+	for (i = 0; i < 6; i++)
+	{
+		for (j = 0; j < 4; j++)
+			planes[i][j] = m[j * 4 + 3] + (i % 2 == 0 ? 1 : -1) * m[j * 4 + i / 2];
+
+		length = (float)sqrt(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] + planes[i][2] * planes[i][2]);
+		for (j = 0; j < 4; j++)
+			planes[i][j] /= length;
+	}
+}
+
+/* picks how to draw a sphere - culled if it is outside the frustum, flat if it would be drawn
+   smaller than LOD_PIXEL_RADIUS */
+static BodyDetail FindDetail(float planes[6][4], Vector3 eye, float pixelsPerUnit, Vector3 centre, float radius)
+{
+	float distance;
+	int i;
+
+	for (i = 0; i < 6; i++)
+		if (planes[i][0] * centre.x + planes[i][1] * centre.y + planes[i][2] * centre.z + planes[i][3] < -radius)
+			return DETAIL_CULLED;
+
+	distance = Vec3Magnitude(Vec3Sub(centre, eye)) - radius;
+	if (distance > 0 && radius * pixelsPerUnit < LOD_PIXEL_RADIUS * distance)
+		return DETAIL_FLAT;
+	return DETAIL_FULL;
+}
+
+/* starts timing a pass of the current frame */
+static void BeginPassTimer(RenderPass pass)
+{
+	if (passTimersSupported)
+		glBeginQuery(GL_TIME_ELAPSED, passQueries[passTimerFrame % PASS_TIMER_FRAMES][pass]);
+}
+
+/* stops timing the current pass */
+static void EndPassTimer()
+{
+	if (passTimersSupported)
+		glEndQuery(GL_TIME_ELAPSED);
+}
+
+/* reads back the pass times of the frame whose queries are about to be reused */
+static void ReadPassTimers()
+{
+	GLuint64 time;
+	int i;
+
+	if (!passTimersSupported || passTimerFrame < PASS_TIMER_FRAMES)
+		return;
+
+	for (i = 0; i < NUM_RENDER_PASSES; i++)
+	{
+		glGetQueryObjectui64v(passQueries[passTimerFrame % PASS_TIMER_FRAMES][i], GL_QUERY_RESULT, &time);
+		passTimes[i] = time / 1000000.0;
+	}
+}
+
+void RenderScene(Demo *demo)
+{
+	Scene *scene = &demo->scene;
+	float planes[6][4];
+	float pixelsPerUnit, shadowScale;
+	Vector3 shadowCentre;
+	Light *light = &demo->light;
+	Rigidbody *rb;
+	BodyDetail detail;
+	int i, j;
+
+	memset(&RenderStats, 0, sizeof(RenderStats));
+	renderQueue.drawCalls = 0;
+	renderQueue.stateChanges = 0;
+	ReadPassTimers();
+	memcpy(RenderStats.gpuTime, passTimes, sizeof(passTimes));
+
+	/* clear buffer */
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+	glLoadIdentity();
+
+	/* set view */
+	gluLookAt(demo->camera.position.x, demo->camera.position.y, demo->camera.position.z, demo->camera.focus.x, demo->camera.focus.y, demo->camera.focus.z, 0, 1, 0);
+
+	/* set lighting - after the view so the light position is in world space */
+	SetLighting(light);
+	if (!shadowMatrixValid || !Vec3Equal(light->position, shadowLightPosition))
+	{
+		CreateShadowMatrix(light->position);
+		shadowLightPosition = light->position;
+		shadowMatrixValid = true;
+	}
+
+	FindFrustumPlanes(planes);
+	pixelsPerUnit = DisplayProperties.windowHeight / (2 * (float)tan(DegToRad(DisplayProperties.fov) / 2));
+	shadowScale = light->position.y > 0 ? Vec3Magnitude(light->position) / light->position.y : 0;
+
+	RenderQueueAdd(&renderQueue, LAYER_FLOOR, &floorState, Textures.dice[2], GL_QUADS, RenderFloor, NULL, 0);
+	if (scene->staticMesh != NULL)
+		RenderQueueAdd(&renderQueue, LAYER_STATIC_MESH, &staticMeshState, 0, GL_TRIANGLES, RenderStaticMesh, scene->staticMesh, 0);
+
+	for (i = 0; i < scene->numObjects; i++)
+	{
+		rb = &scene->objects[i];
+
+		/* the shadow matrix projects along the light position, so a shadow lies within the body's
+		   bounding sphere moved down to the floor and stretched by up to |light| / light.y */
+		detail = DETAIL_FULL;
+		if (shadowScale > 0)
+		{
+			shadowCentre = Vec3Sub(rb->position, Vec3Mult(light->position, rb->position.y / light->position.y));
+			detail = FindDetail(planes, demo->camera.position, pixelsPerUnit, shadowCentre, rb->outsideRadius * shadowScale);
+		}
+		if (detail != DETAIL_CULLED)
+		{
+			RenderQueueAdd(&renderQueue, LAYER_SHADOWS, &shadowState, 0, GL_TRIANGLES, RenderShadow, rb, 0);
+			RenderStats.shadowsDrawn++;
+		}
+
+		/* textured dice face by face, so all faces with the same texture are drawn together */
+		detail = FindDetail(planes, demo->camera.position, pixelsPerUnit, rb->position, rb->outsideRadius);
+		if (detail == DETAIL_CULLED)
+		{
+			RenderStats.bodiesCulled++;
+			continue;
+		}
+
+		if (detail == DETAIL_FULL && rb->shapeType == SHAPE_BOX)
+		{
+			for (j = 0; j < 6; j++)
+				RenderQueueAdd(&renderQueue, LAYER_BODIES, &bodyState, Textures.dice[j], GL_QUADS, RenderBoxFace, rb, j);
+		}
+		else
+		{
+			RenderQueueAdd(&renderQueue, LAYER_BODIES, &flatBodyState, 0, GL_TRIANGLES, RenderRigidbodyFlat, rb, 0);
+			if (detail == DETAIL_FLAT)
+				RenderStats.bodiesSimplified++;
+		}
+		RenderStats.bodiesDrawn++;
+	}
+
+	BeginPassTimer(PASS_FLOOR);
+		RenderQueueSubmit(&renderQueue, LAYER_FLOOR);
+	EndPassTimer();
+	BeginPassTimer(PASS_SHADOWS);
+		RenderQueueSubmit(&renderQueue, LAYER_SHADOWS);
+	EndPassTimer();
+	BeginPassTimer(PASS_OBJECTS);
+		RenderQueueSubmit(&renderQueue, LAYER_BODIES);
+	EndPassTimer();
+	passTimerFrame++;
+
+	RenderStats.drawCalls = renderQueue.drawCalls;
+	RenderStats.stateChanges += renderQueue.stateChanges;
+
+	if (!DisplayProperties.offscreen)
+		glutSwapBuffers();
+}
+
+void RenderFloor(const void *object, int part)
+{
+	/* texture coordinate picks a plain part of the texture */
+	glNormal3f(0, 1, 0); glTexCoord2f(1.0f, 0.0f); glVertex3f(-100, 0,-100);
+	glNormal3f(0, 1, 0); glTexCoord2f(1.0f, 0.0f); glVertex3f(-100, 0, 100);
+	glNormal3f(0, 1, 0); glTexCoord2f(1.0f, 0.0f); glVertex3f( 100, 0, 100);
+	glNormal3f(0, 1, 0); glTexCoord2f(1.0f, 0.0f); glVertex3f( 100, 0,-100);
+}
+
+void RenderStaticMesh(const void *mesh, int part)
+{
+	const StaticMesh *staticMesh = (const StaticMesh*)mesh;
+	StaticTriangle *triangle;
+	int i, j;
+
+	for (i = 0; i < staticMesh->numTriangles; i++)
+	{
+		triangle = &staticMesh->triangles[i];
+		glNormal3f(triangle->normal.x, triangle->normal.y, triangle->normal.z);
+		for (j = 0; j < 3; j++)
+			glVertex3f(triangle->vertices[j].x, triangle->vertices[j].y, triangle->vertices[j].z);
+	}
+}
+
+void RenderBoxFace(const void *rigidbody, int face)
+{
+	/* corners of each face as signs of the half dimensions, with texture coordinates */
+	static const float corners[6][4][5] = {
+		{ {-1,-1,-1, 0,1}, {-1,-1, 1, 0,0}, {-1, 1, 1, 1,0}, {-1, 1,-1, 1,1} },
+		{ { 1, 1, 1, 1,1}, { 1,-1, 1, 0,1}, { 1,-1,-1, 0,0}, { 1, 1,-1, 1,0} },
+		{ {-1,-1,-1, 0,1}, { 1,-1,-1, 0,0}, { 1,-1, 1, 1,0}, {-1,-1, 1, 1,1} },
+		{ { 1, 1, 1, 1,1}, { 1, 1,-1, 0,1}, {-1, 1,-1, 0,0}, {-1, 1, 1, 1,0} },
+		{ {-1,-1,-1, 0,1}, {-1, 1,-1, 0,0}, { 1, 1,-1, 1,0}, { 1,-1,-1, 1,1} },
+		{ { 1, 1, 1, 1,1}, {-1, 1, 1, 0,1}, {-1,-1, 1, 0,0}, { 1,-1, 1, 1,0} }
+	};
+	const Rigidbody *rb = (const Rigidbody*)rigidbody;
+	Vector3 normal, v;
+	int i;
+
+	normal = Vec3New(0, 0, 0);
+	Vec3SetElement(&normal, face / 2, face % 2 == 0 ? -1.0f : 1.0f);
+	normal = M3TransformVector(rb->orientation, normal);
+
+	for (i = 0; i < 4; i++)
+	{
+		v = Vec3New(corners[face][i][0] * rb->dimensions.x / 2, corners[face][i][1] * rb->dimensions.y / 2, corners[face][i][2] * rb->dimensions.z / 2);
+		v = Vec3Add(rb->position, M3TransformVector(rb->orientation, v));
+		glNormal3f(normal.x, normal.y, normal.z);
+		glTexCoord2f(corners[face][i][3], corners[face][i][4]);
+		glVertex3f(v.x, v.y, v.z);
+	}
+}
+
+void RenderRigidbodyFlat(const void *rigidbody, int part)
+{
+	const Rigidbody *rb = (const Rigidbody*)rigidbody;
+	Vector3 normal, v;
+	unsigned i;
+	int j, k;
+
+	/* vertices are already in world space - fan out from each face's first vertex */
+	for (i = 0; i < rb->numFaces; i++)
+	{
+		normal = M3TransformVector(rb->orientation, rb->bodyNormals[i]);
+		for (j = 1; j + 1 < rb->shape->numFaceVerts[i]; j++)
+		{
+			glNormal3f(normal.x, normal.y, normal.z);
+			for (k = 0; k < 3; k++)
+			{
+				v = rb->vertices[rb->shape->faces[i][k == 0 ? 0 : j + k - 1]];
+				glVertex3f(v.x, v.y, v.z);
+			}
+		}
+	}
+}
+
+/* twice the signed area of a triangle of floor points, as (x, z), positive if b to c turns
+   towards +z from a to b */
+static float Turn(const float a[2], const float b[2], const float c[2])
+{
+	return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+}
+
+void RenderShadow(const void *rigidbody, int part)
+{
+	const Rigidbody *rb = (const Rigidbody*)rigidbody;
+	float *m = DisplayProperties.shadowMatrix;
+	float points[MAX_VERTS][2], hull[MAX_VERTS + 1][2], x, z, w;
+	Vector3 v;
+	int numPoints = (int)rb->numVerts, numHull = 0, lower, i, j;
+
+	/* project the vertices onto the floor, sorted along x then z */
+	for (i = 0; i < numPoints; i++)
+	{
+		v = rb->vertices[i];
+		w = m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15];
+		if (w <= 0)
+			return;
+		x = (m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12]) / w;
+		z = (m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14]) / w;
+
+		for (j = i; j > 0 && (points[j - 1][0] > x || (points[j - 1][0] == x && points[j - 1][1] > z)); j--)
+		{
+			points[j][0] = points[j - 1][0];
+			points[j][1] = points[j - 1][1];
+		}
+		points[j][0] = x;
+		points[j][1] = z;
+	}
+
+	/* convex hull - one chain along increasing x and one back, dropping points that don't turn */
+	for (i = 0; i < numPoints; i++)
+	{
+		while (numHull >= 2 && Turn(hull[numHull - 2], hull[numHull - 1], points[i]) <= 0)
+			numHull--;
+		hull[numHull][0] = points[i][0];
+		hull[numHull][1] = points[i][1];
+		numHull++;
+	}
+	lower = numHull + 1;
+	for (i = numPoints - 2; i >= 0; i--)
+	{
+		while (numHull >= lower && Turn(hull[numHull - 2], hull[numHull - 1], points[i]) <= 0)
+			numHull--;
+		hull[numHull][0] = points[i][0];
+		hull[numHull][1] = points[i][1];
+		numHull++;
+	}
+
+	/* the last point is the first again */
+	for (i = 1; i + 1 < numHull - 1; i++)
+	{
+		glVertex3f(hull[0][0], 0, hull[0][1]);
+		glVertex3f(hull[i][0], 0, hull[i][1]);
+		glVertex3f(hull[i + 1][0], 0, hull[i + 1][1]);
+	}
+}
+
+void ExitProgram()
+{
+	exit(0);
+}
+
+void SetLighting(Light *light)
+{
+	float view[16];
+	bool viewChanged;
+
+	/* the position is transformed by the view when it's set, so is set again when the view moves */
+	glGetFloatv(GL_MODELVIEW_MATRIX, view);
+	viewChanged = !uploadedLightValid || memcmp(view, uploadedView, sizeof(view)) != 0;
+
+	if (!uploadedLightValid || light->enabled != uploadedLight.enabled)
+	{
+		if (light->enabled)
+			glEnable(GL_LIGHT0);
+		else
+			glDisable(GL_LIGHT0);
+		RenderStats.stateChanges++;
+	}
+
+	if (light->enabled)
+	{
+		float ambientLight[] = { light->ambient.r, light->ambient.b, light->ambient.g, light->ambient.a };
+		float diffuseLight[] = { light->diffuse.r, light->diffuse.b, light->diffuse.g, light->diffuse.a };
+		float specularLight[] = { light->specular.r, light->specular.b, light->specular.g, light->specular.a };
+		float position[] = { light->position.x, light->position.y, light->position.z, light->type };   
+		bool wasEnabled = uploadedLightValid && uploadedLight.enabled;
+
+		if (!wasEnabled || !ColourEqual(light->ambient, uploadedLight.ambient) || !ColourEqual(light->diffuse, uploadedLight.diffuse) || !ColourEqual(light->specular, uploadedLight.specular))
+		{
+			glLightfv(GL_LIGHT0, GL_AMBIENT, ambientLight);
+			glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuseLight);
+			glLightfv(GL_LIGHT0, GL_SPECULAR, specularLight);
+			RenderStats.stateChanges += 3;
+		}
+
+		if (!wasEnabled || viewChanged || light->type != uploadedLight.type || !Vec3Equal(light->position, uploadedLight.position))
+		{
+			glLightfv(GL_LIGHT0, GL_POSITION, position);
+			RenderStats.stateChanges++;
+		}
+	}
+
+	uploadedLight = *light;
+	memcpy(uploadedView, view, sizeof(view));
+	uploadedLightValid = true;
+}
+
+/* prints the window's frame timing since the last call, and the GPU time of the last timed frame */
+static void LogFrameStats()
+{
+	double elapsed = FramePacerTime() - framePacer.statsStart;
+
+	fprintf(stderr, "%.1f fps, frame %.2f ms (max %.2f), longest gap %.2f ms, %d late",
+		framePacer.frames * 1000.0 / elapsed, framePacer.totalFrameTime / framePacer.frames, framePacer.maxFrameTime, framePacer.maxInterval, framePacer.lateFrames);
+	if (passTimersSupported)
+		fprintf(stderr, ", gpu floor %.3f shadows %.3f objects %.3f ms", RenderStats.gpuTime[PASS_FLOOR], RenderStats.gpuTime[PASS_SHADOWS], RenderStats.gpuTime[PASS_OBJECTS]);
+	fprintf(stderr, ", %d draw calls, %d state changes\n", RenderStats.drawCalls, RenderStats.stateChanges);
+
+	FramePacerResetStats(&framePacer);
+}
+
+void GlutTimerCallback(int x)
+{
+	FramePacerBeginFrame(&framePacer);
+
+	/* check if window size has changed */
+	UpdateWindowSize();
+
+	/* call simulation update function via pointer */
+	(*loop)();
+
+	/* set timer for the next frame's deadline, however long this one took */
+	glutTimerFunc(FramePacerEndFrame(&framePacer), GlutTimerCallback, 0);
+
+	if (DisplayProperties.logFrameStats && FramePacerTime() - framePacer.statsStart >= 1000)
+		LogFrameStats();
+}
+
+void UpdateWindowSize()
+{
+	int w, h;
+
+	w = glutGet(GLUT_WINDOW_WIDTH);
+	h = glutGet(GLUT_WINDOW_HEIGHT);
+
+	/* update display if window size has changed */
+	if (DisplayProperties.windowWidth != w || DisplayProperties.windowHeight != h)
+	{
+		DisplayProperties.windowWidth = w;
+		DisplayProperties.windowHeight = h;
+		GraphicsUpdateDisplayProperties();
+	}
+}
@@ -1,159 +1,283 @@
-
-#ifndef GRAPHICS_H
-#define GRAPHICS_H
-
-#include "Scene.h"
-#include "Colour.h"
-#include "Boolean.h"
-#include "Rigidbody.h"
-#include "Light.h"
-
-/**
- * @brief	Defines the display properties used by the rendering system. 
- * @author	Matt Drage
- * @date	11/03/2012
- */
-typedef struct 
-{
-	int FPS;
-	int windowWidth;
-	int windowHeight;
-	char *windowCaption;
-	float fov;
-	float zNear;
-	float zFar;
-	bool fullscreen;
-	Colour clearColour;
-	float shadowMatrix[16]; /* Matrix used to project shadows onto ground plane */
-} DisplayPropertiesType;
-DisplayPropertiesType DisplayProperties;
-
-/**
- * @brief	Stores texture indexes. 
- * @author	Matt Drage
- * @date	11/03/2012
- */
-typedef struct
-{
-	unsigned dice[6];
-	unsigned floor;
-} TexturesType;
-TexturesType Textures;
-
-/**
- * @brief	Defines an type alias for the 'loop' callback function.
- */
-typedef void (*LoopCallbackType)();
-LoopCallbackType loop;
-
-/**
- * @brief	Initializes the rendering system and openGL settings
- * @author	Matt Drage
- * @date	11/03/2012
- */
-void GraphicsInit(char *path);
-
-/**
- * @brief	Starts the simulation loop.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	updateFunction	The update callback function - called every frame of the simulation.
- */
-void GraphicsStartLoop(LoopCallbackType updateFunction);
-
-/**
- * @brief	Updates openGL setting to reflect changes to the display proterties.
- * @details	Call this function after modifying the DisplayProperties struct.
- * @author	Matt Drage
- * @date	11/03/2012
- */
-void GraphicsUpdateDisplayProperties();
-
-/**
- * @brief	Renders the scene.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	scene	The scene to render.
- */
-void RenderScene(Scene *scene);
-
-/**
- * @brief	Renders a rigidbody object.
- * @details	Rigidbody will be textured as a dice.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	rb	The rb to render.
- */
-void RenderRigidbody(Rigidbody *rb);
-
-/**
- * @brief	Closes the simulation.
- * @author	Matt Drage
- * @date	11/03/2012
- */
-void ExitProgram();
-
-/**
- * @brief	Renders the floor plane.
- * @details	Used internally by the Renderer. Floor plane is located at y = 0.
- * @author	Matt Drage
- * @date	11/03/2012
- */
-void RenderFloor();
-
-/**
- * @brief	Creates a shadow matrix to project shadows onto the floor plane.
- * @details	Floor plane is located at y = 0.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	lightPosition	The light position.
- */
-void CreateShadowMatrix(Vector3 lightPosition);
-
-/**
- * @brief	Loads the textures.
- * @details	Used internally by the Renderer.
- * @author	Matt Drage
- * @date	11/03/2012
- */
-void LoadTextures(char *path);
-
-/**
- * @brief	Creates an openGL compatible transform from an orientation matrix and position vector.
- * @details	Used internally by the Renderer.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	orientation	The orientation.
- * @param	position   	The position.
- * @param	transform  	The openGL transform.
- */
-void CreateOpenGLTransform(Matrix3x3 orientation, Vector3 position, float transform[]);
-
-/**
- * @brief	Sets the lighting parameters for rendering.
- * @details	Used internally by the Renderer.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	light	The light.
- */
-void SetLighting(Light *light);
-
-/**
- * @brief	Callback for the glut update timer.
- * @details	Used internally by the Renderer.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	x	Required by GLUT - not used.
- */
-void GlutTimerCallback(int x);
-
-/**
- * @brief	Updates the window size.
- * @details	Used internally by the Renderer. GLUTs resize callback function doesn't work - this
- * 			function manually checks for window resize.
- * @author	Matt Drage
- * @date	11/03/2012
- */
-void UpdateWindowSize();
-
-#endif
+
+#ifndef GRAPHICS_H
+#define GRAPHICS_H
+
+#include "Demo.h"
+#include "Colour.h"
+#include "Boolean.h"
+#include "Rigidbody.h"
+#include "Light.h"
+#include "ImageTGA.h"
+#include "TextureCache.h"
+
+/**
+ * @brief	Defines the display properties used by the rendering system. 
+ * @author	Matt Drage
+ * @date	11/03/2012
+ */
+typedef struct 
+{
+	int FPS;
+	int windowWidth;
+	int windowHeight;
+	char *windowCaption;
+	float fov;
+	float zNear;
+	float zFar;
+	bool fullscreen;
+	bool offscreen;			/* render into a framebuffer object instead of a window */
+	bool logFrameStats;		/* print frame and pass timing to stderr once a second */
+	Colour clearColour;
+	float shadowMatrix[16]; /* Matrix used to project shadows onto ground plane, kept until the light moves */
+} DisplayPropertiesType;
+extern DisplayPropertiesType DisplayProperties;
+
+/**
+ * @brief	Stores texture indexes. 
+ * @author	Matt Drage
+ * @date	11/03/2012
+ */
+typedef struct
+{
+	unsigned dice[6];
+	unsigned floor;
+} TexturesType;
+extern TexturesType Textures;
+
+/**
+ * @brief	Bodies drawn with a smaller radius than this, in pixels, are drawn untextured.
+ */
+extern const float LOD_PIXEL_RADIUS;
+
+/**
+ * @brief	The passes RenderScene times on the GPU.
+ */
+enum RenderPass { PASS_FLOOR = 0, PASS_SHADOWS, PASS_OBJECTS, NUM_RENDER_PASSES };
+typedef enum RenderPass RenderPass;
+
+/**
+ * @brief	Counts of what the last call to RenderScene drew.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+typedef struct
+{
+	int drawCalls;			/* glBegin/glEnd blocks */
+	int bodiesDrawn;		/* bodies drawn, textured or not */
+	int bodiesSimplified;	/* bodies drawn untextured in the batch of distant ones */
+	int bodiesCulled;		/* bodies outside the view, not drawn */
+	int shadowsDrawn;		/* shadows in view */
+	int stateChanges;		/* openGL state and light calls */
+	double gpuTime[NUM_RENDER_PASSES];	/* milliseconds each pass took on the GPU a few frames ago,
+										   -1 until known or without timer query support */
+} RenderStatsType;
+extern RenderStatsType RenderStats;
+
+/**
+ * @brief	Defines an type alias for the 'loop' callback function.
+ */
+typedef void (*LoopCallbackType)();
+extern LoopCallbackType loop;
+
+/**
+ * @brief	Initializes the rendering system and openGL settings
+ * @author	Matt Drage
+ * @date	11/03/2012
+ */
+void GraphicsInit(char *path);
+
+/**
+ * @brief	Initializes the rendering system without opening a window.
+ * @details	Creates a surfaceless EGL context and renders into a framebuffer object of size
+ * 			windowWidth x windowHeight. Use GraphicsCaptureFrame to read back each rendered frame.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param	path	The program path.
+ * @return	true if it succeeds, false if no offscreen context could be created.
+ */
+bool GraphicsInitOffscreen(char *path);
+
+/**
+ * @brief	Writes the last rendered frame to a TGA file.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	filename	The file to write.
+ * @return	true if it succeeds, false if it fails.
+ */
+bool GraphicsCaptureFrame(char *filename);
+
+/**
+ * @brief	Starts the simulation loop.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	updateFunction	The update callback function - called every frame of the simulation.
+ */
+void GraphicsStartLoop(LoopCallbackType updateFunction);
+
+/**
+ * @brief	Updates openGL setting to reflect changes to the display proterties.
+ * @details	Call this function after modifying the DisplayProperties struct.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ */
+void GraphicsUpdateDisplayProperties();
+
+/**
+ * @brief	Renders the scene.
+ * @details	Draws go through a render queue, sorted so draws with the same state and texture are
+ * 			batched together. Bodies and shadows outside the view are skipped, and bodies smaller
+ * 			on screen than LOD_PIXEL_RADIUS are drawn untextured. Updates RenderStats.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param 	demo	The demo to render.
+ */
+void RenderScene(Demo *demo);
+
+/**
+ * @brief	Gives the vertices of one textured face of a box rigidbody, as a quad.
+ * @details	Used internally by the Renderer as a render queue callback. Faces are -x, +x, -y, +y,
+ * 			-z and +z, drawn with the dice textures in the same order.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rigidbody	The rigidbody.
+ * @param 	face	 	The face.
+ */
+void RenderBoxFace(const void *rigidbody, int face);
+
+/**
+ * @brief	Gives the faces of a rigidbody as flat shaded triangles.
+ * @details	Used internally by the Renderer as a render queue callback, for shapes with no dice
+ * 			textures and for distant bodies.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rigidbody	The rigidbody.
+ * @param 	part	 	Not used.
+ */
+void RenderRigidbodyFlat(const void *rigidbody, int part);
+
+/**
+ * @brief	Gives a rigidbody's shadow on the floor as triangles.
+ * @details	Used internally by the Renderer as a render queue callback. The shadow is the outline
+ * 			of the body's vertices projected by DisplayProperties.shadowMatrix, which for a
+ * 			convex body covers the same floor as projecting every face.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rigidbody	The rigidbody whose shadow to render.
+ * @param 	part	 	Not used.
+ */
+void RenderShadow(const void *rigidbody, int part);
+
+/**
+ * @brief	Closes the simulation.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ */
+void ExitProgram();
+
+/**
+ * @brief	Sets the openGL render state and uploads textures.
+ * @details	Used internally by the Renderer. Shared by the window and offscreen initialization.
+ * 			BeginLoadTextures must have been called.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+void InitRenderState();
+
+/**
+ * @brief	Gives the floor plane as a quad.
+ * @details	Used internally by the Renderer as a render queue callback. Floor plane is located at
+ * 			y = 0.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param 	object	Not used.
+ * @param 	part  	Not used.
+ */
+void RenderFloor(const void *object, int part);
+
+/**
+ * @brief	Gives a static mesh as flat shaded triangles.
+ * @details	Used internally by the Renderer as a render queue callback.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	mesh	The StaticMesh.
+ * @param 	part	Not used.
+ */
+void RenderStaticMesh(const void *mesh, int part);
+
+/**
+ * @brief	Creates a shadow matrix to project shadows onto the floor plane.
+ * @details	Floor plane is located at y = 0. RenderScene only calls this when the light moves.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	lightPosition	The light position.
+ */
+void CreateShadowMatrix(Vector3 lightPosition);
+
+/**
+ * @brief	Starts decoding the textures on background threads.
+ * @details	Used internally by the Renderer. Called before the openGL context is created.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param	path	The program path.
+ */
+void BeginLoadTextures(char *path);
+
+/**
+ * @brief	Waits for the textures started by BeginLoadTextures and uploads them.
+ * @details	Used internally by the Renderer. Requires a current openGL context.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+void FinishLoadTextures();
+
+/**
+ * @brief	Creates an openGL texture with mipmaps from an image.
+ * @details	Used internally by the Renderer. Mipmaps are generated on the GPU when supported.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	tga    	The image.
+ * @param 	texture	The texture index.
+ */
+void UploadTexture(ImageTGA *tga, unsigned *texture);
+
+/**
+ * @brief	Creates an openGL texture from a texture cache entry.
+ * @details	Used internally by the Renderer. Every cached mip level is uploaded as is.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache  	The texture cache.
+ * @param 	entry  	The cached texture.
+ * @param 	texture	The texture index.
+ */
+void UploadCachedTexture(TextureCache *cache, TextureCacheEntry *entry, unsigned *texture);
+
+/**
+ * @brief	Sets the lighting parameters for rendering.
+ * @details	Used internally by the Renderer. Only values that changed since the last call are
+ * 			given to openGL, and the position when the view has changed.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param 	light	The light.
+ */
+void SetLighting(Light *light);
+
+/**
+ * @brief	Callback for the glut update timer.
+ * @details	Used internally by the Renderer. Frames are due at a fixed rate from when the loop
+ * 			started, so the timer is set for the next deadline rather than a fixed delay.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	x	Required by GLUT - not used.
+ */
+void GlutTimerCallback(int x);
+
+/**
+ * @brief	Updates the window size.
+ * @details	Used internally by the Renderer. GLUTs resize callback function doesn't work - this
+ * 			function manually checks for window resize.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ */
+void UpdateWindowSize();
+
+#endif
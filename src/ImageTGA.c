@@ -1,183 +1,427 @@
-
-#include "ImageTGA.h"
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-const int RAW_RGB_ENCODING = 2;
-const int RLE_RGB_ENCODING = 10;
-
-bool TGALoad(ImageTGA *tga, char *filename)
-{
-	unsigned long fileSize;
-	unsigned char* data;
-	FILE *file = fopen(filename, "rb");
- 
-	if (!file)
-		return false;
- 
-	/* get file size */
-	fseek(file, 0, SEEK_END);
-	fileSize = ftell(file);
-	fseek(file, 0, SEEK_SET);
- 
-	/* allocate memory */
-	data = (unsigned char*)malloc(fileSize);
- 
-	if (data == NULL)
-	{
-		fclose(file);
-		return false;
-	}
- 
-	/* Read the file into memory */
-	fread(data, fileSize, 1, file);
-	fclose(file);
- 
-	/* Read header data */
-	if(!TGAReadHeader(tga, data))
-		return false;
- 
-	if (tga->encoding == RAW_RGB_ENCODING)
-	{
-		if (!TGALoadRawData(tga, data))
-			return false;
-	}
-	else if (tga->encoding == RLE_RGB_ENCODING)
-	{
-		if (!TGALoadRLEData(tga, data))
-			return false;
-	}
-	else
-		return false;
-
-	/* swap order of colour bytes */
-	TGABGRtoRGB(tga);
-
-	free(data);
-	return true;
-}
-
-bool TGAReadHeader(ImageTGA *tga, unsigned char* data)
-{
-	short x1, y1, x2, y2;
- 
-	if (data == NULL)
-		return false;
- 
-	/* Only read RGB files */
-	if (data[1] != 0)
-		return false;
- 
-	tga->encoding = data[2];    
- 
-	/* Only read Raw and RLE RGB encoded files */
-	if (tga->encoding != 2 && tga->encoding != 10)
-		return false;
- 
-	/* Get width & height */
-	memcpy(&x1, &data[8], 2);
-	memcpy(&y1, &data[10], 2);
-	memcpy(&x2, &data[12], 2);
-	memcpy(&y2, &data[14], 2);
- 
-	tga->width = (x2 - x1);
-	tga->height = (y2 - y1);
- 
-	/* Bits per Pixel */
-	tga->bpp = data[16];
- 
-	tga->imageSize = (tga->width * tga->height * (tga->bpp/8));
- 
-	return true;
-}
-
-bool TGALoadRawData(ImageTGA *tga, unsigned char* data)
-{
-	short offset;
- 	tga->image = (unsigned char*)malloc(tga->imageSize);
- 
-	if (tga->image == NULL)
-		return false;
- 
-	/* Set offset to start of image data (after header) */
-	offset = data[0] + 18;
- 
-	memcpy(tga->image, &data[offset], tga->imageSize);
- 
-	return true;
-}
-
-bool TGALoadRLEData(ImageTGA *tga, unsigned char* data)
-{
-	short offset, pixelSize;
-	unsigned char *cur;
-	unsigned long index = 0;
-	unsigned char numPixels;
-	int i;
- 
-	/* Set offset to start of image data (after header) */
-	offset = data[0] + 18;
- 
-	/* Get pixel size in bytes */
-	pixelSize = tga->bpp/8;
- 
-	/* Set pointer to the beginning of the image data */
-	cur = &data[offset];
- 
-	tga->image = (unsigned char*)malloc(tga->imageSize);
- 
-	if (tga->image == NULL)
-		return false;
- 
-	/* Decode RLE */
-	while (index < tga->imageSize) 
-	{
-		if (*cur & 0x80) /* 10000000 */
-		{
-			/* Get number of repeated pixels */
-			numPixels = *cur - 127;
-			cur++; 
- 
-			/* Repeat the next pixel numPixels times */
-			for (i = 0; i != numPixels; i++, index += pixelSize)
-				memcpy(&tga->image[index], cur, pixelSize);
- 
-			cur += pixelSize;
-		}
-		else /* Raw data segment */
-		{
-			/* Get number of raw pixels */
-			numPixels = *cur + 1; 
-			cur++;
- 
-			for (i = 0; i != numPixels; i++, index += pixelSize, cur += pixelSize)
-				memcpy(&tga->image[index], cur, pixelSize);
-		}
-	}
-	return true;
-}
-
-void TGABGRtoRGB(ImageTGA *tga)
-{
-	unsigned long numPixels;
-	unsigned char *cur;
-	unsigned char temp;
-	short pixelSize;
-	int i;
- 
-	cur = tga->image;
-	numPixels = tga->width * tga->height;
- 
-	/* Get pixel size in bytes */
-	pixelSize = tga->bpp/8;
- 
-	for (i = 0; i != numPixels; i++) 
-	{
-		temp = *cur;		/* Get blue value */
-		*cur = *(cur + 2);  /* Swap red value into first position */
-		*(cur + 2) = temp;  /* Put blue value in last position */
- 
-		cur += pixelSize;
-	}
-}
+
+#include "ImageTGA.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+const int RAW_RGB_ENCODING = 2;
+const int RLE_RGB_ENCODING = 10;
+
+bool TGALoad(ImageTGA *tga, char *filename)
+{
+	unsigned long fileSize;
+	unsigned char* data;
+	FILE *file = fopen(filename, "rb");
+ 
+	tga->image = NULL;
+	tga->mapping = NULL;
+	tga->bgr = false;
+
+	if (!file)
+		return false;
+ 
+	/* get file size */
+	fseek(file, 0, SEEK_END);
+	fileSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+ 
+	/* allocate memory */
+	data = (unsigned char*)malloc(fileSize);
+ 
+	if (data == NULL)
+	{
+		fclose(file);
+		return false;
+	}
+ 
+	/* Read the file into memory */
+	if (fileSize < 18 || fread(data, fileSize, 1, file) != 1)
+	{
+		fclose(file);
+		free(data);
+		return false;
+	}
+	fclose(file);
+ 
+	/* Read header data */
+	if (!TGAReadHeader(tga, data) || !TGADecode(tga, data, fileSize))
+	{
+		free(data);
+		TGAFree(tga);
+		return false;
+	}
+
+	/* swap order of colour bytes */
+	TGABGRtoRGB(tga);
+
+	free(data);
+	return true;
+}
+
+bool TGAMap(ImageTGA *tga, char *filename)
+{
+	struct stat info;
+	unsigned char *data;
+	int file;
+
+	tga->image = NULL;
+	tga->mapping = NULL;
+	tga->bgr = true;
+
+	file = open(filename, O_RDONLY);
+	if (file < 0)
+		return false;
+
+	if (fstat(file, &info) != 0 || info.st_size < 18)
+	{
+		close(file);
+		return false;
+	}
+
+	data = (unsigned char*)mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (data == (unsigned char*)MAP_FAILED)
+		return false;
+
+	if (!TGAReadHeader(tga, data))
+	{
+		munmap(data, info.st_size);
+		return false;
+	}
+
+	if (tga->encoding == RAW_RGB_ENCODING)
+	{
+		/* zero copy - image data is used in place */
+		if ((unsigned long)info.st_size < data[0] + 18 + tga->imageSize)
+		{
+			munmap(data, info.st_size);
+			return false;
+		}
+
+		tga->mapping = data;
+		tga->mappingSize = info.st_size;
+		tga->image = &data[data[0] + 18];
+		return true;
+	}
+
+	/* RLE data is read once front to back - let the kernel read ahead and drop pages behind */
+	madvise(data, info.st_size, MADV_SEQUENTIAL);
+	if (!TGADecode(tga, data, info.st_size))
+	{
+		munmap(data, info.st_size);
+		TGAFree(tga);
+		return false;
+	}
+
+	munmap(data, info.st_size);
+	return true;
+}
+
+void TGAFree(ImageTGA *tga)
+{
+	if (tga->mapping != NULL)
+		munmap(tga->mapping, tga->mappingSize);
+	else
+		free(tga->image);
+
+	tga->image = NULL;
+	tga->mapping = NULL;
+}
+
+bool TGADecode(ImageTGA *tga, unsigned char* data, unsigned long dataSize)
+{
+	if (tga->encoding == RAW_RGB_ENCODING)
+		return TGALoadRawData(tga, data, dataSize);
+	else if (tga->encoding == RLE_RGB_ENCODING)
+		return TGALoadRLEData(tga, data, dataSize);
+
+	return false;
+}
+
+bool TGASave(ImageTGA *tga, char *filename)
+{
+	unsigned char header[18];
+	unsigned char *row;
+	short pixelSize;
+	unsigned long rowSize;
+	int x, y;
+	bool result = true;
+	FILE *file;
+
+	if (tga->bpp != 24 && tga->bpp != 32)
+		return false;
+
+	pixelSize = tga->bpp/8;
+	rowSize = tga->width * pixelSize;
+
+	row = (unsigned char*)malloc(rowSize);
+	if (row == NULL)
+		return false;
+
+	file = fopen(filename, "wb");
+	if (!file)
+	{
+		free(row);
+		return false;
+	}
+
+	/* Uncompressed RGB, bottom-left origin */
+	memset(header, 0, sizeof(header));
+	header[2] = (unsigned char)RAW_RGB_ENCODING;
+	header[12] = (unsigned char)(tga->width & 0xFF);
+	header[13] = (unsigned char)(tga->width >> 8);
+	header[14] = (unsigned char)(tga->height & 0xFF);
+	header[15] = (unsigned char)(tga->height >> 8);
+	header[16] = (unsigned char)tga->bpp;
+	header[17] = (tga->bpp == 32) ? 8 : 0; /* alpha bits */
+
+	if (fwrite(header, sizeof(header), 1, file) != 1)
+		result = false;
+
+	/* Write rows with colour bytes swapped back to BGR order */
+	for (y = 0; y < tga->height && result; y++)
+	{
+		memcpy(row, &tga->image[y * rowSize], rowSize);
+		for (x = 0; x < tga->width; x++)
+		{
+			row[x * pixelSize] = tga->image[y * rowSize + x * pixelSize + 2];
+			row[x * pixelSize + 2] = tga->image[y * rowSize + x * pixelSize];
+		}
+
+		if (fwrite(row, rowSize, 1, file) != 1)
+			result = false;
+	}
+
+	fclose(file);
+	free(row);
+	return result;
+}
+
+bool TGAReadHeader(ImageTGA *tga, unsigned char* data)
+{
+	short x1, y1, x2, y2;
+ 
+	if (data == NULL)
+		return false;
+ 
+	/* Only read RGB files */
+	if (data[1] != 0)
+		return false;
+ 
+	tga->encoding = data[2];    
+ 
+	/* Only read Raw and RLE RGB encoded files */
+	if (tga->encoding != 2 && tga->encoding != 10)
+		return false;
+ 
+	/* Get width & height */
+	memcpy(&x1, &data[8], 2);
+	memcpy(&y1, &data[10], 2);
+	memcpy(&x2, &data[12], 2);
+	memcpy(&y2, &data[14], 2);
+ 
+	tga->width = (x2 - x1);
+	tga->height = (y2 - y1);
+
+	if (tga->width <= 0 || tga->height <= 0)
+		return false;
+ 
+	/* Bits per Pixel */
+	tga->bpp = data[16];
+
+	/* Only read 24 and 32 bit files */
+	if (tga->bpp != 24 && tga->bpp != 32)
+		return false;
+ 
+	tga->imageSize = ((unsigned long)tga->width * tga->height * (tga->bpp/8));
+ 
+	return true;
+}
+
+bool TGALoadRawData(ImageTGA *tga, unsigned char* data, unsigned long dataSize)
+{
+	short offset;
+
+	/* Set offset to start of image data (after header) */
+	offset = data[0] + 18;
+
+	if (dataSize < offset + tga->imageSize)
+		return false;
+
+ 	tga->image = (unsigned char*)malloc(tga->imageSize);
+ 
+	if (tga->image == NULL)
+		return false;
+ 
+	memcpy(tga->image, &data[offset], tga->imageSize);
+ 
+	return true;
+}
+
+bool TGALoadRLEData(ImageTGA *tga, unsigned char* data, unsigned long dataSize)
+{
+	short offset, pixelSize;
+	unsigned char *cur, *end;
+	unsigned long index = 0;
+	unsigned long length;
+	int numPixels;
+ 
+	/* Set offset to start of image data (after header) */
+	offset = data[0] + 18;
+
+	if (dataSize < (unsigned long)offset)
+		return false;
+ 
+	/* Get pixel size in bytes */
+	pixelSize = tga->bpp/8;
+ 
+	/* Set pointer to the beginning and end of the image data */
+	cur = &data[offset];
+	end = &data[dataSize];
+ 
+	tga->image = (unsigned char*)malloc(tga->imageSize);
+ 
+	if (tga->image == NULL)
+		return false;
+ 
+	/* Decode RLE */
+	while (index < tga->imageSize) 
+	{
+		if (cur >= end)
+			return false; /* Truncated file */
+
+		/* Get number of pixels in packet */
+		numPixels = (*cur & 0x7F) + 1;
+		length = numPixels * pixelSize;
+
+		if (length > tga->imageSize - index)
+			return false; /* Packet overruns image */
+
+		if (*cur & 0x80) /* 10000000 */
+		{
+			cur++; 
+			if (end - cur < pixelSize)
+				return false;
+ 
+			/* Repeat the next pixel numPixels times */
+			TGAFillRun(&tga->image[index], cur, pixelSize, numPixels);
+			cur += pixelSize;
+		}
+		else /* Raw data segment */
+		{
+			cur++;
+			if ((unsigned long)(end - cur) < length)
+				return false;
+
+			/* Raw pixels are already contiguous */
+			memcpy(&tga->image[index], cur, length);
+			cur += length;
+		}
+
+		index += length;
+	}
+	return true;
+}
+
+void TGAFillRun(unsigned char *dest, unsigned char *pixel, short pixelSize, int numPixels)
+{
+	/* 48 bytes holds a whole number of 3 and 4 byte pixels */
+	unsigned char pattern[48];
+	unsigned long length = numPixels * pixelSize;
+	int i;
+
+	/* short runs are cheaper pixel by pixel than building the pattern - copies of a constant
+	   size are single moves */
+	if (length < 96)
+	{
+		if (pixelSize == 4)
+			for (i = 0; i < numPixels; i++, dest += 4)
+				memcpy(dest, pixel, 4);
+		else
+			for (i = 0; i < numPixels; i++, dest += 3)
+				memcpy(dest, pixel, 3);
+		return;
+	}
+
+	for (i = 0; i < 48; i += pixelSize)
+		memcpy(&pattern[i], pixel, pixelSize);
+
+	/* fixed size copies compile to wide vector stores */
+	for (; length >= 48; length -= 48, dest += 48)
+		memcpy(dest, pattern, 48);
+
+	memcpy(dest, pattern, length);
+}
+
+void TGABGRtoRGB(ImageTGA *tga)
+{
+	unsigned long numPixels;
+	unsigned char *cur;
+	unsigned char temp;
+	short pixelSize;
+	unsigned long i = 0;
+ 
+	cur = tga->image;
+	numPixels = (unsigned long)tga->width * tga->height;
+ 
+	/* Get pixel size in bytes */
+	pixelSize = tga->bpp/8;
+
+	if (pixelSize == 4)
+	{
+#if defined(__AVX2__)
+		const __m256i swap32 = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+												2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+		for (; i + 8 <= numPixels; i += 8, cur += 32)
+			_mm256_storeu_si256((__m256i*)cur, _mm256_shuffle_epi8(_mm256_loadu_si256((__m256i*)cur), swap32));
+#endif
+#if defined(__SSSE3__)
+		const __m128i swap16 = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+		for (; i + 4 <= numPixels; i += 4, cur += 16)
+			_mm_storeu_si128((__m128i*)cur, _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)cur), swap16));
+#endif
+	}
+	else
+	{
+#if defined(__SSSE3__)
+		/* 16 pixels per 3 registers - pixels straddling registers take a byte from the neighbour */
+		const __m128i a0 = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, -128);
+		const __m128i a1 = _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 1);
+		const __m128i b0 = _mm_setr_epi8(-128, 15, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128);
+		const __m128i b1 = _mm_setr_epi8(0, -128, 4, 3, 2, 7, 6, 5, 10, 9, 8, 13, 12, 11, -128, 15);
+		const __m128i b2 = _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 0, -128);
+		const __m128i c1 = _mm_setr_epi8(14, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128);
+		const __m128i c2 = _mm_setr_epi8(-128, 3, 2, 1, 6, 5, 4, 9, 8, 7, 12, 11, 10, 15, 14, 13);
+		__m128i a, b, c;
+		for (; i + 16 <= numPixels; i += 16, cur += 48)
+		{
+			a = _mm_loadu_si128((__m128i*)cur);
+			b = _mm_loadu_si128((__m128i*)(cur + 16));
+			c = _mm_loadu_si128((__m128i*)(cur + 32));
+			_mm_storeu_si128((__m128i*)cur, _mm_or_si128(_mm_shuffle_epi8(a, a0), _mm_shuffle_epi8(b, a1)));
+			_mm_storeu_si128((__m128i*)(cur + 16), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, b0), _mm_shuffle_epi8(b, b1)), _mm_shuffle_epi8(c, b2)));
+			_mm_storeu_si128((__m128i*)(cur + 32), _mm_or_si128(_mm_shuffle_epi8(b, c1), _mm_shuffle_epi8(c, c2)));
+		}
+#endif
+	}
+ 
+	/* Remaining pixels, or all of them without SIMD support */
+	for (; i < numPixels; i++) 
+	{
+		temp = *cur;		/* Get blue value */
+		*cur = *(cur + 2);  /* Swap red value into first position */
+		*(cur + 2) = temp;  /* Put blue value in last position */
+ 
+		cur += pixelSize;
+	}
+}
@@ -1,78 +1,145 @@
-
-#ifndef IMAGETGA_H
-#define IMAGETGA_H
-
-#include "Boolean.h"
-
-extern const int RAW_RGB_ENCODING;
-extern const int RLE_RGB_ENCODING;
-
-/**
- * @brief	Stores Targa (TGA) image data. 
- * @details	Only supports raw RGB and RLE compressed RBG. 
- * 			Supports 24 or 32 bit images with alpha channel.
- * @author	Matt Drage
- * @date	11/03/2012
- */
-struct ImageTGA
-{
-	short int width, height, bpp;
-	unsigned long imageSize;
-	char encoding;
-	unsigned char *image;
-};
-typedef struct ImageTGA ImageTGA;
-
-/**
- * @brief	Loads a TGA image file.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	tga 	The tga object to store the data in.
- * @param 	file	The file to read.
- * @return	true if it succeeds, false if it fails.
- */
-bool TGALoad(ImageTGA *tga, char *file);
-
-/**
- * @brief	Reads the header metadata of a TGA image.
- * @details	Used internally by TGALoad function.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	tga 	The tga image to store info in.
- * @param 	data	The header data to read from.
- * @return	true if it succeeds, false if it fails.
- */
-bool TGAReadHeader(ImageTGA *tga, unsigned char* data);
-
-/**
- * @brief	Loads raw RGB data from a TGA file.
- * @details	Used internally by TGALoad function.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	tga 	The tga to store the data in.
- * @param 	data	The data to read.
- * @return	true if it succeeds, false if it fails.
- */
-bool TGALoadRawData(ImageTGA *tga, unsigned char* data);
-
-/**
- * @brief	Loads run length encoded data from a TGA file.
- * @details	Used internally by TGALoad function.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	tga 	The tga to store the data in.
- * @param 	data	The data to read.
- * @return	true if it succeeds, false if it fails.
- */
- bool TGALoadRLEData(ImageTGA *tga, unsigned char* data);
-
-/**
- * @brief	Convers TGA image data from BGR to RGB ordering.
- * @details	Used internally by TGALoad function.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	tga		The tga to convert.
- */
-void TGABGRtoRGB(ImageTGA *tga);
-
-#endif
+
+#ifndef IMAGETGA_H
+#define IMAGETGA_H
+
+#include "Boolean.h"
+
+extern const int RAW_RGB_ENCODING;
+extern const int RLE_RGB_ENCODING;
+
+/**
+ * @brief	Stores Targa (TGA) image data. 
+ * @details	Only supports raw RGB and RLE compressed RBG. 
+ * 			Supports 24 or 32 bit images with alpha channel.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ */
+struct ImageTGA
+{
+	short int width, height, bpp;
+	unsigned long imageSize;
+	char encoding;
+	unsigned char *image;
+	bool bgr;						/* pixel data is in the file's BGR(A) order */
+	unsigned char *mapping;			/* memory mapped file, NULL if image was allocated */
+	unsigned long mappingSize;
+};
+typedef struct ImageTGA ImageTGA;
+
+/**
+ * @brief	Loads a TGA image file.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param 	tga 	The tga object to store the data in.
+ * @param 	file	The file to read.
+ * @return	true if it succeeds, false if it fails.
+ */
+bool TGALoad(ImageTGA *tga, char *file);
+
+/**
+ * @brief	Memory maps a TGA image file.
+ * @details	Raw images are not copied or converted - image points directly into the mapped file
+ * 			and pixels are left in BGR(A) order (bgr is set). Upload them with GL_BGR / GL_BGRA.
+ * 			RLE images are decoded straight from the mapping without reading the file into memory,
+ * 			but into one allocated image of width * height * bpp / 8 bytes, so they save the copy of
+ * 			the file and not the memory of the decoded image.
+ * 			Release with TGAFree.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	tga 	The tga object to store the data in.
+ * @param 	file	The file to map.
+ * @return	true if it succeeds, false if it fails.
+ */
+bool TGAMap(ImageTGA *tga, char *file);
+
+/**
+ * @brief	Releases the image data of a TGA loaded with TGALoad or TGAMap.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	tga	The tga to release.
+ */
+void TGAFree(ImageTGA *tga);
+
+/**
+ * @brief	Saves an image as an uncompressed TGA file.
+ * @details	Image data is expected in RGB(A) order, as produced by TGALoad.
+ * 			Only 24 and 32 bit images are supported.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	tga 	The image to save.
+ * @param 	file	The file to write.
+ * @return	true if it succeeds, false if it fails.
+ */
+bool TGASave(ImageTGA *tga, char *file);
+
+/**
+ * @brief	Reads the header metadata of a TGA image.
+ * @details	Used internally by TGALoad function.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param 	tga 	The tga image to store info in.
+ * @param 	data	The header data to read from.
+ * @return	true if it succeeds, false if it fails.
+ */
+bool TGAReadHeader(ImageTGA *tga, unsigned char* data);
+
+/**
+ * @brief	Decodes the image data of a TGA file into a newly allocated image.
+ * @details	Used internally by TGALoad and TGAMap functions.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	tga 	The tga to store the data in. Header must already be read.
+ * @param 	data		The file data.
+ * @param	dataSize	Size of the file data in bytes.
+ * @return	true if it succeeds, false if the data is truncated or malformed.
+ */
+bool TGADecode(ImageTGA *tga, unsigned char* data, unsigned long dataSize);
+
+/**
+ * @brief	Loads raw RGB data from a TGA file.
+ * @details	Used internally by TGALoad function.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param 	tga 		The tga to store the data in.
+ * @param 	data		The data to read.
+ * @param	dataSize	Size of the data in bytes.
+ * @return	true if it succeeds, false if it fails.
+ */
+bool TGALoadRawData(ImageTGA *tga, unsigned char* data, unsigned long dataSize);
+
+/**
+ * @brief	Loads run length encoded data from a TGA file.
+ * @details	Used internally by TGALoad function. Packets that overrun the
+ * 			image or the end of the data are rejected.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param 	tga 		The tga to store the data in.
+ * @param 	data		The data to read.
+ * @param	dataSize	Size of the data in bytes.
+ * @return	true if it succeeds, false if it fails.
+ */
+ bool TGALoadRLEData(ImageTGA *tga, unsigned char* data, unsigned long dataSize);
+
+/**
+ * @brief	Fills a run of repeated pixels.
+ * @details	Used internally by TGALoadRLEData. Long runs are written in 48 byte blocks.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	dest		The destination.
+ * @param 	pixel		The pixel to repeat.
+ * @param	pixelSize	The pixel size in bytes.
+ * @param	numPixels	The number of pixels to write.
+ */
+void TGAFillRun(unsigned char *dest, unsigned char *pixel, short pixelSize, int numPixels);
+
+/**
+ * @brief	Convers TGA image data from BGR to RGB ordering.
+ * @details	Used internally by TGALoad function. Uses SSSE3/AVX2 byte shuffles when
+ * 			compiled with support for them, falling back to a per-pixel swap.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param 	tga		The tga to convert.
+ */
+void TGABGRtoRGB(ImageTGA *tga);
+
+#endif
@@ -0,0 +1,84 @@
+
+#include "InputScript.h"
+#include <string.h>
+
+static void ReadNextEvent(InputScript *script);
+
+bool InputScriptCreate(InputScript *script, char *filename)
+{
+	memset(script, 0, sizeof(InputScript));
+
+	script->file = fopen(filename, "w");
+	if (!script->file)
+		return false;
+
+	script->writing = true;
+	return fprintf(script->file, "# frame action down|up\n") > 0;
+}
+
+bool InputScriptRecord(InputScript *script, int frame, InputEvent event)
+{
+	if (!script->file || !script->writing)
+		return false;
+
+	return fprintf(script->file, "%d %s %s\n", frame, ActionName(event.action), event.pressed ? "down" : "up") > 0;
+}
+
+bool InputScriptOpen(InputScript *script, char *filename)
+{
+	memset(script, 0, sizeof(InputScript));
+
+	script->file = fopen(filename, "r");
+	if (!script->file)
+		return false;
+
+	ReadNextEvent(script);
+	return true;
+}
+
+/* Reads the next valid line of a script being played, or clears hasNext at the end. */
+static void ReadNextEvent(InputScript *script)
+{
+	char line[256], name[64], state[16], start;
+	int fields;
+
+	script->hasNext = false;
+	while (fgets(line, sizeof(line), script->file))
+	{
+		script->line++;
+
+		start = line[strspn(line, " \t")];
+		if (start == '#' || start == '\n' || start == '\r' || start == '\0')
+			continue;
+
+		fields = sscanf(line, "%d %63s %15s", &script->nextFrame, name, state);
+		if (fields == 3 && ActionFromName(name, &script->next.action) && (strcmp(state, "down") == 0 || strcmp(state, "up") == 0))
+		{
+			script->next.pressed = strcmp(state, "down") == 0;
+			script->hasNext = true;
+			return;
+		}
+
+		fprintf(stderr, "Input script line %d not understood: %s", script->line, line);
+	}
+}
+
+bool InputScriptPlay(InputScript *script, int frame, InputQueue *queue)
+{
+	while (script->hasNext && script->nextFrame <= frame)
+	{
+		if (!InputQueuePush(queue, script->next))
+			return true;
+		ReadNextEvent(script);
+	}
+
+	return script->hasNext;
+}
+
+void InputScriptClose(InputScript *script)
+{
+	if (script->file)
+		fclose(script->file);
+
+	memset(script, 0, sizeof(InputScript));
+}
@@ -0,0 +1,85 @@
+/**
+ * @file	InputScript.h
+ * @brief	Records input events to a text file and plays them back on the same frames.
+ */
+
+#ifndef INPUTSCRIPT_H
+#define INPUTSCRIPT_H
+
+#include <stdio.h>
+#include "KeyInput.h"
+#include "Boolean.h"
+
+/**
+ * @brief	A file of input events, each tagged with the frame it happens on.
+ * @details	One event per line: "<frame> <action> down|up", eg. "120 create down", in frame
+ * 			order. Frames count updates from the start of the run. Blank lines and lines
+ * 			starting with # are ignored. Action names are given by ActionName.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct InputScript
+{
+	FILE *file;
+	bool writing;
+	int line;						/* lines read so far, for error messages */
+
+	bool hasNext;					/* false at the end of a script being played */
+	int nextFrame;					/* frame of the next event to play */
+	InputEvent next;
+};
+typedef struct InputScript InputScript;
+
+/**
+ * @brief	Creates an input script file for recording.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	script  	The script.
+ * @param 	filename	The file to write.
+ * @return	true if it succeeds, false if it fails.
+ */
+bool InputScriptCreate(InputScript *script, char *filename);
+
+/**
+ * @brief	Appends an event to a script being recorded.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	script	The script.
+ * @param 	frame 	The frame the event happened on.
+ * @param 	event 	The event.
+ * @return	true if it succeeds, false if it fails.
+ */
+bool InputScriptRecord(InputScript *script, int frame, InputEvent event);
+
+/**
+ * @brief	Opens an input script file for playback.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	script  	The script.
+ * @param 	filename	The file to read.
+ * @return	true if it succeeds, false if the file is missing.
+ */
+bool InputScriptOpen(InputScript *script, char *filename);
+
+/**
+ * @brief	Pushes the events due by a frame to a queue.
+ * @details	Events that don't fit in the queue are pushed by a later call. Lines that can't be
+ * 			read are reported to stderr and skipped.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	script	The script.
+ * @param 	frame 	The current frame.
+ * @param 	queue 	The queue events are pushed to.
+ * @return	false once every event has been pushed.
+ */
+bool InputScriptPlay(InputScript *script, int frame, InputQueue *queue);
+
+/**
+ * @brief	Closes an input script file.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	script	The script.
+ */
+void InputScriptClose(InputScript *script);
+
+#endif
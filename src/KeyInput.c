@@ -1,130 +1,265 @@
-
-#include "KeyInput.h"
-
-#ifdef __APPLE__
-#include <OpenGL/gl.h> 
-#include <GLUT/glut.h>
-#else
-#include <GL/gl.h> 
-#include <GL/glut.h>
-#endif
-
-int keyState[] = { false, false, false, false, false, false, false, false, false, false, false, false };
-
-void KeyInputInit()
-{
-	/* register glut callbacks */
-	glutKeyboardFunc(GlutKeyDownCallback);
-	glutKeyboardUpFunc(GlutKeyUpCallback);
-	glutSpecialFunc(GlutSpecialKeyDownCallback);
-	glutSpecialUpFunc(GlutSpecialKeyUpCallback);
-}
-
-bool KeyDown(Key key)
-{
-	return keyState[key];
-}
-
-void GlutKeyDownCallback(unsigned char k, int x, int y)
-{
-	switch (k)
-	{
-		case 'w':
-			keyState[KEY_W] = true;
-			break;
-		case 'a':
-			keyState[KEY_A] = true;
-			break;
-		case 's':
-			keyState[KEY_S] = true;
-			break;
-		case 'd':
-			keyState[KEY_D] = true;
-			break;
-		case 'c':
-			keyState[KEY_C] = true;
-			break;
-		case '=':
-		case '+':
-			keyState[KEY_PLUS] = true;
-			break;
-		case '-':
-		case '_':
-			keyState[KEY_MINUS] = true;
-			break;
-		case 27:
-			keyState[KEY_ESC] = true;
-			break;
-	}
-}
-
-void GlutKeyUpCallback(unsigned char k, int x, int y)
-{
-	switch (k)
-	{
-		case 'w':
-			keyState[KEY_W] = false;
-			break;
-		case 'a':
-			keyState[KEY_A] = false;
-			break;
-		case 's':
-			keyState[KEY_S] = false;
-			break;
-		case 'd':
-			keyState[KEY_D] = false;
-			break;
-		case 'c':
-			keyState[KEY_C] = false;
-			break;
-		case '=':
-		case '+':
-			keyState[KEY_PLUS] = false;
-			break;
-		case '-':
-		case '_':
-			keyState[KEY_MINUS] = false;
-			break;
-		case 27:
-			keyState[KEY_ESC] = false;
-			break;
-	}
-}
-
-void GlutSpecialKeyDownCallback(int k, int x, int y)
-{
-	switch (k)
-	{
-		case GLUT_KEY_UP:
-			keyState[KEY_UP] = true;
-			break;
-		case GLUT_KEY_DOWN:
-			keyState[KEY_DOWN] = true;
-			break;
-		case GLUT_KEY_LEFT:
-			keyState[KEY_LEFT] = true;
-			break;
-		case GLUT_KEY_RIGHT:
-			keyState[KEY_RIGHT] = true;
-			break;
-	}
-}
-
-void GlutSpecialKeyUpCallback(int k, int x, int y)
-{
-	switch (k)
-	{
-		case GLUT_KEY_UP:
-			keyState[KEY_UP] = false;
-			break;
-		case GLUT_KEY_DOWN:
-			keyState[KEY_DOWN] = false;
-			break;
-		case GLUT_KEY_LEFT:
-			keyState[KEY_LEFT] = false;
-			break;
-		case GLUT_KEY_RIGHT:
-			keyState[KEY_RIGHT] = false;
-			break;
-	}
-}
+
+#include "KeyInput.h"
+#include <string.h>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h> 
+#include <GLUT/glut.h>
+#else
+#include <GL/gl.h> 
+#include <GL/glut.h>
+#endif
+
+static void KeyEvent(Key key, bool pressed);
+
+/* names of actions in input scripts, in Action order */
+static const char *actionNames[NUM_ACTIONS] = { "none", "orbit-left", "orbit-right", "raise-camera", "lower-camera", "create", "more-objects", "fewer-objects", "next-shape", "quit" };
+
+/* the action each key starts and stops, in Key order */
+static Action keyBindings[NUM_KEYS] =
+{
+	ACTION_RAISE_CAMERA,	/* KEY_UP */
+	ACTION_LOWER_CAMERA,	/* KEY_DOWN */
+	ACTION_ORBIT_LEFT,		/* KEY_LEFT */
+	ACTION_ORBIT_RIGHT,		/* KEY_RIGHT */
+	ACTION_RAISE_CAMERA,	/* KEY_W */
+	ACTION_ORBIT_LEFT,		/* KEY_A */
+	ACTION_LOWER_CAMERA,	/* KEY_S */
+	ACTION_ORBIT_RIGHT,		/* KEY_D */
+	ACTION_CREATE,			/* KEY_C */
+	ACTION_MORE_OBJECTS,	/* KEY_PLUS */
+	ACTION_FEWER_OBJECTS,	/* KEY_MINUS */
+	ACTION_NEXT_SHAPE,		/* KEY_N */
+	ACTION_QUIT				/* KEY_ESC */
+};
+
+/* state of the keyboard producer, only used by the glut callbacks */
+static InputQueue *keyQueue = NULL;
+static Action keyActions[NUM_KEYS];	/* action each held key started, ACTION_NONE if it is up */
+
+void InputQueueInit(InputQueue *queue)
+{
+	atomic_init(&queue->head, 0);
+	atomic_init(&queue->tail, 0);
+}
+
+bool InputQueuePush(InputQueue *queue, InputEvent event)
+{
+	unsigned tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+	unsigned head = atomic_load_explicit(&queue->head, memory_order_acquire);
+
+	if (tail - head == INPUT_QUEUE_SIZE)
+		return false;
+
+	/* the release publishes the event before the consumer can see the new tail */
+	queue->events[tail & (INPUT_QUEUE_SIZE - 1)] = event;
+	atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+	return true;
+}
+
+bool InputQueuePop(InputQueue *queue, InputEvent *event)
+{
+	unsigned head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+	unsigned tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+	if (head == tail)
+		return false;
+
+	/* the release stops the producer reusing the slot before it has been read */
+	*event = queue->events[head & (INPUT_QUEUE_SIZE - 1)];
+	atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+	return true;
+}
+
+void InputStateBeginFrame(InputState *state)
+{
+	memset(state->presses, 0, sizeof(state->presses));
+}
+
+void InputStateApply(InputState *state, InputEvent event)
+{
+	if (event.action <= ACTION_NONE || event.action >= NUM_ACTIONS)
+		return;
+
+	if (event.pressed)
+	{
+		state->held[event.action]++;
+		state->presses[event.action]++;
+	}
+	else if (state->held[event.action] > 0)
+		state->held[event.action]--;
+}
+
+bool ActionHeld(InputState *state, Action action)
+{
+	return state->held[action] > 0;
+}
+
+int ActionPresses(InputState *state, Action action)
+{
+	return state->presses[action];
+}
+
+const char *ActionName(Action action)
+{
+	return actionNames[action];
+}
+
+bool ActionFromName(const char *name, Action *action)
+{
+	int i;
+
+	for (i = ACTION_NONE + 1; i < NUM_ACTIONS; i++)
+	{
+		if (strcmp(name, actionNames[i]) == 0)
+		{
+			*action = (Action)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void KeyBind(Key key, Action action)
+{
+	keyBindings[key] = action;
+}
+
+void KeyInputInit(InputQueue *queue)
+{
+	keyQueue = queue;
+	memset(keyActions, 0, sizeof(keyActions));
+
+	/* register glut callbacks */
+	glutKeyboardFunc(GlutKeyDownCallback);
+	glutKeyboardUpFunc(GlutKeyUpCallback);
+	glutSpecialFunc(GlutSpecialKeyDownCallback);
+	glutSpecialUpFunc(GlutSpecialKeyUpCallback);
+}
+
+/* Pushes the bound action when a key changes state - key repeats are ignored. A key stops the
+   action it started, even if it was bound to another since. Its state only changes once the
+   event is queued, so the consumer's held actions always follow the events it was given. */
+static void KeyEvent(Key key, bool pressed)
+{
+	InputEvent event;
+
+	if (keyQueue == NULL || (keyActions[key] != ACTION_NONE) == pressed)
+		return;
+
+	event.action = pressed ? keyBindings[key] : keyActions[key];
+	event.pressed = pressed;
+	if (event.action != ACTION_NONE && InputQueuePush(keyQueue, event))
+		keyActions[key] = pressed ? event.action : ACTION_NONE;
+}
+
+void GlutKeyDownCallback(unsigned char k, int x, int y)
+{
+	switch (k)
+	{
+		case 'w':
+			KeyEvent(KEY_W, true);
+			break;
+		case 'a':
+			KeyEvent(KEY_A, true);
+			break;
+		case 's':
+			KeyEvent(KEY_S, true);
+			break;
+		case 'd':
+			KeyEvent(KEY_D, true);
+			break;
+		case 'c':
+			KeyEvent(KEY_C, true);
+			break;
+		case 'n':
+			KeyEvent(KEY_N, true);
+			break;
+		case '=':
+		case '+':
+			KeyEvent(KEY_PLUS, true);
+			break;
+		case '-':
+		case '_':
+			KeyEvent(KEY_MINUS, true);
+			break;
+		case 27:
+			KeyEvent(KEY_ESC, true);
+			break;
+	}
+}
+
+void GlutKeyUpCallback(unsigned char k, int x, int y)
+{
+	switch (k)
+	{
+		case 'w':
+			KeyEvent(KEY_W, false);
+			break;
+		case 'a':
+			KeyEvent(KEY_A, false);
+			break;
+		case 's':
+			KeyEvent(KEY_S, false);
+			break;
+		case 'd':
+			KeyEvent(KEY_D, false);
+			break;
+		case 'c':
+			KeyEvent(KEY_C, false);
+			break;
+		case 'n':
+			KeyEvent(KEY_N, false);
+			break;
+		case '=':
+		case '+':
+			KeyEvent(KEY_PLUS, false);
+			break;
+		case '-':
+		case '_':
+			KeyEvent(KEY_MINUS, false);
+			break;
+		case 27:
+			KeyEvent(KEY_ESC, false);
+			break;
+	}
+}
+
+void GlutSpecialKeyDownCallback(int k, int x, int y)
+{
+	switch (k)
+	{
+		case GLUT_KEY_UP:
+			KeyEvent(KEY_UP, true);
+			break;
+		case GLUT_KEY_DOWN:
+			KeyEvent(KEY_DOWN, true);
+			break;
+		case GLUT_KEY_LEFT:
+			KeyEvent(KEY_LEFT, true);
+			break;
+		case GLUT_KEY_RIGHT:
+			KeyEvent(KEY_RIGHT, true);
+			break;
+	}
+}
+
+void GlutSpecialKeyUpCallback(int k, int x, int y)
+{
+	switch (k)
+	{
+		case GLUT_KEY_UP:
+			KeyEvent(KEY_UP, false);
+			break;
+		case GLUT_KEY_DOWN:
+			KeyEvent(KEY_DOWN, false);
+			break;
+		case GLUT_KEY_LEFT:
+			KeyEvent(KEY_LEFT, false);
+			break;
+		case GLUT_KEY_RIGHT:
+			KeyEvent(KEY_RIGHT, false);
+			break;
+	}
+}
@@ -1,72 +1,222 @@
-
-#ifndef KEYINPUT_H
-#define KEYINPUT_H
-
-#include "Boolean.h"
-
-/**
- * @brief	Values that represent Keys. 
- */
-enum Key { KEY_UP = 0, KEY_DOWN, KEY_LEFT, KEY_RIGHT, KEY_W, KEY_A, KEY_S, KEY_D, KEY_C, KEY_PLUS, KEY_MINUS, KEY_ESC };
-typedef enum Key Key;
-
-///< Stores the state of each key.
-extern int keyState[];
-
-/**
- * @brief	Initialized keyboard input.
- * @author	Matt Drage
- * @date	11/03/2012
- */
-void KeyInputInit();
-
-/**
- * @brief	Gets whether a key is currently being pressed.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	key	The key to check.
- * @return	true if key is pressed, false if not.
- */
-bool KeyDown(Key key);
-
-/**
- * @brief	Glut key down callback function.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	k	The key.
- * @param	x	The mouse x coordinate - required by glut.
- * @param	y	The mouse y coordinate - required by glut.
- */
-void GlutKeyDownCallback(unsigned char k, int x, int y);
-
-/**
- * @brief	Glut key up callback function.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	k	The key.
- * @param	x	The mouse x coordinate - required by glut.
- * @param	y	The mouse y coordinate - required by glut.
- */
-void GlutKeyUpCallback(unsigned char k, int x, int y);
-
-/**
- * @brief	Glut special key down callback function.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	k	The key.
- * @param	x	The mouse x coordinate - required by glut.
- * @param	y	The mouse y coordinate - required by glut.
- */
-void GlutSpecialKeyDownCallback(int k, int x, int y);
-
-/**
- * @brief	Glut special key up callback function.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	k	The key.
- * @param	x	The mouse x coordinate - required by glut.
- * @param	y	The mouse y coordinate - required by glut.
- */
-void GlutSpecialKeyUpCallback(int k, int x, int y);
-
-#endif
+
+#ifndef KEYINPUT_H
+#define KEYINPUT_H
+
+#include "Boolean.h"
+#include <stdatomic.h>
+
+/**
+ * @brief	Values that represent Keys.
+ */
+enum Key { KEY_UP = 0, KEY_DOWN, KEY_LEFT, KEY_RIGHT, KEY_W, KEY_A, KEY_S, KEY_D, KEY_C, KEY_PLUS, KEY_MINUS, KEY_N, KEY_ESC, NUM_KEYS };
+typedef enum Key Key;
+
+/**
+ * @brief	Values that represent what keys do.
+ */
+enum Action
+{
+	ACTION_NONE = 0,
+	ACTION_ORBIT_LEFT,
+	ACTION_ORBIT_RIGHT,
+	ACTION_RAISE_CAMERA,
+	ACTION_LOWER_CAMERA,
+	ACTION_CREATE,
+	ACTION_MORE_OBJECTS,
+	ACTION_FEWER_OBJECTS,
+	ACTION_NEXT_SHAPE,
+	ACTION_QUIT,
+	NUM_ACTIONS
+};
+typedef enum Action Action;
+
+/**
+ * @brief	Defines the number of events an input queue holds. A power of two.
+ */
+enum { INPUT_QUEUE_SIZE = 256 };
+
+/**
+ * @brief	An action starting or stopping.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct InputEvent
+{
+	Action action;
+	bool pressed;					/* true when a key for the action goes down, false when it comes up */
+};
+typedef struct InputEvent InputEvent;
+
+/**
+ * @brief	A lock-free queue of input events from one producer to one consumer.
+ * @details	The producer (eg. the glut callbacks or a script) and the consumer (the frame
+ * 			update) may be on different threads without locking.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct InputQueue
+{
+	InputEvent events[INPUT_QUEUE_SIZE];
+	atomic_uint head;				/* next event to read, only written by the consumer */
+	atomic_uint tail;				/* next event to write, only written by the producer */
+};
+typedef struct InputQueue InputQueue;
+
+/**
+ * @brief	The actions in progress, as seen by one frame.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct InputState
+{
+	int held[NUM_ACTIONS];			/* keys held down for each action */
+	int presses[NUM_ACTIONS];		/* times each action started this frame */
+};
+typedef struct InputState InputState;
+
+/**
+ * @brief	Empties an input queue.
+ * @details	Not thread safe - call before anything pushes to the queue.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	queue	The queue.
+ */
+void InputQueueInit(InputQueue *queue);
+
+/**
+ * @brief	Adds an event to the end of the queue. Only call from the producer.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	queue	The queue.
+ * @param 	event	The event.
+ * @return	false if the queue is full - the event is dropped.
+ */
+bool InputQueuePush(InputQueue *queue, InputEvent event);
+
+/**
+ * @brief	Takes the event from the front of the queue. Only call from the consumer.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	queue	The queue.
+ * @param 	event	Set to the event.
+ * @return	false if the queue is empty.
+ */
+bool InputQueuePop(InputQueue *queue, InputEvent *event);
+
+/**
+ * @brief	Starts a new frame of input - presses of the last frame are forgotten.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	state	The input state.
+ */
+void InputStateBeginFrame(InputState *state);
+
+/**
+ * @brief	Updates an input state with an event.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	state	The input state.
+ * @param 	event	The event.
+ */
+void InputStateApply(InputState *state, InputEvent event);
+
+/**
+ * @brief	Gets whether any key for an action is being held down.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	state 	The input state.
+ * @param 	action	The action.
+ * @return	true if the action is in progress.
+ */
+bool ActionHeld(InputState *state, Action action);
+
+/**
+ * @brief	Gets how many times an action started this frame.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	state 	The input state.
+ * @param 	action	The action.
+ * @return	Number of presses.
+ */
+int ActionPresses(InputState *state, Action action);
+
+/**
+ * @brief	Gets the name of an action, as used in input scripts.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	action	The action.
+ * @return	The name.
+ */
+const char *ActionName(Action action);
+
+/**
+ * @brief	Finds an action by name.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	name  	The name.
+ * @param 	action	Set to the action.
+ * @return	false if no action has the name.
+ */
+bool ActionFromName(const char *name, Action *action);
+
+/**
+ * @brief	Makes a key start and stop an action.
+ * @details	Each key has one action, ACTION_NONE if it does nothing. Not thread safe - call
+ * 			before KeyInputInit.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	key   	The key.
+ * @param 	action	The action.
+ */
+void KeyBind(Key key, Action action);
+
+/**
+ * @brief	Initialized keyboard input.
+ * @details	Key presses and releases are pushed to the queue as the actions they are bound to.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	queue	The queue keyboard events are added to.
+ */
+void KeyInputInit(InputQueue *queue);
+
+/**
+ * @brief	Glut key down callback function.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	k	The key.
+ * @param	x	The mouse x coordinate - required by glut.
+ * @param	y	The mouse y coordinate - required by glut.
+ */
+void GlutKeyDownCallback(unsigned char k, int x, int y);
+
+/**
+ * @brief	Glut key up callback function.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	k	The key.
+ * @param	x	The mouse x coordinate - required by glut.
+ * @param	y	The mouse y coordinate - required by glut.
+ */
+void GlutKeyUpCallback(unsigned char k, int x, int y);
+
+/**
+ * @brief	Glut special key down callback function.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	k	The key.
+ * @param	x	The mouse x coordinate - required by glut.
+ * @param	y	The mouse y coordinate - required by glut.
+ */
+void GlutSpecialKeyDownCallback(int k, int x, int y);
+
+/**
+ * @brief	Glut special key up callback function.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	k	The key.
+ * @param	x	The mouse x coordinate - required by glut.
+ * @param	y	The mouse y coordinate - required by glut.
+ */
+void GlutSpecialKeyUpCallback(int k, int x, int y);
+
+#endif
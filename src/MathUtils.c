@@ -1,43 +1,118 @@
-
-#include "MathUtils.h"
-#include <math.h>
-#include <stdlib.h>
-#include <time.h>
-
-const float PI = 3.14159265f;
-
-float DegToRad(float degrees)
-{
-	return degrees / 180.0f * PI;
-}
-
-float RadToDeg(float radians)
-{
-	return radians * 180.0f / PI;
-}
-
-void InitRandomGeneration()
-{
-	srand((unsigned)time(NULL));
-}
-
-int GetRandomInt(int min, int max)
-{
-	return rand() % (max - min + 1) + min;
-}
-
-float GetRandomFloat(float min, float max)
-{
-	float r = (float)rand() / (float)RAND_MAX;
-	return r * (max - min) + min;
-}
-
-float Min(float a, float b)
-{
-	return a < b ? a : b;
-}
-
-float Max(float a, float b)
-{
-	return a > b ? a : b;
-}
+
+#include "MathUtils.h"
+#include <math.h>
+#include <stdlib.h>
+
+const float PI = 3.14159265f;
+
+/* advance a xorshift32 generator */
+static unsigned NextRandom(Random *random)
+{
+	random->state ^= random->state << 13;
+	random->state ^= random->state >> 17;
+	random->state ^= random->state << 5;
+	return random->state;
+}
+
+float DegToRad(float degrees)
+{
+	return degrees / 180.0f * PI;
+}
+
+float RadToDeg(float radians)
+{
+	return radians * 180.0f / PI;
+}
+
+void InitRandomGenerationSeed(Random *random, unsigned seed)
+{
+	/* scramble so that nearby seeds start far apart */
+	random->state = (seed ^ 0x9E3779B9u) * 2654435761u;
+	if (random->state == 0)
+		random->state = 2463534242u;
+	NextRandom(random);
+}
+
+int GetRandomInt(Random *random, int min, int max)
+{
+	return (int)(NextRandom(random) % (unsigned)(max - min + 1)) + min;
+}
+
+float GetRandomFloat(Random *random, float min, float max)
+{
+	/* 24 bits fit exactly in a float, so r is in [0, 1) with no rounding */
+	float r = (float)(NextRandom(random) >> 8) * (1.0f / 16777216.0f);
+	return r * (max - min) + min;
+}
+
+#ifdef DETERMINISTIC
+
+/* reduce an angle to [-PI, PI] - 2 PI is split in two so the reduction stays accurate for a few turns */
+static float ReduceAngle(float radians)
+{
+	const float twoPiHigh = 6.28125f;				/* exact in 8 bits */
+	const float twoPiLow = 1.9353071795864769e-3f;	/* 2 PI - twoPiHigh */
+	float turns = radians * 0.15915494309189535f;
+	float k = (float)(int)(turns < 0 ? turns - 0.5f : turns + 0.5f);
+
+	return (radians - k * twoPiHigh) - k * twoPiLow;
+}
+
+/* sine series to x^11 on [-PI/2, PI/2], error is below float precision */
+static float SinPolynomial(float x)
+{
+	float x2 = x * x;
+	float p = ((((-2.5052108385e-8f * x2 + 2.7557319224e-6f) * x2 - 1.9841269841e-4f) * x2 + 8.3333333333e-3f) * x2 - 1.6666666667e-1f) * x2;
+
+	return x + x * p;
+}
+
+float Sin(float radians)
+{
+	const float halfPi = 1.57079632679f;
+	float x = ReduceAngle(radians);
+
+	/* fold into [-PI/2, PI/2] using sin(PI - x) = sin(x) */
+	if (x > halfPi)
+		x = PI - x;
+	else if (x < -halfPi)
+		x = -PI - x;
+
+	return SinPolynomial(x);
+}
+
+float Cos(float radians)
+{
+	const float halfPi = 1.57079632679f;
+	float x = ReduceAngle(radians);
+
+	/* cos(x) = sin(PI/2 - |x|) */
+	if (x < 0)
+		x = -x;
+
+	return SinPolynomial(halfPi - x);
+}
+
+#else
+
+float Sin(float radians)
+{
+	return (float)sin(radians);
+}
+
+float Cos(float radians)
+{
+	return (float)cos(radians);
+}
+
+#endif
+
+float Min(float a, float b)
+{
+	return a < b ? a : b;
+}
+
+float Max(float a, float b)
+{
+	return a > b ? a : b;
+}
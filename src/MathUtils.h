@@ -1,77 +1,117 @@
-
-/**
- * @file	MathUtils.h
- * @brief	Declares mathematics utilities functions.
- */
-
-#ifndef MATHUTILS_H
-#define MATHUTILS_H
-
-const float PI;
-
-/**
- * @brief	Converts degrees to radians.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	degrees	The degrees.
- * @return	The angle in radians.
- */
-float DegToRad(float degrees);
-
-/**
- * @brief	Converts radians to degrees.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	radians	The radians.
- * @return	The angle in degrees.
- */
-float RadToDeg(float radians);
-
-/**
- * @brief	Initialises the random generation seed.
- * @author	Matt Drage
- * @date	11/03/2012
- */
-void InitRandomGeneration();
-
-/**
- * @brief	Gets a random integer between min and max.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	min	The minimum.
- * @param	max	The maximum.
- * @return	The random int.
- */
-int GetRandomInt(int min, int max);
-
-/**
- * @brief	Gets a random float between min and max.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	min	The minimum.
- * @param	max	The maximum.
- * @return	The random float.
- */
-float GetRandomFloat(float min, float max);
-
-/**
- * @brief	Determines the minimum of the given parameters.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	a	The first parameter to compare.
- * @param	b	The second parameter to compare.
- * @return	The minimum value.
- */
-float Min(float a, float b);
-
-/**
- * @brief	Determines the maximum of the given parameters.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	a	The first parameter to compare.
- * @param	b	The second parameter to compare.
- * @return	The maximum value.
- */
-float Max(float a, float b);
-
-#endif
+
+/**
+ * @file	MathUtils.h
+ * @brief	Declares mathematics utilities functions.
+ */
+
+#ifndef MATHUTILS_H
+#define MATHUTILS_H
+
+extern const float PI;
+
+/**
+ * @brief	Converts degrees to radians.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	degrees	The degrees.
+ * @return	The angle in radians.
+ */
+float DegToRad(float degrees);
+
+/**
+ * @brief	Converts radians to degrees.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	radians	The radians.
+ * @return	The angle in degrees.
+ */
+float RadToDeg(float radians);
+
+/**
+ * @brief	A random number generator.
+ * @details	Each user has its own, so sequences are never shared between threads or scenes. The
+ * 			generator does not use the C library, so a seed gives the same sequence on every
+ * 			platform.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct Random
+{
+	unsigned state;				/* xorshift32 state - never zero */
+};
+typedef struct Random Random;
+
+/**
+ * @brief	Initialises a random generator with a seed.
+ * @details	Use the same seed to reproduce the same sequence of random values.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param	random	The generator.
+ * @param	seed	The seed.
+ */
+void InitRandomGenerationSeed(Random *random, unsigned seed);
+
+/**
+ * @brief	Gets a random integer between min and max.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	random	The generator.
+ * @param	min		The minimum.
+ * @param	max		The maximum.
+ * @return	The random int.
+ */
+int GetRandomInt(Random *random, int min, int max);
+
+/**
+ * @brief	Gets a random float between min and max.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	random	The generator.
+ * @param	min		The minimum.
+ * @param	max		The maximum.
+ * @return	The random float.
+ */
+float GetRandomFloat(Random *random, float min, float max);
+
+/**
+ * @brief	Calculates the sine of an angle.
+ * @details	Built with DETERMINISTIC this uses a fixed polynomial evaluated in single precision
+ * 			instead of libm, so every build and platform gives the same bits.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param	radians	The angle in radians.
+ * @return	The sine.
+ */
+float Sin(float radians);
+
+/**
+ * @brief	Calculates the cosine of an angle.
+ * @details	See Sin.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param	radians	The angle in radians.
+ * @return	The cosine.
+ */
+float Cos(float radians);
+
+/**
+ * @brief	Determines the minimum of the given parameters.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	a	The first parameter to compare.
+ * @param	b	The second parameter to compare.
+ * @return	The minimum value.
+ */
+float Min(float a, float b);
+
+/**
+ * @brief	Determines the maximum of the given parameters.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	a	The first parameter to compare.
+ * @param	b	The second parameter to compare.
+ * @return	The maximum value.
+ */
+float Max(float a, float b);
+
+#endif
@@ -1,148 +1,234 @@
-
-#include "Matrix3x3.h"
-#include "MathUtils.h"
-#include <math.h>
-
-Matrix3x3 M3New()
-{
-	Matrix3x3 m;
-	int i, j;
-
-	for (i = 0; i < 3; i++)
-		for (j = 0; j < 3; j++)
-			m.elements[i][j] = 0;
-
-    m.elements[0][0] = 1;
-	m.elements[1][1] = 1;
-	m.elements[2][2] = 1;
-
-	return m;
-}
-
-Vector3 M3TransformVector(Matrix3x3 m, Vector3 v)
-{
-	Vector3 result = Vec3New(0, 0, 0);
-	int i, j;
-	float value;
-
-	for (i = 0; i < 3; i++)
-    {
-        value = 0;
-      
-        for (j = 0; j < 3; j++)
-            value += m.elements[i][j] * Vec3GetElement(&v, j);
-
-		Vec3SetElement(&result, i, value);
-    }
-
-	return result;
-}
-
-Matrix3x3 M3Mult(Matrix3x3 a, Matrix3x3 b)
-{
-	Matrix3x3 result;
-	int i, j, k;
-	float value;
-
-	for (i = 0; i < 3; i++)
-    {
-        for(j = 0; j < 3; j++)
-        {
-            value = 0;
-          
-            for (k = 0; k < 3; k++)
-                value += a.elements[i][k] * b.elements[k][j];
-
-			result.elements[i][j] = value;
-        }
-    }
-
-	return result;
-}
-
-Matrix3x3 M3SkewSymetricFromVector(Vector3 v)
-{
-	Matrix3x3 m;
-
-	m.elements[0][0] = 0;		m.elements[0][1] = -v.z;	m.elements[0][2] = v.y;
-	m.elements[1][0] = v.z;		m.elements[1][1] = 0;		m.elements[1][2] = -v.x;
-	m.elements[2][0] = -v.y;	m.elements[2][1] =  v.x;	m.elements[2][2] = 0;
-
-	return m;
-}
-
-Matrix3x3 M3Scale(Matrix3x3 m, float operand)
-{
-	int i, j;
-	
-	for (i = 0; i < 3; i++)
-        for(j = 0; j < 3; j++)
-			m.elements[i][j] *= operand;
-
-	return m;
-}
-
-Matrix3x3 M3Add(Matrix3x3 a, Matrix3x3 b)
-{
-	int i, j;
-	
-	for (i = 0; i < 3; i++)
-        for(j = 0; j < 3; j++)
-			a.elements[i][j] += b.elements[i][j];
-
-	return a;
-}
-
-Matrix3x3 M3Orthonormalize(Matrix3x3 m)
-{
-	Vector3 x, y, z;
-
-	x = Vec3New(m.elements[0][0], m.elements[1][0], m.elements[2][0]);
-	y = Vec3New(m.elements[0][1], m.elements[1][1], m.elements[2][1]);
-
-    x = Vec3Normalize(x);
-	z = Vec3Normalize(Vec3Cross(x, y));
-    y = Vec3Normalize(Vec3Cross(z, x));
-
-	m.elements[0][0] = x.x;		m.elements[0][1] = y.x;		m.elements[0][2] = z.x;
-	m.elements[1][0] = x.y;		m.elements[1][1] = y.y;		m.elements[1][2] = z.y;
-	m.elements[2][0] = x.z;		m.elements[2][1] = y.z;		m.elements[2][2] = z.z;
-
-	return m;
-}
-
-Matrix3x3 M3Transpose(Matrix3x3 m)
-{
-	Matrix3x3 transposed;
-	int i, j;
-
-    for (i = 0; i < 3; i++)
-		for (j = 0; j < 3; j++)
-			transposed.elements[j][i] = m.elements[i][j];
-        
-    return transposed;
-}
-
-Matrix3x3 M3FromEuler(Vector3 euler)
-{
-	Matrix3x3 X, Y, Z;
-	float x, y, z;
-
-	x = DegToRad(euler.x);
-	y = DegToRad(euler.y);
-	z = DegToRad(euler.z);
-
-	Y.elements[0][0] = (float)cos(y);	Y.elements[0][1] = 0;				Y.elements[0][2] = (float)sin(y);
-	Y.elements[1][0] = 0;				Y.elements[1][1] = 1;				Y.elements[1][2] = 0;
-	Y.elements[2][0] = (float)-sin(y);	Y.elements[2][1] = 0;				Y.elements[2][2] = (float)cos(y);
-
-	X.elements[0][0] = 1;				X.elements[0][1] = 0;				X.elements[0][2] = 0;
-	X.elements[1][0] = 0;				X.elements[1][1] = (float)cos(x);	X.elements[1][2] = (float)-sin(x);
-	X.elements[2][0] = 0;				X.elements[2][1] = (float)sin(x);	X.elements[2][2] = (float)cos(x);
-
-	Z.elements[0][0] = (float)cos(z);	Z.elements[0][1] = (float)-sin(z);	Z.elements[0][2] = 0;
-	Z.elements[1][0] = (float)sin(z);	Z.elements[1][1] = (float)cos(z);	Z.elements[1][2] = 0;
-	Z.elements[2][0] = 0;				Z.elements[2][1] = 0;				Z.elements[2][2] = 1;
-
-	return M3Mult(M3Mult(Y, X), Z);
-}
+
+#include "Matrix3x3.h"
+#include "MathUtils.h"
+#include <math.h>
+
+Matrix3x3 M3New()
+{
+	Matrix3x3 m;
+	int i, j;
+
+	for (i = 0; i < 3; i++)
+		for (j = 0; j < 3; j++)
+			m.elements[i][j] = 0;
+
+    m.elements[0][0] = 1;
+	m.elements[1][1] = 1;
+	m.elements[2][2] = 1;
+
+	return m;
+}
+
+Vector3 M3TransformVector(Matrix3x3 m, Vector3 v)
+{
+	Vector3 result = Vec3New(0, 0, 0);
+	int i, j;
+	float value;
+
+	for (i = 0; i < 3; i++)
+    {
+        value = 0;
+      
+        for (j = 0; j < 3; j++)
+            value += m.elements[i][j] * Vec3GetElement(&v, j);
+
+		Vec3SetElement(&result, i, value);
+    }
+
+	return result;
+}
+
+Matrix3x3 M3Mult(Matrix3x3 a, Matrix3x3 b)
+{
+	Matrix3x3 result;
+	int i, j, k;
+	float value;
+
+	for (i = 0; i < 3; i++)
+    {
+        for(j = 0; j < 3; j++)
+        {
+            value = 0;
+          
+            for (k = 0; k < 3; k++)
+                value += a.elements[i][k] * b.elements[k][j];
+
+			result.elements[i][j] = value;
+        }
+    }
+
+	return result;
+}
+
+Matrix3x3 M3SkewSymetricFromVector(Vector3 v)
+{
+	Matrix3x3 m;
+
+	m.elements[0][0] = 0;		m.elements[0][1] = -v.z;	m.elements[0][2] = v.y;
+	m.elements[1][0] = v.z;		m.elements[1][1] = 0;		m.elements[1][2] = -v.x;
+	m.elements[2][0] = -v.y;	m.elements[2][1] =  v.x;	m.elements[2][2] = 0;
+
+	return m;
+}
+
+Matrix3x3 M3Scale(Matrix3x3 m, float operand)
+{
+	int i, j;
+	
+	for (i = 0; i < 3; i++)
+        for(j = 0; j < 3; j++)
+			m.elements[i][j] *= operand;
+
+	return m;
+}
+
+Matrix3x3 M3Add(Matrix3x3 a, Matrix3x3 b)
+{
+	int i, j;
+	
+	for (i = 0; i < 3; i++)
+        for(j = 0; j < 3; j++)
+			a.elements[i][j] += b.elements[i][j];
+
+	return a;
+}
+
+Matrix3x3 M3Orthonormalize(Matrix3x3 m)
+{
+	Vector3 x, y, z;
+
+	x = Vec3New(m.elements[0][0], m.elements[1][0], m.elements[2][0]);
+	y = Vec3New(m.elements[0][1], m.elements[1][1], m.elements[2][1]);
+
+    x = Vec3Normalize(x);
+	z = Vec3Normalize(Vec3Cross(x, y));
+    y = Vec3Normalize(Vec3Cross(z, x));
+
+	m.elements[0][0] = x.x;		m.elements[0][1] = y.x;		m.elements[0][2] = z.x;
+	m.elements[1][0] = x.y;		m.elements[1][1] = y.y;		m.elements[1][2] = z.y;
+	m.elements[2][0] = x.z;		m.elements[2][1] = y.z;		m.elements[2][2] = z.z;
+
+	return m;
+}
+
+Matrix3x3 M3Transpose(Matrix3x3 m)
+{
+	Matrix3x3 transposed;
+	int i, j;
+
+    for (i = 0; i < 3; i++)
+		for (j = 0; j < 3; j++)
+			transposed.elements[j][i] = m.elements[i][j];
+        
+    return transposed;
+}
+
+Matrix3x3 M3Inverse(Matrix3x3 m)
+{
+	Matrix3x3 inverse;
+	float (*e)[3] = m.elements;
+	float determinant;
+
+	/* adjugate (transposed cofactors) divided by the determinant */
+	inverse.elements[0][0] = e[1][1] * e[2][2] - e[1][2] * e[2][1];
+	inverse.elements[0][1] = e[0][2] * e[2][1] - e[0][1] * e[2][2];
+	inverse.elements[0][2] = e[0][1] * e[1][2] - e[0][2] * e[1][1];
+	inverse.elements[1][0] = e[1][2] * e[2][0] - e[1][0] * e[2][2];
+	inverse.elements[1][1] = e[0][0] * e[2][2] - e[0][2] * e[2][0];
+	inverse.elements[1][2] = e[0][2] * e[1][0] - e[0][0] * e[1][2];
+	inverse.elements[2][0] = e[1][0] * e[2][1] - e[1][1] * e[2][0];
+	inverse.elements[2][1] = e[0][1] * e[2][0] - e[0][0] * e[2][1];
+	inverse.elements[2][2] = e[0][0] * e[1][1] - e[0][1] * e[1][0];
+
+	determinant = e[0][0] * inverse.elements[0][0] + e[0][1] * inverse.elements[1][0] + e[0][2] * inverse.elements[2][0];
+
+	return M3Scale(inverse, 1.0f / determinant);
+}
+
+Matrix3x3 M3OuterProduct(Vector3 a, Vector3 b)
+{
+	Matrix3x3 m;
+
+	m.elements[0][0] = a.x * b.x;	m.elements[0][1] = a.x * b.y;	m.elements[0][2] = a.x * b.z;
+	m.elements[1][0] = a.y * b.x;	m.elements[1][1] = a.y * b.y;	m.elements[1][2] = a.y * b.z;
+	m.elements[2][0] = a.z * b.x;	m.elements[2][1] = a.z * b.y;	m.elements[2][2] = a.z * b.z;
+
+	return m;
+}
+
+Matrix3x3 M3FromEuler(Vector3 euler)
+{
+	Matrix3x3 X, Y, Z;
+	float x, y, z;
+
+	x = DegToRad(euler.x);
+	y = DegToRad(euler.y);
+	z = DegToRad(euler.z);
+
+	Y.elements[0][0] = Cos(y);	Y.elements[0][1] = 0;		Y.elements[0][2] = Sin(y);
+	Y.elements[1][0] = 0;		Y.elements[1][1] = 1;		Y.elements[1][2] = 0;
+	Y.elements[2][0] = -Sin(y);	Y.elements[2][1] = 0;		Y.elements[2][2] = Cos(y);
+
+	X.elements[0][0] = 1;		X.elements[0][1] = 0;		X.elements[0][2] = 0;
+	X.elements[1][0] = 0;		X.elements[1][1] = Cos(x);	X.elements[1][2] = -Sin(x);
+	X.elements[2][0] = 0;		X.elements[2][1] = Sin(x);	X.elements[2][2] = Cos(x);
+
+	Z.elements[0][0] = Cos(z);	Z.elements[0][1] = -Sin(z);	Z.elements[0][2] = 0;
+	Z.elements[1][0] = Sin(z);	Z.elements[1][1] = Cos(z);	Z.elements[1][2] = 0;
+	Z.elements[2][0] = 0;		Z.elements[2][1] = 0;		Z.elements[2][2] = 1;
+
+	return M3Mult(M3Mult(Y, X), Z);
+}
+
+void M3ToQuaternion(Matrix3x3 m, float q[4])
+{
+	float (*e)[3] = m.elements;
+	float trace = e[0][0] + e[1][1] + e[2][2];
+	float s;
+
+	/* pick the largest diagonal term to keep the square root well conditioned */
+	if (trace > 0)
+	{
+		s = 0.5f / (float)sqrt(trace + 1.0f);
+		q[3] = 0.25f / s;
+		q[0] = (e[2][1] - e[1][2]) * s;
+		q[1] = (e[0][2] - e[2][0]) * s;
+		q[2] = (e[1][0] - e[0][1]) * s;
+	}
+	else if (e[0][0] > e[1][1] && e[0][0] > e[2][2])
+	{
+		s = 2.0f * (float)sqrt(1.0f + e[0][0] - e[1][1] - e[2][2]);
+		q[3] = (e[2][1] - e[1][2]) / s;
+		q[0] = 0.25f * s;
+		q[1] = (e[0][1] + e[1][0]) / s;
+		q[2] = (e[0][2] + e[2][0]) / s;
+	}
+	else if (e[1][1] > e[2][2])
+	{
+		s = 2.0f * (float)sqrt(1.0f + e[1][1] - e[0][0] - e[2][2]);
+		q[3] = (e[0][2] - e[2][0]) / s;
+		q[0] = (e[0][1] + e[1][0]) / s;
+		q[1] = 0.25f * s;
+		q[2] = (e[1][2] + e[2][1]) / s;
+	}
+	else
+	{
+		s = 2.0f * (float)sqrt(1.0f + e[2][2] - e[0][0] - e[1][1]);
+		q[3] = (e[1][0] - e[0][1]) / s;
+		q[0] = (e[0][2] + e[2][0]) / s;
+		q[1] = (e[1][2] + e[2][1]) / s;
+		q[2] = 0.25f * s;
+	}
+}
+
+Matrix3x3 M3FromQuaternion(float q[4])
+{
+	Matrix3x3 m;
+	float x = q[0], y = q[1], z = q[2], w = q[3];
+
+	m.elements[0][0] = 1 - 2 * (y * y + z * z);	m.elements[0][1] = 2 * (x * y - z * w);		m.elements[0][2] = 2 * (x * z + y * w);
+	m.elements[1][0] = 2 * (x * y + z * w);		m.elements[1][1] = 1 - 2 * (x * x + z * z);	m.elements[1][2] = 2 * (y * z - x * w);
+	m.elements[2][0] = 2 * (x * z - y * w);		m.elements[2][1] = 2 * (y * z + x * w);		m.elements[2][2] = 1 - 2 * (x * x + y * y);
+
+	return m;
+}
@@ -0,0 +1,237 @@
+
+#include "Physics.h"
+#include "Scene.h"
+#include "StaticMesh.h"
+#include "Shape.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+
+/**
+ * @brief	A scene, the handles of its bodies and the static mesh it owns.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct PhysicsWorld
+{
+	Scene scene;
+	PhysicsBody handles[MAX_OBJECTS];	/* handle of the body at each scene index */
+	PhysicsBody lastHandle;				/* handle given to the last body added */
+
+	StaticMesh mesh;
+	bool hasMesh;
+};
+
+/* Finds the scene index of a body, or -1. */
+static int FindBody(PhysicsWorld *world, PhysicsBody body);
+
+/* true if every value is finite. */
+static bool Finite(const float *values, int count);
+
+PhysicsWorld *PhysicsCreate(void)
+{
+	/* scenes are aligned to cache lines, so the size is a multiple of one */
+	PhysicsWorld *world = (PhysicsWorld*)aligned_alloc(CACHE_LINE_SIZE, sizeof(PhysicsWorld));
+
+	if (!world)
+		return NULL;
+
+	/* the simulation never draws random numbers */
+	SceneInit(&world->scene, 0);
+	world->lastHandle = 0;
+	world->hasMesh = false;
+	return world;
+}
+
+void PhysicsDestroy(PhysicsWorld *world)
+{
+	if (world == NULL)
+		return;
+
+	if (world->hasMesh)
+		StaticMeshDestroy(&world->mesh);
+	free(world);
+}
+
+int PhysicsMaxBodies(void)
+{
+	return MAX_OBJECTS;
+}
+
+void PhysicsGetParams(PhysicsWorld *world, PhysicsParams *params)
+{
+	SceneParams *scene = &world->scene.params;
+
+	params->gravity = scene->body.gravity;
+	params->linearDamping = scene->body.linearDamping;
+	params->angularDamping = scene->body.angularDamping;
+	params->horizontalFriction = scene->body.horizontalFriction;
+	params->verticalFriction = scene->body.verticalFriction;
+	params->angularFriction = scene->body.angularFriction;
+	params->massMultiplier = scene->body.massMultiplier;
+	params->bounceFactor = scene->body.bounceFactor;
+	params->contactMargin = scene->contact.margin;
+	params->contactFriction = scene->contact.friction;
+	params->penetrationSlop = scene->contact.penetrationSlop;
+	params->penetrationCorrection = scene->contact.penetrationCorrection;
+	params->bounceThreshold = scene->contact.bounceThreshold;
+	params->solverIterations = scene->solverIterations;
+}
+
+void PhysicsSetParams(PhysicsWorld *world, const PhysicsParams *params)
+{
+	SceneParams *scene = &world->scene.params;
+
+	scene->body.gravity = params->gravity;
+	scene->body.linearDamping = params->linearDamping;
+	scene->body.angularDamping = params->angularDamping;
+	scene->body.horizontalFriction = params->horizontalFriction;
+	scene->body.verticalFriction = params->verticalFriction;
+	scene->body.angularFriction = params->angularFriction;
+	scene->body.massMultiplier = params->massMultiplier;
+	scene->body.bounceFactor = params->bounceFactor;
+	scene->contact.margin = params->contactMargin;
+	scene->contact.friction = params->contactFriction;
+	scene->contact.penetrationSlop = params->penetrationSlop;
+	scene->contact.penetrationCorrection = params->penetrationCorrection;
+	scene->contact.bounceThreshold = params->bounceThreshold;
+	scene->solverIterations = params->solverIterations;
+}
+
+void PhysicsBodyDescInit(PhysicsBodyDesc *desc, int sides, float size, float density)
+{
+	memset(desc, 0, sizeof(PhysicsBodyDesc));
+	desc->sides = sides;
+	desc->size[0] = desc->size[1] = desc->size[2] = size;
+	desc->density = density;
+	desc->orientation[0] = desc->orientation[4] = desc->orientation[8] = 1;
+}
+
+PhysicsBody PhysicsAddBody(PhysicsWorld *world, const PhysicsBodyDesc *desc)
+{
+	RigidbodyState state;
+	int index;
+
+	if (!ShapeFromSides(desc->sides, &state.shape))
+		return 0;
+
+	/* one NaN spreads to every body it touches */
+	if (!Finite(desc->size, 3) || !Finite(&desc->density, 1) || desc->size[0] <= 0 || desc->size[1] <= 0 || desc->size[2] <= 0 ||
+		desc->density <= 0 || !Finite(desc->position, 3) || !Finite(desc->orientation, 9) || !Finite(desc->velocity, 3) || !Finite(desc->spin, 3))
+		return 0;
+
+	state.density = desc->density;
+	state.dimensions = Vec3New(desc->size[0], desc->size[1], desc->size[2]);
+	state.position = Vec3New(desc->position[0], desc->position[1], desc->position[2]);
+	memcpy(state.orientation.elements, desc->orientation, sizeof(state.orientation.elements));
+	state.velocity = Vec3New(desc->velocity[0], desc->velocity[1], desc->velocity[2]);
+	state.angularMomentum = RBAngularMomentumForSpin(&state, Vec3New(desc->spin[0], desc->spin[1], desc->spin[2]), &world->scene.params.body);
+
+	index = SceneSpawnRigidbody(&world->scene, &state);
+	if (index < 0)
+		return 0;
+
+	/* 0 is never a handle */
+	world->lastHandle++;
+	if (world->lastHandle == 0)
+		world->lastHandle++;
+
+	world->handles[index] = world->lastHandle;
+	return world->lastHandle;
+}
+
+int PhysicsRemoveBody(PhysicsWorld *world, PhysicsBody body)
+{
+	int index = FindBody(world, body);
+
+	if (index < 0)
+		return false;
+
+	/* the scene moves its last body into the gap, so its handle moves too */
+	SceneRemoveRigidbody(&world->scene, index);
+	world->handles[index] = world->handles[world->scene.numObjects];
+	return true;
+}
+
+int PhysicsBodyCount(PhysicsWorld *world)
+{
+	return world->scene.numObjects;
+}
+
+int PhysicsGetBody(PhysicsWorld *world, PhysicsBody body, PhysicsBodyState *state)
+{
+	int index = FindBody(world, body);
+	Rigidbody *rb;
+
+	if (index < 0)
+		return false;
+
+	rb = &world->scene.objects[index];
+	state->position[0] = rb->position.x;
+	state->position[1] = rb->position.y;
+	state->position[2] = rb->position.z;
+	memcpy(state->orientation, rb->orientation.elements, sizeof(state->orientation));
+	state->velocity[0] = rb->velocity.x;
+	state->velocity[1] = rb->velocity.y;
+	state->velocity[2] = rb->velocity.z;
+	state->spin[0] = rb->angularVelocity.x;
+	state->spin[1] = rb->angularVelocity.y;
+	state->spin[2] = rb->angularVelocity.z;
+	return true;
+}
+
+int PhysicsSetMesh(PhysicsWorld *world, const float *vertices, int numVertices, const int *indices, int numTriangles)
+{
+	int i;
+
+	/* the mesh is built straight from the caller's arrays, so every index is checked first */
+	if (numTriangles > INT_MAX / 3)
+		return false;
+	for (i = 0; i < numTriangles * 3; i++)
+		if (indices[i] < 0 || indices[i] >= numVertices || !Finite(&vertices[indices[i] * 3], 3))
+			return false;
+
+	if (world->hasMesh)
+		StaticMeshDestroy(&world->mesh);
+
+	/* Vector3 is three floats, so the vertices can be used as they are */
+	world->hasMesh = numTriangles > 0 && StaticMeshCreate(&world->mesh, (const Vector3*)vertices, indices, numTriangles);
+	world->scene.staticMesh = world->hasMesh ? &world->mesh : NULL;
+
+	/* contacts with the old mesh refer to its triangles */
+	SceneResetContacts(&world->scene);
+	return world->hasMesh || numTriangles <= 0;
+}
+
+void PhysicsStep(PhysicsWorld *world, float deltaTime)
+{
+	SceneUpdate(&world->scene, deltaTime);
+}
+
+/* Finds the scene index of a body, or -1. */
+static int FindBody(PhysicsWorld *world, PhysicsBody body)
+{
+	int i;
+
+	if (body == 0)
+		return -1;
+
+	for (i = 0; i < world->scene.numObjects; i++)
+		if (world->handles[i] == body)
+			return i;
+
+	return -1;
+}
+
+/* true if every value is finite. */
+static bool Finite(const float *values, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		if (!isfinite(values[i]))
+			return false;
+
+	return true;
+}
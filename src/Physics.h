@@ -0,0 +1,230 @@
+/**
+ * @file	Physics.h
+ * @brief	Handle based interface to the dice simulation, for embedding in other programs.
+ * @details	Link with libdicephysics.a and -lm -lpthread. This header includes nothing from the
+ * 			rest of the source, so it can be used alongside other code's own vector and boolean
+ * 			types; functions that can fail return 0 on failure and nonzero on success.
+ *
+ * 			Each world is independent, with its own parameters, and holds no references to
+ * 			anything global, so any number of worlds can be created and stepped on different
+ * 			threads at once without locks. Worlds start on their own cache lines. A single world
+ * 			must only be used by one thread at a time.
+ *
+ * 			y is up and the floor is the plane y = 0. Orientations are 3x3 rotation matrices in
+ * 			row major order, taking body space to world space.
+ *
+ * 			<pre>
+ * 			PhysicsWorld *world = PhysicsCreate();
+ * 			PhysicsBodyDesc desc;
+ * 			PhysicsBodyState state;
+ * 			PhysicsBody die;
+ *
+ * 			PhysicsBodyDescInit(&desc, 6, 1, 3);
+ * 			desc.position[1] = 2;
+ * 			desc.velocity[0] = 4;
+ * 			die = PhysicsAddBody(world, &desc);
+ *
+ * 			for (i = 0; i < 1000; i++)
+ * 				PhysicsStep(world, 0.005f);
+ * 			PhysicsGetBody(world, die, &state);
+ *
+ * 			PhysicsDestroy(world);
+ * 			</pre>
+ */
+
+#ifndef PHYSICS_H
+#define PHYSICS_H
+
+/**
+ * @brief	A simulated world of dice, created by PhysicsCreate. Opaque.
+ */
+typedef struct PhysicsWorld PhysicsWorld;
+
+/**
+ * @brief	Identifies a body in a world. 0 is never a valid body.
+ * @details	Handles stay valid until the body is removed, even when other bodies are removed.
+ * 			A world doesn't reuse handles.
+ */
+typedef unsigned PhysicsBody;
+
+/**
+ * @brief	Describes a body to add to a world.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct PhysicsBodyDesc
+{
+	int sides;						/* 4, 6, 8, 10, 12 or 20 */
+	float size[3];					/* edge lengths of the bounding box */
+	float density;
+	float position[3];
+	float orientation[9];
+	float velocity[3];
+	float spin[3];					/* angular velocity in radians per second about each world axis */
+};
+typedef struct PhysicsBodyDesc PhysicsBodyDesc;
+
+/**
+ * @brief	The motion of a body after a step.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct PhysicsBodyState
+{
+	float position[3];
+	float orientation[9];
+	float velocity[3];
+	float spin[3];
+};
+typedef struct PhysicsBodyState PhysicsBodyState;
+
+/**
+ * @brief	The physics of a world.
+ * @details	Every world starts with the same defaults, which PhysicsGetParams gives.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct PhysicsParams
+{
+	float gravity;
+	float linearDamping;
+	float angularDamping;
+	float horizontalFriction;		/* fraction of horizontal velocity kept per step on the floor */
+	float verticalFriction;
+	float angularFriction;			/* fraction of spin about the vertical kept per step on the floor */
+	float massMultiplier;			/* mass per eighth of the volume at density 1, for bodies added after */
+	float bounceFactor;				/* coefficient of restitution, for bodies added after */
+	float contactMargin;			/* gap within which points are contacts */
+	float contactFriction;			/* friction impulse allowed per unit of normal impulse */
+	float penetrationSlop;			/* penetration left alone, so resting contacts persist */
+	float penetrationCorrection;	/* fraction of the rest pushed out each step */
+	float bounceThreshold;			/* closing speed below which contacts don't bounce */
+	int solverIterations;
+};
+typedef struct PhysicsParams PhysicsParams;
+
+/**
+ * @brief	Creates an empty world with only the floor.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @return	The world, or NULL if memory could not be allocated.
+ */
+PhysicsWorld *PhysicsCreate(void);
+
+/**
+ * @brief	Frees a world and everything in it.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	world	The world, or NULL.
+ */
+void PhysicsDestroy(PhysicsWorld *world);
+
+/**
+ * @brief	Gets the most bodies a world can hold at once.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @return	The number of bodies.
+ */
+int PhysicsMaxBodies(void);
+
+/**
+ * @brief	Gets the physics of a world.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	world 	The world.
+ * @param 	params	The params to write to.
+ */
+void PhysicsGetParams(PhysicsWorld *world, PhysicsParams *params);
+
+/**
+ * @brief	Changes the physics of a world.
+ * @details	Other worlds are not affected.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	world 	The world.
+ * @param 	params	The params.
+ */
+void PhysicsSetParams(PhysicsWorld *world, const PhysicsParams *params);
+
+/**
+ * @brief	Fills in a description of a cube shaped die at rest at the origin.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	desc   	The description.
+ * @param 	sides  	Number of sides.
+ * @param 	size   	Edge length of the bounding box.
+ * @param 	density	The density.
+ */
+void PhysicsBodyDescInit(PhysicsBodyDesc *desc, int sides, float size, float density);
+
+/**
+ * @brief	Adds a body to a world.
+ * @details	The body is moved out of any body it overlaps.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	world	The world.
+ * @param 	desc 	The body.
+ * @return	The body's handle, or 0 if the world is full, the number of sides is not a die's,
+ * 			the size or density is not finite and positive, or any other value is not finite.
+ */
+PhysicsBody PhysicsAddBody(PhysicsWorld *world, const PhysicsBodyDesc *desc);
+
+/**
+ * @brief	Removes a body from a world.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	world	The world.
+ * @param 	body 	The body.
+ * @return	0 if the body is not in the world.
+ */
+int PhysicsRemoveBody(PhysicsWorld *world, PhysicsBody body);
+
+/**
+ * @brief	Gets the number of bodies in a world.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	world	The world.
+ * @return	The number of bodies.
+ */
+int PhysicsBodyCount(PhysicsWorld *world);
+
+/**
+ * @brief	Gets the motion of a body.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	world	The world.
+ * @param 	body 	The body.
+ * @param 	state	The state to write to.
+ * @return	0 if the body is not in the world.
+ */
+int PhysicsGetBody(PhysicsWorld *world, PhysicsBody body, PhysicsBodyState *state);
+
+/**
+ * @brief	Replaces the static geometry bodies collide with, besides the floor.
+ * @details	The triangles are copied. Pass no triangles to leave only the floor.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	world	   		The world.
+ * @param 	vertices   		Three floats per vertex.
+ * @param 	numVertices		Number of vertices.
+ * @param 	indices	   		Three vertex indices per triangle, counter-clockwise seen from
+ * 							the side bodies are pushed out to.
+ * @param 	numTriangles	Number of triangles.
+ * @return	0 if an index is not below numVertices, a used vertex is not finite or memory could
+ * 			not be allocated. Invalid meshes leave the world's mesh as it was; if memory runs
+ * 			out, the world has only the floor.
+ */
+int PhysicsSetMesh(PhysicsWorld *world, const float *vertices, int numVertices, const int *indices, int numTriangles);
+
+/**
+ * @brief	Advances a world.
+ * @details	Contacts carry their impulses from one step to the next, so fixed steps of 1/200
+ * 			second or less, as the demo and roll queries use, work best.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	world	 	The world.
+ * @param 	deltaTime	Seconds to advance.
+ */
+void PhysicsStep(PhysicsWorld *world, float deltaTime);
+
+#endif
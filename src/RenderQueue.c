@@ -0,0 +1,161 @@
+
+#include "RenderQueue.h"
+#include <stdlib.h>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+/* capabilities in the order of their RenderCapability flags */
+static const GLenum capabilities[] = { GL_LIGHTING, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_TEXTURE_2D, GL_BLEND };
+
+/* sorts items by layer, then texture, then the order they were added */
+static int ItemCompare(const void *a, const void *b)
+{
+	const RenderItem *itemA = (const RenderItem*)a, *itemB = (const RenderItem*)b;
+
+	if (itemA->layer != itemB->layer)
+		return itemA->layer < itemB->layer ? -1 : 1;
+	if (itemA->texture != itemB->texture)
+		return itemA->texture < itemB->texture ? -1 : 1;
+	return itemA->order - itemB->order;
+}
+
+/* sets the state and texture for a batch, skipping anything already set. Stencil settings and
+   the texture are only kept up to date while they're in use */
+static void ApplyState(RenderQueue *queue, const RenderState *state, unsigned texture)
+{
+	RenderState *current = &queue->current;
+	bool all = !queue->currentValid;
+	unsigned changed;
+	int i;
+
+	changed = all ? ~0u : state->capabilities ^ current->capabilities;
+	for (i = 0; i < (int)(sizeof(capabilities) / sizeof(capabilities[0])); i++)
+	{
+		if (changed & (1u << i))
+		{
+			if (state->capabilities & (1u << i))
+				glEnable(capabilities[i]);
+			else
+				glDisable(capabilities[i]);
+			queue->stateChanges++;
+		}
+	}
+	current->capabilities = state->capabilities;
+
+	if (all || ((state->capabilities & RENDER_STENCIL_TEST) &&
+		(state->stencilFunc != current->stencilFunc || state->stencilRef != current->stencilRef || state->stencilPass != current->stencilPass)))
+	{
+		glStencilFunc(state->stencilFunc, state->stencilRef, 0xFF);
+		glStencilOp(GL_KEEP, GL_KEEP, state->stencilPass);
+		current->stencilFunc = state->stencilFunc;
+		current->stencilRef = state->stencilRef;
+		current->stencilPass = state->stencilPass;
+		queue->stateChanges += 2;
+	}
+
+	if (all || !ColourEqual(state->colour, current->colour))
+	{
+		glColor4f(state->colour.r, state->colour.g, state->colour.b, state->colour.a);
+		current->colour = state->colour;
+		queue->stateChanges++;
+	}
+
+	if (all || ((state->capabilities & RENDER_TEXTURE) && texture != queue->currentTexture))
+	{
+		glBindTexture(GL_TEXTURE_2D, texture);
+		queue->currentTexture = texture;
+		queue->stateChanges++;
+	}
+
+	queue->currentValid = true;
+}
+
+void RenderQueueInit(RenderQueue *queue)
+{
+	queue->items = NULL;
+	queue->numItems = 0;
+	queue->numSubmitted = 0;
+	queue->capacity = 0;
+	queue->currentValid = false;
+	queue->drawCalls = 0;
+	queue->stateChanges = 0;
+}
+
+void RenderQueueDestroy(RenderQueue *queue)
+{
+	free(queue->items);
+	RenderQueueInit(queue);
+}
+
+bool RenderQueueAdd(RenderQueue *queue, unsigned layer, const RenderState *state, unsigned texture, unsigned mode, RenderItemCallback callback, const void *object, int part)
+{
+	RenderItem *items, *item;
+	int capacity;
+
+	if (queue->numItems == queue->capacity)
+	{
+		capacity = queue->capacity > 0 ? queue->capacity * 2 : 64;
+		items = (RenderItem*)realloc(queue->items, capacity * sizeof(RenderItem));
+		if (items == NULL)
+			return false;
+		queue->items = items;
+		queue->capacity = capacity;
+	}
+
+	item = &queue->items[queue->numItems];
+	item->layer = layer;
+	item->state = state;
+	item->texture = (state->capabilities & RENDER_TEXTURE) ? texture : 0;
+	item->mode = mode;
+	item->callback = callback;
+	item->object = object;
+	item->part = part;
+	item->order = queue->numItems++;
+	return true;
+}
+
+void RenderQueueSubmit(RenderQueue *queue, unsigned lastLayer)
+{
+	RenderItem *item, *batch = NULL;
+	int i;
+
+	if (queue->numSubmitted == 0)
+		qsort(queue->items, queue->numItems, sizeof(RenderItem), ItemCompare);
+
+	for (i = queue->numSubmitted; i < queue->numItems && queue->items[i].layer <= lastLayer; i++)
+	{
+		item = &queue->items[i];
+
+		/* carry on the open batch if nothing it was started with differs */
+		if (batch != NULL && (item->state != batch->state || item->texture != batch->texture || item->mode != batch->mode))
+		{
+			glEnd();
+			batch = NULL;
+		}
+
+		if (batch == NULL)
+		{
+			ApplyState(queue, item->state, item->texture);
+			glBegin(item->mode);
+			queue->drawCalls++;
+			batch = item;
+		}
+
+		item->callback(item->object, item->part);
+	}
+
+	if (batch != NULL)
+		glEnd();
+
+	/* empty once every layer is drawn */
+	queue->numSubmitted = i;
+	if (queue->numSubmitted == queue->numItems)
+	{
+		queue->numItems = 0;
+		queue->numSubmitted = 0;
+	}
+}
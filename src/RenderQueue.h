@@ -0,0 +1,131 @@
+/**
+ * @file	RenderQueue.h
+ * @brief	Collects a frame's draws, sorts them by state and submits them in as few batches as possible.
+ */
+
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include "Colour.h"
+#include "Boolean.h"
+
+/**
+ * @brief	openGL capabilities a render state enables. Any not set are disabled.
+ */
+enum RenderCapability
+{
+	RENDER_LIGHTING = 1,
+	RENDER_DEPTH_TEST = 2,
+	RENDER_STENCIL_TEST = 4,
+	RENDER_TEXTURE = 8,
+	RENDER_BLEND = 16
+};
+
+/**
+ * @brief	The openGL state a group of draws needs.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct RenderState
+{
+	unsigned capabilities;			/* RenderCapability flags */
+	unsigned stencilFunc;			/* eg. GL_ALWAYS, only used with RENDER_STENCIL_TEST */
+	int stencilRef;
+	unsigned stencilPass;			/* stencil operation where the depth test passes */
+	Colour colour;
+};
+typedef struct RenderState RenderState;
+
+/**
+ * @brief	Defines a type alias for the function that draws an item.
+ * @details	Called between glBegin and glEnd, so it may only give vertices and their attributes.
+ */
+typedef void (*RenderItemCallback)(const void *object, int part);
+
+/**
+ * @brief	One draw in a render queue.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct RenderItem
+{
+	unsigned layer;					/* items are drawn in increasing layer */
+	const RenderState *state;
+	unsigned texture;				/* openGL texture, ignored without RENDER_TEXTURE */
+	unsigned mode;					/* openGL primitive, eg. GL_TRIANGLES */
+	RenderItemCallback callback;
+	const void *object;				/* passed to the callback */
+	int part;						/* passed to the callback */
+	int order;						/* when the item was added, so items that tie keep their order */
+};
+typedef struct RenderItem RenderItem;
+
+/**
+ * @brief	A list of draws for one frame, and the openGL state left by the last submit.
+ * @details	The queue assumes nothing else changes the state it tracks between submits.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct RenderQueue
+{
+	RenderItem *items;
+	int numItems;
+	int numSubmitted;				/* items already drawn by RenderQueueSubmit */
+	int capacity;
+
+	RenderState current;			/* state set by the last submit */
+	unsigned currentTexture;
+	bool currentValid;				/* false until the first submit */
+
+	int drawCalls;					/* glBegin/glEnd blocks, added to by each submit */
+	int stateChanges;				/* openGL state calls, added to by each submit */
+};
+typedef struct RenderQueue RenderQueue;
+
+/**
+ * @brief	Initializes an empty render queue.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	queue	The queue.
+ */
+void RenderQueueInit(RenderQueue *queue);
+
+/**
+ * @brief	Frees a render queue's items.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	queue	The queue.
+ */
+void RenderQueueDestroy(RenderQueue *queue);
+
+/**
+ * @brief	Adds a draw to the queue.
+ * @details	Consecutive items with the same state, texture and mode are drawn in one batch.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	queue   	The queue.
+ * @param 	layer   	Items in lower layers are drawn first.
+ * @param 	state   	The state to draw with. Must stay valid until the queue is submitted.
+ * @param 	texture 	The texture to draw with.
+ * @param 	mode    	The openGL primitive the callback's vertices make.
+ * @param 	callback	Gives the vertices.
+ * @param 	object  	Passed to the callback.
+ * @param 	part    	Passed to the callback.
+ * @return	false if memory could not be allocated - the item is not drawn.
+ */
+bool RenderQueueAdd(RenderQueue *queue, unsigned layer, const RenderState *state, unsigned texture, unsigned mode, RenderItemCallback callback, const void *object, int part);
+
+/**
+ * @brief	Draws the items in the queue up to a layer.
+ * @details	Items are sorted by layer, then texture. State is only changed where it differs from
+ * 			what the previous batch (or submit) left. Later layers can be drawn by further calls,
+ * 			eg. to time each layer - no items can be added until the queue has been emptied by
+ * 			drawing its last layer. Adds to drawCalls and stateChanges.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	queue    	The queue.
+ * @param 	lastLayer	The last layer to draw.
+ */
+void RenderQueueSubmit(RenderQueue *queue, unsigned lastLayer);
+
+#endif
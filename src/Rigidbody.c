@@ -1,325 +1,383 @@
-
-#include "Rigidbody.h"
-#include "MathUtils.h"
-
-const float GRAVITY = 20;
-const float LINEAR_DAMPING = 0.1f;
-const float ANGULAR_DAMPING = 0.3f;
-const float HORIZONTAL_FRICTION = 0.8f;
-const float VERTICAL_FRICTION = 0.04f;
-const float ANGULAR_FRICTION = 0.08f;
-const float BOUNCE_FACTOR = 0.6f;
-const float MASS_MULTIPLIER = 8.0f;
-
-void RBInit(Rigidbody *rigidbody, Vector3 position, Vector3 dimensions, float density)
-{
-	float x, y, z;
-
-	rigidbody->position = position;
-	rigidbody->dimensions = dimensions;
-
-	/* get half dimensions */
-	x = dimensions.x / 2;
-	y = dimensions.y / 2;
-	z = dimensions.z / 2;
-
-	/* init vertices */
-	rigidbody->numVerts = 8;
-	rigidbody->bodyVertices[0] = Vec3New(-x, -y,  z);
-    rigidbody->bodyVertices[1] = Vec3New(-x, -y, -z);
-    rigidbody->bodyVertices[2] = Vec3New( x, -y, -z);
-    rigidbody->bodyVertices[3] = Vec3New( x, -y,  z);
-    rigidbody->bodyVertices[4] = Vec3New(-x,  y,  z);
-    rigidbody->bodyVertices[5] = Vec3New( x,  y,  z);
-    rigidbody->bodyVertices[6] = Vec3New( x,  y, -z);
-    rigidbody->bodyVertices[7] = Vec3New(-x,  y, -z);
-
-	/* calc mass */
-	rigidbody->mass = MASS_MULTIPLIER * density * x * y * z;
-
-	/* calc inertia tensor */
-	rigidbody->inverseBodyInertiaTensor.elements[0][0] = 3.0f / (rigidbody->mass * (y * y + z * z));
-	rigidbody->inverseBodyInertiaTensor.elements[1][1] = 3.0f / (rigidbody->mass * (x * x + z * z));
-	rigidbody->inverseBodyInertiaTensor.elements[2][2] = 3.0f / (rigidbody->mass * (x * x + y * y));
-
-	/* bounce factor */
-	rigidbody->coefficientOfRestitution = BOUNCE_FACTOR;
-
-	/* set orientation to identity */
-	rigidbody->orientation = M3New();
-}
-
-void RBCalculateVertices(Rigidbody *rigidbody)
-{        
-	unsigned i;
-	Vector3 temp;
-
-	for(i = 0; i < rigidbody->numVerts; i++)
-    {
-		temp = M3TransformVector(rigidbody->orientation, rigidbody->bodyVertices[i]);
-        rigidbody->vertices[i] = Vec3Add(rigidbody->position, temp);
-    }
-}
-
-void RBApplyForces(Rigidbody *rigidbody)
-{
-	float radius;
-
-	/* clear last updates forces */
-	rigidbody->torque = Vec3New(0, 0, 0);
-	rigidbody->force = Vec3New(0, 0, 0);
-
-	/* apply gravity */
-	rigidbody->force.y -= GRAVITY * rigidbody->mass;
-
-	/* apply damping (air resistance) */
-	rigidbody->force = Vec3Add(rigidbody->force, Vec3Mult(rigidbody->velocity, -LINEAR_DAMPING));
-	rigidbody->torque = Vec3Add(rigidbody->torque, Vec3Mult(rigidbody->angularVelocity, -ANGULAR_DAMPING));
-
-	/* apply friction if touching floor */
-	radius = Min(Min(rigidbody->dimensions.x, rigidbody->dimensions.y), rigidbody->dimensions.z) / 2;
-	if (rigidbody->position.y <= radius + 0.003f)
-	{
-		rigidbody->force.x *= HORIZONTAL_FRICTION;
-		rigidbody->force.z *= HORIZONTAL_FRICTION;
-		rigidbody->force.y *= VERTICAL_FRICTION;
-
-		rigidbody->velocity.x *= HORIZONTAL_FRICTION;
-		rigidbody->velocity.z *= HORIZONTAL_FRICTION;
-		rigidbody->velocity.y *= VERTICAL_FRICTION;
-
-		rigidbody->torque.y *= ANGULAR_FRICTION;
-		rigidbody->angularVelocity.y *= ANGULAR_FRICTION;
-	}
-}
-
-void RBIntegrate(Rigidbody *rigidbody, float deltaTime)
-{
-	Vector3 newPosition, newVelocity, newAngularMomentum, newAngularVelocity;
-	Matrix3x3 newOrientation, newInverseWorldInertiaTensor;
-
-	/* calculate new values by Euler intergration */
-	newPosition = Vec3Add(rigidbody->position, Vec3Mult(rigidbody->velocity, deltaTime));
-
-	newOrientation = M3Add(rigidbody->orientation, M3Scale(M3Mult(M3SkewSymetricFromVector(rigidbody->angularVelocity), rigidbody->orientation), deltaTime));
-	newOrientation = M3Orthonormalize(newOrientation);
-
-	newVelocity = Vec3Add(rigidbody->velocity, Vec3Mult(rigidbody->force, deltaTime / rigidbody->mass));
-
-	newAngularMomentum = Vec3Add(rigidbody->angularMomentum, Vec3Mult(rigidbody->torque, deltaTime));
-
-	newInverseWorldInertiaTensor = M3Mult(M3Mult(newOrientation, rigidbody->inverseBodyInertiaTensor), M3Transpose(newOrientation));
-
-	newAngularVelocity = M3TransformVector(newInverseWorldInertiaTensor, newAngularMomentum);
-
-	/* update parameters */
-	rigidbody->position = newPosition;
-	rigidbody->orientation = newOrientation;
-	rigidbody->velocity = newVelocity;
-	rigidbody->angularMomentum = newAngularMomentum;
-	rigidbody->inverseWorldInertiaTensor = newInverseWorldInertiaTensor;
-	rigidbody->angularVelocity = newAngularVelocity;
-}
-
-void RBCheckCollisionFloor(Rigidbody *rigidbody)
-{
-    float const depthEpsilon = 0.001f;
-	unsigned i;
-	Vector3 offset, velocity;
-	float projection, relativeVelocity;
-	Vector3 floorNormal = Vec3Normalize(Vec3New(0, 1, 0));
-
-	rigidbody->Collision.state = NO_COLLISION;
-
-	/* loop through each vertex */
-    for (i = 0; i < rigidbody->numVerts && rigidbody->Collision.state == NO_COLLISION; i++)
-    {
-		/* get distance between vertex and ground plane */
-		projection = Vec3Dot(rigidbody->vertices[i], floorNormal);
-        
-        if (projection < -depthEpsilon)
-        {
-            rigidbody->Collision.state = PENETRATING;
-        }
-        else if (projection < depthEpsilon)
-        {
-			/* check if moving down towards floor */
-			offset = Vec3Sub(rigidbody->vertices[i], rigidbody->position);
-			velocity = Vec3Add(rigidbody->velocity, Vec3Cross(rigidbody->angularVelocity, offset));
-            relativeVelocity = Vec3Dot(floorNormal, velocity);
-
-            if (relativeVelocity < 0)
-            {
-				/* handle collision response */
-                rigidbody->Collision.state = COLLIDING;
-                rigidbody->Collision.normal = floorNormal;
-                rigidbody->Collision.contactPoint = rigidbody->vertices[i];
-            }
-        }
-    }
-}
-
-void RBResolveCollisions(Rigidbody *rigidbody)
-{
-	Vector3 position = rigidbody->Collision.contactPoint;
-	Vector3 offset = Vec3Sub(position, rigidbody->position);
-	Vector3 velocity = Vec3Add(rigidbody->velocity, Vec3Cross(rigidbody->angularVelocity, offset));
-
-	/* calculate impulse */
-	float impulseNumerator = -(1.0f + rigidbody->coefficientOfRestitution) * Vec3Dot(velocity, rigidbody->Collision.normal);
-	float impulseDenominator = (1.0f / rigidbody->mass) + Vec3Dot(Vec3Cross(M3TransformVector(rigidbody->inverseWorldInertiaTensor, Vec3Cross(offset, rigidbody->Collision.normal)), offset), rigidbody->Collision.normal);
-
-	/* apply impulse */
-	Vector3 impulse = Vec3Mult(rigidbody->Collision.normal, (impulseNumerator/impulseDenominator));
-	rigidbody->velocity = Vec3Add(rigidbody->velocity, Vec3Mult(impulse, 1.0f / rigidbody->mass));
-	rigidbody->angularMomentum = Vec3Add(rigidbody->angularMomentum, Vec3Cross(offset, impulse));
-	rigidbody->angularVelocity = M3TransformVector(rigidbody->inverseWorldInertiaTensor, rigidbody->angularMomentum);
-}
-
-void RBMoveOutOfFloor(Rigidbody *rigidbody)
-{
-	unsigned i;
-	float projection, maxProjection = 1;
-	Vector3 floorNormal = Vec3Normalize(Vec3New(0, 1, 0));
-
-	/* find max penetration */
-    for (i = 0; i < rigidbody->numVerts; i++)
-    {
-		projection = Vec3Dot(rigidbody->vertices[i], floorNormal);
-		
-		if (projection < maxProjection)
-			maxProjection = projection;
-    }
-
-	/* move outside if penetrating */
-	if (maxProjection < 0)
-		rigidbody->position = Vec3Add(rigidbody->position, Vec3Mult(floorNormal, -maxProjection));
-}
-
-void RBMoveOutOfBody(Rigidbody *rigidbody, Rigidbody *other)
-{
-	unsigned i;
-	Vector3 normal;
-	float penetrationDistance;
-	float radius, distance;
-	Vector3 direction;
-
-	/* get smallest dimension of body */
-	radius = Min(Min(rigidbody->dimensions.x, rigidbody->dimensions.y), rigidbody->dimensions.z);
-
-	/* get distance between rigidbody centers */
-	distance = Vec3Magnitude(Vec3Sub(rigidbody->position, other->position));
-
-	if (distance < radius / 2)
-	{
-		/* objects are too close, move away */
-		direction = Vec3Normalize(Vec3Sub(rigidbody->position, other->position));
-		rigidbody->position = Vec3Add(rigidbody->position, Vec3Mult(direction, -(radius - distance)));
-	}
-
-	/* Check verts for penetration */
-	for (i = 0; i < rigidbody->numVerts; i++)
-    {
-		if (RBCheckCollisionPoint(other, rigidbody->vertices[i], &normal, &penetrationDistance))
-			rigidbody->position = Vec3Add(rigidbody->position, Vec3Mult(normal, -penetrationDistance));
-	}
-	for (i = 0; i < rigidbody->numVerts; i++)
-    {
-		if (RBCheckCollisionPoint(rigidbody, other->vertices[i], &normal, &penetrationDistance))
-			rigidbody->position = Vec3Add(rigidbody->position, Vec3Mult(Vec3New(-normal.x, -normal.y, -normal.z), -penetrationDistance));
-	}
-}
-
-Vector3 RBGetNormal(Vector3 v1, Vector3 v2, Vector3 v3)
-{
-	Vector3 side1, side2, normal;
-	side1 = Vec3Sub(v2, v1);
-	side2  = Vec3Sub(v3, v1);
-	normal = Vec3Cross(side1, side2);
-	normal = Vec3Normalize(normal);      
-	return normal;
-}
-
-float RBGetNormalProjection(Vector3 point, Vector3 v1, Vector3 v2, Vector3 v3)
-{
-	Vector3 normal, vect;
-	normal = RBGetNormal(v1, v2, v3);
-	vect = Vec3Sub(point, v1);
-	return Vec3Dot(vect, normal);
-}
-
-bool RBCheckCollisionPoint(Rigidbody *rigidbody, Vector3 point, Vector3 *normal, float *penetrationDistance)
-{
-	float projection;
-	int i;
-	int hitFace;
-	float minProjection = 1;
-	float const depthEpsilon = 0.001f;
-
-	/* Clockwise winding */
-	int indexes[6][3] =  {{ 7, 6, 2 },	/* Front */
-						  { 5, 4, 0 },	/* Back */
-						  { 4, 5, 6 },	/* Top */
-						  { 1, 2, 3 },	/* Bottom */
-						  { 4, 7, 1 },	/* Left */
-						  { 6, 5, 3 }};	/* Right */
-
-	for (i = 0; i < 6; i++)
-	{
-		projection = RBGetNormalProjection(point, rigidbody->vertices[indexes[i][0]], rigidbody->vertices[indexes[i][1]], rigidbody->vertices[indexes[i][2]]);
-
-		if (projection >= 0)
-			return false; /* Found a seperating axis */
-		else
-		{
-			if (projection > minProjection || minProjection == 1)
-			{
-				minProjection = projection;
-				hitFace = i;
-			}
-		}
-	}
-
-	*penetrationDistance = minProjection;
-	*normal = RBGetNormal(rigidbody->vertices[indexes[hitFace][0]], rigidbody->vertices[indexes[hitFace][1]], rigidbody->vertices[indexes[hitFace][2]]);
-
-	return true;
-}
-
-void RBCheckCollisionBody(Rigidbody *rigidbody, Rigidbody *other)
-{
-	unsigned i;
-	bool result;
-	Vector3 normal;
-	float penetrationDistance;
-
-	/* test rigidbody verts against other */
-	for (i = 0; i < rigidbody->numVerts; i++)
-    {
-		result = RBCheckCollisionPoint(other, rigidbody->vertices[i], &normal, &penetrationDistance);
-
-		if (result)
-		{
-			rigidbody->Collision.normal = normal;
-			rigidbody->Collision.contactPoint = rigidbody->vertices[i];
-			rigidbody->Collision.state = COLLIDING;
-			rigidbody->position = Vec3Add(rigidbody->position, Vec3Mult(rigidbody->Collision.normal, -penetrationDistance));
-			return;
-		}
-	}
-
-	/* test other verts against rigidbody */
-	for (i = 0; i < rigidbody->numVerts; i++)
-    {
-		result = RBCheckCollisionPoint(rigidbody, other->vertices[i], &normal, &penetrationDistance);
-
-		if (result)
-		{
-			rigidbody->Collision.normal = Vec3New(-normal.x, -normal.y, -normal.z);
-			rigidbody->Collision.contactPoint = other->vertices[i];
-			rigidbody->Collision.state = COLLIDING;
-			rigidbody->position = Vec3Add(rigidbody->position, Vec3Mult(rigidbody->Collision.normal, -penetrationDistance));
-			return;
-		}
-	}
-}
+
+#include "Rigidbody.h"
+#include "MathUtils.h"
+
+const float GRAVITY = 20;
+const float LINEAR_DAMPING = 0.1f;
+const float ANGULAR_DAMPING = 0.3f;
+const float HORIZONTAL_FRICTION = 0.8f;
+const float VERTICAL_FRICTION = 0.04f;
+const float ANGULAR_FRICTION = 0.08f;
+const float BOUNCE_FACTOR = 0.6f;
+const float MASS_MULTIPLIER = 8.0f;
+
+/* Initialises a rigidbody with the given shape, mass multiplier and bounce factor. */
+static void InitShape(Rigidbody *rigidbody, ShapeType shape, Vector3 position, Vector3 dimensions, float density, float massMultiplier, float bounceFactor);
+
+void RBParamsInit(RigidbodyParams *params)
+{
+	params->gravity = GRAVITY;
+	params->linearDamping = LINEAR_DAMPING;
+	params->angularDamping = ANGULAR_DAMPING;
+	params->horizontalFriction = HORIZONTAL_FRICTION;
+	params->verticalFriction = VERTICAL_FRICTION;
+	params->angularFriction = ANGULAR_FRICTION;
+	params->massMultiplier = MASS_MULTIPLIER;
+	params->bounceFactor = BOUNCE_FACTOR;
+}
+
+void RBInit(Rigidbody *rigidbody, Vector3 position, Vector3 dimensions, float density)
+{
+	RBInitShape(rigidbody, SHAPE_BOX, position, dimensions, density);
+}
+
+void RBInitShape(Rigidbody *rigidbody, ShapeType shape, Vector3 position, Vector3 dimensions, float density)
+{
+	InitShape(rigidbody, shape, position, dimensions, density, MASS_MULTIPLIER, BOUNCE_FACTOR);
+}
+
+/* Initialises a rigidbody with the given shape, mass multiplier and bounce factor. */
+static void InitShape(Rigidbody *rigidbody, ShapeType shape, Vector3 position, Vector3 dimensions, float density, float massMultiplier, float bounceFactor)
+{
+	Vector3 a, b, c, sum, normal;
+	Matrix3x3 covariance, inertia;
+	float det, volume = 0;
+	unsigned i, j;
+
+	rigidbody->position = position;
+	rigidbody->dimensions = dimensions;
+	rigidbody->density = density;
+	rigidbody->shapeType = shape;
+	rigidbody->shape = ShapeGet(shape);
+
+	/* start at rest */
+	rigidbody->velocity = Vec3New(0, 0, 0);
+	rigidbody->angularMomentum = Vec3New(0, 0, 0);
+	rigidbody->angularVelocity = Vec3New(0, 0, 0);
+
+	/* init vertices - shape is scaled to the dimensions */
+	rigidbody->numVerts = rigidbody->shape->numVerts;
+	rigidbody->outsideRadius = 0;
+	for (i = 0; i < rigidbody->numVerts; i++)
+	{
+		a = rigidbody->shape->vertices[i];
+		rigidbody->bodyVertices[i] = Vec3New(a.x * dimensions.x, a.y * dimensions.y, a.z * dimensions.z);
+
+		if (Vec3Magnitude(rigidbody->bodyVertices[i]) > rigidbody->outsideRadius)
+			rigidbody->outsideRadius = Vec3Magnitude(rigidbody->bodyVertices[i]);
+	}
+
+	/* init face planes - normals scale by the inverse of the dimensions */
+	rigidbody->numFaces = rigidbody->shape->numFaces;
+	rigidbody->insideRadius = 0;
+	for (i = 0; i < rigidbody->numFaces; i++)
+	{
+		normal = rigidbody->shape->normals[i];
+		normal = Vec3Normalize(Vec3New(normal.x / dimensions.x, normal.y / dimensions.y, normal.z / dimensions.z));
+		rigidbody->bodyNormals[i] = normal;
+		rigidbody->bodyDistances[i] = Vec3Dot(normal, rigidbody->bodyVertices[rigidbody->shape->faces[i][0]]);
+
+		if (i == 0 || rigidbody->bodyDistances[i] < rigidbody->insideRadius)
+			rigidbody->insideRadius = rigidbody->bodyDistances[i];
+	}
+
+	/* calc volume and covariance from tetrahedra joining each face triangle to the centre */
+	covariance = M3Scale(M3New(), 0);
+	for (i = 0; i < rigidbody->numFaces; i++)
+	{
+		a = rigidbody->bodyVertices[rigidbody->shape->faces[i][0]];
+		for (j = 1; j + 1 < (unsigned)rigidbody->shape->numFaceVerts[i]; j++)
+		{
+			b = rigidbody->bodyVertices[rigidbody->shape->faces[i][j]];
+			c = rigidbody->bodyVertices[rigidbody->shape->faces[i][j + 1]];
+			det = Vec3Dot(a, Vec3Cross(b, c));
+			sum = Vec3Add(Vec3Add(a, b), c);
+
+			volume += det / 6;
+			covariance = M3Add(covariance, M3Scale(M3Add(M3Add(M3OuterProduct(a, a), M3OuterProduct(b, b)),
+				M3Add(M3OuterProduct(c, c), M3OuterProduct(sum, sum))), det / 120));
+		}
+	}
+
+	/* calc mass - the multiplier is per eighth of the volume */
+	rigidbody->mass = massMultiplier * density * volume / 8;
+	covariance = M3Scale(covariance, massMultiplier * density / 8);
+
+	/* calc inertia tensor - trace of the covariance on the diagonal minus the covariance */
+	inertia = M3Add(M3Scale(M3New(), covariance.elements[0][0] + covariance.elements[1][1] + covariance.elements[2][2]), M3Scale(covariance, -1));
+	rigidbody->inverseBodyInertiaTensor = M3Inverse(inertia);
+
+	/* bounce factor */
+	rigidbody->coefficientOfRestitution = bounceFactor;
+
+	/* set orientation to identity */
+	rigidbody->orientation = M3New();
+	rigidbody->inverseWorldInertiaTensor = rigidbody->inverseBodyInertiaTensor;
+}
+
+void RBSaveState(Rigidbody *rigidbody, RigidbodyState *state)
+{
+	state->shape = rigidbody->shapeType;
+	state->density = rigidbody->density;
+	state->dimensions = rigidbody->dimensions;
+	state->position = rigidbody->position;
+	state->orientation = rigidbody->orientation;
+	state->velocity = rigidbody->velocity;
+	state->angularMomentum = rigidbody->angularMomentum;
+}
+
+void RBRestoreState(Rigidbody *rigidbody, RigidbodyState *state, RigidbodyParams *params)
+{
+	/* rebuild shape, mass and body inertia */
+	InitShape(rigidbody, state->shape, state->position, state->dimensions, state->density, params->massMultiplier, params->bounceFactor);
+
+	rigidbody->orientation = state->orientation;
+	rigidbody->velocity = state->velocity;
+	rigidbody->angularMomentum = state->angularMomentum;
+
+	/* derived values - calculated the same way as RBIntegratePosition so the restored body is identical */
+	rigidbody->inverseWorldInertiaTensor = M3Mult(M3Mult(rigidbody->orientation, rigidbody->inverseBodyInertiaTensor), M3Transpose(rigidbody->orientation));
+	rigidbody->angularVelocity = M3TransformVector(rigidbody->inverseWorldInertiaTensor, rigidbody->angularMomentum);
+	RBCalculateVertices(rigidbody);
+}
+
+Vector3 RBAngularMomentumForSpin(RigidbodyState *state, Vector3 angularVelocity, RigidbodyParams *params)
+{
+	Rigidbody rigidbody;
+	Matrix3x3 inverseWorldInertiaTensor;
+
+	/* the inertia of the shape, turned to the state's orientation */
+	InitShape(&rigidbody, state->shape, state->position, state->dimensions, state->density, params->massMultiplier, params->bounceFactor);
+	inverseWorldInertiaTensor = M3Mult(M3Mult(state->orientation, rigidbody.inverseBodyInertiaTensor), M3Transpose(state->orientation));
+
+	return M3TransformVector(M3Inverse(inverseWorldInertiaTensor), angularVelocity);
+}
+
+void RBCalculateVertices(Rigidbody *rigidbody)
+{        
+	unsigned i;
+	Vector3 temp;
+
+	rigidbody->boundsMin = rigidbody->boundsMax = rigidbody->position;
+	for(i = 0; i < rigidbody->numVerts; i++)
+    {
+		temp = M3TransformVector(rigidbody->orientation, rigidbody->bodyVertices[i]);
+        rigidbody->vertices[i] = Vec3Add(rigidbody->position, temp);
+
+		rigidbody->boundsMin = Vec3New(Min(rigidbody->boundsMin.x, rigidbody->vertices[i].x), Min(rigidbody->boundsMin.y, rigidbody->vertices[i].y),
+			Min(rigidbody->boundsMin.z, rigidbody->vertices[i].z));
+		rigidbody->boundsMax = Vec3New(Max(rigidbody->boundsMax.x, rigidbody->vertices[i].x), Max(rigidbody->boundsMax.y, rigidbody->vertices[i].y),
+			Max(rigidbody->boundsMax.z, rigidbody->vertices[i].z));
+    }
+}
+
+bool RBBoundsOverlap(Rigidbody *a, Rigidbody *b, float margin)
+{
+	if (Vec3Magnitude(Vec3Sub(a->position, b->position)) > a->outsideRadius + b->outsideRadius + margin)
+		return false;
+
+	return a->boundsMin.x <= b->boundsMax.x + margin && b->boundsMin.x <= a->boundsMax.x + margin &&
+		a->boundsMin.y <= b->boundsMax.y + margin && b->boundsMin.y <= a->boundsMax.y + margin &&
+		a->boundsMin.z <= b->boundsMax.z + margin && b->boundsMin.z <= a->boundsMax.z + margin;
+}
+
+void RBApplyForces(Rigidbody *rigidbody, RigidbodyParams *params)
+{
+	/* clear last updates forces */
+	rigidbody->torque = Vec3New(0, 0, 0);
+	rigidbody->force = Vec3New(0, 0, 0);
+
+	/* apply gravity */
+	rigidbody->force.y -= params->gravity * rigidbody->mass;
+
+	/* apply damping (air resistance) */
+	rigidbody->force = Vec3Add(rigidbody->force, Vec3Mult(rigidbody->velocity, -params->linearDamping));
+	rigidbody->torque = Vec3Add(rigidbody->torque, Vec3Mult(rigidbody->angularVelocity, -params->angularDamping));
+
+	/* apply friction if touching floor */
+	if (rigidbody->position.y <= rigidbody->insideRadius + 0.003f)
+	{
+		rigidbody->force.x *= params->horizontalFriction;
+		rigidbody->force.z *= params->horizontalFriction;
+		rigidbody->force.y *= params->verticalFriction;
+
+		rigidbody->velocity.x *= params->horizontalFriction;
+		rigidbody->velocity.z *= params->horizontalFriction;
+		rigidbody->velocity.y *= params->verticalFriction;
+
+		rigidbody->torque.y *= params->angularFriction;
+		rigidbody->angularVelocity.y *= params->angularFriction;
+	}
+}
+
+void RBIntegrateVelocity(Rigidbody *rigidbody, float deltaTime)
+{
+	/* calculate new velocities by Euler intergration */
+	rigidbody->velocity = Vec3Add(rigidbody->velocity, Vec3Mult(rigidbody->force, deltaTime / rigidbody->mass));
+	rigidbody->angularMomentum = Vec3Add(rigidbody->angularMomentum, Vec3Mult(rigidbody->torque, deltaTime));
+	rigidbody->angularVelocity = M3TransformVector(rigidbody->inverseWorldInertiaTensor, rigidbody->angularMomentum);
+}
+
+void RBIntegratePosition(Rigidbody *rigidbody, float deltaTime)
+{
+	Matrix3x3 newOrientation;
+
+	/* move with the new velocities - semi-implicit, so contact impulses act in the same step */
+	rigidbody->position = Vec3Add(rigidbody->position, Vec3Mult(rigidbody->velocity, deltaTime));
+
+	newOrientation = M3Add(rigidbody->orientation, M3Scale(M3Mult(M3SkewSymetricFromVector(rigidbody->angularVelocity), rigidbody->orientation), deltaTime));
+	rigidbody->orientation = M3Orthonormalize(newOrientation);
+
+	rigidbody->inverseWorldInertiaTensor = M3Mult(M3Mult(rigidbody->orientation, rigidbody->inverseBodyInertiaTensor), M3Transpose(rigidbody->orientation));
+	rigidbody->angularVelocity = M3TransformVector(rigidbody->inverseWorldInertiaTensor, rigidbody->angularMomentum);
+}
+
+void RBApplyImpulse(Rigidbody *rigidbody, Vector3 impulse, Vector3 offset)
+{
+	rigidbody->velocity = Vec3Add(rigidbody->velocity, Vec3Mult(impulse, 1.0f / rigidbody->mass));
+	rigidbody->angularMomentum = Vec3Add(rigidbody->angularMomentum, Vec3Cross(offset, impulse));
+	rigidbody->angularVelocity = M3TransformVector(rigidbody->inverseWorldInertiaTensor, rigidbody->angularMomentum);
+}
+
+Vector3 RBPointVelocity(Rigidbody *rigidbody, Vector3 offset)
+{
+	return Vec3Add(rigidbody->velocity, Vec3Cross(rigidbody->angularVelocity, offset));
+}
+
+Vector3 RBGetNormal(Vector3 v1, Vector3 v2, Vector3 v3)
+{
+	Vector3 side1, side2, normal;
+	side1 = Vec3Sub(v2, v1);
+	side2  = Vec3Sub(v3, v1);
+	normal = Vec3Cross(side1, side2);
+	normal = Vec3Normalize(normal);      
+	return normal;
+}
+
+float RBGetNormalProjection(Vector3 point, Vector3 v1, Vector3 v2, Vector3 v3)
+{
+	Vector3 normal, vect;
+	normal = RBGetNormal(v1, v2, v3);
+	vect = Vec3Sub(point, v1);
+	return Vec3Dot(vect, normal);
+}
+
+float RBPointDistance(Rigidbody *rigidbody, Vector3 point, Vector3 direction, int *face)
+{
+	const float levelTolerance = 0.005f;
+	float projections[MAX_FACES];
+	float maxProjection = 0, alignment, bestAlignment = 0;
+	unsigned i;
+	Vector3 local;
+
+	/* move point and direction into body space where the face planes are known */
+	local = M3TransformVector(M3Transpose(rigidbody->orientation), Vec3Sub(point, rigidbody->position));
+	direction = M3TransformVector(M3Transpose(rigidbody->orientation), direction);
+
+	for (i = 0; i < rigidbody->numFaces; i++)
+	{
+		projections[i] = Vec3Dot(local, rigidbody->bodyNormals[i]) - rigidbody->bodyDistances[i];
+		if (i == 0 || projections[i] > maxProjection)
+			maxProjection = projections[i];
+	}
+
+	/* a point on an edge or corner is level with several faces - take the one facing the direction */
+	*face = -1;
+	for (i = 0; i < rigidbody->numFaces; i++)
+	{
+		alignment = Vec3Dot(rigidbody->bodyNormals[i], direction);
+		if (projections[i] >= maxProjection - levelTolerance && (*face < 0 || alignment > bestAlignment))
+		{
+			bestAlignment = alignment;
+			*face = i;
+		}
+	}
+
+	return projections[*face];
+}
+
+float RBSegmentDistance(Rigidbody *rigidbody, Vector3 start, Vector3 end, float *fraction, int *face)
+{
+	float heights[MAX_FACES], slopes[MAX_FACES];
+	float t = 0, crossing, next;
+	int active = 0, overtaking;
+	unsigned i, step;
+	Matrix3x3 inverse = M3Transpose(rigidbody->orientation);
+	Vector3 local, direction;
+
+	/* each face's distance along the segment is a line, heights[i] + slopes[i] * t - every shape
+	   has faces, so the first starts as the highest */
+	local = M3TransformVector(inverse, Vec3Sub(start, rigidbody->position));
+	direction = M3TransformVector(inverse, Vec3Sub(end, start));
+	heights[0] = Vec3Dot(local, rigidbody->bodyNormals[0]) - rigidbody->bodyDistances[0];
+	slopes[0] = Vec3Dot(direction, rigidbody->bodyNormals[0]);
+	for (i = 1; i < rigidbody->numFaces; i++)
+	{
+		heights[i] = Vec3Dot(local, rigidbody->bodyNormals[i]) - rigidbody->bodyDistances[i];
+		slopes[i] = Vec3Dot(direction, rigidbody->bodyNormals[i]);
+		if (heights[i] > heights[active] || (heights[i] == heights[active] && slopes[i] > slopes[active]))
+			active = i;
+	}
+
+	/* follow the highest line down until it starts rising - each step changes to a steeper line,
+	   so there are fewer steps than faces */
+	for (step = 0; step < rigidbody->numFaces && slopes[active] < 0 && t < 1; step++)
+	{
+		next = 1;
+		overtaking = -1;
+		for (i = 0; i < rigidbody->numFaces; i++)
+		{
+			if (slopes[i] <= slopes[active])
+				continue;
+
+			crossing = (heights[active] - heights[i]) / (slopes[i] - slopes[active]);
+			if (crossing < t)
+				crossing = t;
+			if (crossing < next || (crossing == next && overtaking >= 0 && slopes[i] > slopes[overtaking]))
+			{
+				next = crossing;
+				overtaking = i;
+			}
+		}
+
+		t = next;
+		if (overtaking < 0)
+			break;
+		active = overtaking;
+	}
+
+	*fraction = t;
+	*face = active;
+	return heights[active] + slopes[active] * t;
+}
+
+Vector3 RBSupport(Rigidbody *rigidbody, Vector3 direction, int *vertex)
+{
+	const Shape *shape = rigidbody->shape;
+	Vector3 local;
+	float best, projection;
+	int i, next, current;
+
+	/* compare in body space, against the untransformed vertices */
+	local = M3TransformVector(M3Transpose(rigidbody->orientation), direction);
+	best = Vec3Dot(rigidbody->bodyVertices[*vertex], local);
+
+	/* move to the best neighbour until there is none better - on a convex shape that is the furthest vertex */
+	do
+	{
+		current = *vertex;
+		for (i = 0; i < shape->numNeighbours[current]; i++)
+		{
+			next = shape->neighbours[current][i];
+			projection = Vec3Dot(rigidbody->bodyVertices[next], local);
+			if (projection > best)
+			{
+				best = projection;
+				*vertex = next;
+			}
+		}
+	}
+	while (*vertex != current);
+
+	return rigidbody->vertices[*vertex];
+}
@@ -1,183 +1,308 @@
-
-#ifndef RIGIDBODY_H
-#define RIGIDBODY_H
-
-#include "Matrix3x3.h"
-#include "Vector3.h"
-#include "Boolean.h"
-
-/**
- * @brief	Defines the maximum amount of verticies a rigidbody can have. 
- */
-enum { MAX_VERTS = 8 }; /* const int MAX_VERTS = 8; doesnt work, can't declare array with const size, only #define or enum */
-
-extern const float GRAVITY;
-extern const float LINEAR_DAMPING;
-extern const float ANGULAR_DAMPING;
-extern const float HORIZONTAL_FRICTION;
-extern const float VERTICAL_FRICTION;
-extern const float ANGULAR_FRICTION;
-
-/**
- * @brief	Values that represent collision states. 
- */
-enum CollisionState { NO_COLLISION, COLLIDING, PENETRATING };
-typedef enum CollisionState CollisionState;
-
-/**
- * @brief	Rigidbody. 
- * @author	Matt Drage
- * @date	11/03/2012
- */
-struct Rigidbody
-{
-	float mass;
-	Matrix3x3 inverseBodyInertiaTensor;		/* initial resistance to changes in rotation */
-	float coefficientOfRestitution;			/* collision 'bounce' amount */
-
-	unsigned numVerts;
-	Vector3 bodyVertices[MAX_VERTS];		/* vertices before transformation */
-	Vector3 vertices[MAX_VERTS];			/* transformed vertices */
-
-	Vector3 dimensions;
-
-	Vector3 position;
-	Matrix3x3 orientation;
-	Vector3 velocity;
-	Vector3 angularMomentum;
-	Vector3 force;							/* linear force */
-	Vector3 torque;							/* rotational force */
-
-	Matrix3x3 inverseWorldInertiaTensor;	/* current resistance to changes in rotation */
-	Vector3 angularVelocity;				/* speed of rotation in each axis */
-
-	struct CollisionType
-	{
-		CollisionState state;				/* currently colliding, penetrating, or no collisions */
-		Vector3 normal;						/* normal of collision plane */
-		Vector3 contactPoint;				/* point of contact */
-	} Collision;	
-};
-typedef struct Rigidbody Rigidbody;
-
-/**
- * @brief	Initialises a rigidbody.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	rigidbody		The rigidbody.
- * @param	position		The position.
- * @param	dimensions		The dimensions.
- * @param	density			The density.
- */
-void RBInit(Rigidbody *rigidbody, Vector3 position, Vector3 dimensions, float density);
-
-/**
- * @brief	Calculates a rigidbodys transformed vertices.
- * @detaisl	Call after moving and before checking collisions
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	rigidbody	The rigidbody.
- */
-void RBCalculateVertices(Rigidbody *rigidbody);
-
-/**
- * @brief	Applys forces to a rigidbody. eg. gravity.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	rigidbody	The rigidbody.
- */
-void RBApplyForces(Rigidbody *rigidbody);
-
-/**
- * @brief	Integrates the rigidbodys parameters with respect to time.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	rigidbody	The rigidbody.
- * @param	deltaTime	Time period to integrate over.
- */
-void RBIntegrate(Rigidbody *rigidbody, float deltaTime);
-
-/**
- * @brief	Checks rigidbody for collision with the floor.
- * @details	Foor is poisitioned at y = 0
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	rigidbody	The rigidbody.
- */
-void RBCheckCollisionFloor(Rigidbody *rigidbody);
-
-/**
- * @brief	Resolves rigidbody collisions using impulse forces.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	rigidbody	The rigidbody.
- */
-void RBResolveCollisions(Rigidbody *rigidbody);
-
-/**
- * @brief	Force the rigidbody to move out of the floor.
- * @details	Not strictly physically accurate. Call to ensure rigidbody does not get stuck.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	rigidbody	The rigidbody.
- */
-void RBMoveOutOfFloor(Rigidbody *rigidbody);
-
-/**
- * @brief	Move rigidbody out of other rigidbody.
- * @details	Not strictly physically accurate. Call to ensure rigidbody does not get stuck.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	rigidbody	The rigidbody.
- * @param	other	 	The other rigidbody.
- */
-void RBMoveOutOfBody(Rigidbody *rigidbody, Rigidbody *other);
-
-/**
- * @brief	Gets the normal of a plane defined by three vertices.
- * @detials	Used internally by RBGetNormalProjection.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	v1	The first vertex.
- * @param	v2	The second vertex.
- * @param	v3	The third vertex.
- * @return	The normal of the plane.
- */
-Vector3 RBGetNormal(Vector3 v1, Vector3 v2, Vector3 v3);
-
-/**
- * @brief	Get the projection of a point from a plane defined by three vertices.
- * @detials	Used internally by RBCheckCollisionPoint.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	point	The point.
- * @param	v1   	The first vertex.
- * @param	v2   	The second vertex.
- * @param	v3   	The third vertex.
- * @return	The projection.
- */
-float RBGetNormalProjection(Vector3 point, Vector3 v1, Vector3 v2, Vector3 v3);
-
-/**
- * @brief	Checks whether a rigidbody is colliding with a point.
- * @detials	Used internally by RBCheckCollisionBody.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	rigidbody		   	The rigidbody.
- * @param	point				The point.
- * @param	normal			   	The normal.
- * @param 	penetrationDistance	The penetration distance.
- * @return	true if collision, false if not.
- */
-bool RBCheckCollisionPoint(Rigidbody *rigidbody, Vector3 point, Vector3 *normal, float *penetrationDistance);
-
-/**
- * @brief	Checks for collision between two rigidbodys.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	rigidbody	The rigidbody.
- * @param 	other	 	The other rigidbody.
- */
-void RBCheckCollisionBody(Rigidbody *rigidbody, Rigidbody *other);
-
-#endif
+
+#ifndef RIGIDBODY_H
+#define RIGIDBODY_H
+
+#include "Matrix3x3.h"
+#include "Vector3.h"
+#include "Boolean.h"
+#include "Shape.h"
+
+extern const float GRAVITY;
+extern const float LINEAR_DAMPING;
+extern const float ANGULAR_DAMPING;
+extern const float HORIZONTAL_FRICTION;
+extern const float VERTICAL_FRICTION;
+extern const float ANGULAR_FRICTION;
+extern const float BOUNCE_FACTOR;
+extern const float MASS_MULTIPLIER;
+
+/**
+ * @brief	The forces on rigidbodys and what they are made of, which can be set per scene.
+ * @details	RBParamsInit fills in the defaults above. Mass and bounce are properties of each
+ * 			body, calculated from massMultiplier and bounceFactor when it is restored into a
+ * 			scene, so changing them doesn't affect bodies already there.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct RigidbodyParams
+{
+	float gravity;
+	float linearDamping;
+	float angularDamping;
+	float horizontalFriction;				/* fraction of horizontal force and velocity kept on the floor */
+	float verticalFriction;
+	float angularFriction;					/* fraction of spin about the vertical kept on the floor */
+	float massMultiplier;					/* mass per eighth of the volume at density 1 */
+	float bounceFactor;						/* coefficient of restitution */
+};
+typedef struct RigidbodyParams RigidbodyParams;
+
+/**
+ * @brief	Rigidbody. 
+ * @author	Matt Drage
+ * @date	11/03/2012
+ */
+struct Rigidbody
+{
+	float density;
+	float mass;
+	Matrix3x3 inverseBodyInertiaTensor;		/* initial resistance to changes in rotation */
+	float coefficientOfRestitution;			/* collision 'bounce' amount */
+
+	ShapeType shapeType;
+	const Shape *shape;						/* faces and edges, shared by every body of this type */
+
+	unsigned numVerts;
+	Vector3 bodyVertices[MAX_VERTS];		/* vertices before transformation */
+	Vector3 vertices[MAX_VERTS];			/* transformed vertices */
+	Vector3 boundsMin, boundsMax;			/* world box around the transformed vertices */
+
+	unsigned numFaces;
+	Vector3 bodyNormals[MAX_FACES];			/* outward face normals before transformation */
+	float bodyDistances[MAX_FACES];			/* distance of each face plane from the centre */
+	float insideRadius;						/* distance from the centre to the nearest face */
+	float outsideRadius;					/* distance from the centre to the furthest vertex */
+
+	Vector3 dimensions;
+
+	Vector3 position;
+	Matrix3x3 orientation;
+	Vector3 velocity;
+	Vector3 angularMomentum;
+	Vector3 force;							/* linear force */
+	Vector3 torque;							/* rotational force */
+
+	Matrix3x3 inverseWorldInertiaTensor;	/* current resistance to changes in rotation */
+	Vector3 angularVelocity;				/* speed of rotation in each axis */
+};
+typedef struct Rigidbody Rigidbody;
+
+/**
+ * @brief	The minimal state needed to recreate a rigidbody.
+ * @details	Derived values (vertices, mass, inertia tensors, angular velocity) are recalculated
+ * 			on restore. Force and torque are recalculated every step.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct RigidbodyState
+{
+	ShapeType shape;
+	float density;
+	Vector3 dimensions;
+	Vector3 position;
+	Matrix3x3 orientation;
+	Vector3 velocity;
+	Vector3 angularMomentum;
+};
+typedef struct RigidbodyState RigidbodyState;
+
+/**
+ * @brief	Fills in the default forces.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	params	The params.
+ */
+void RBParamsInit(RigidbodyParams *params);
+
+/**
+ * @brief	Initialises a rigidbody.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param 	rigidbody		The rigidbody.
+ * @param	position		The position.
+ * @param	dimensions		The dimensions.
+ * @param	density			The density.
+ */
+void RBInit(Rigidbody *rigidbody, Vector3 position, Vector3 dimensions, float density);
+
+/**
+ * @brief	Initialises a rigidbody with the given shape.
+ * @details	The shape is scaled to fit the dimensions. Mass and inertia are calculated by
+ * 			splitting the shape into tetrahedra from its centre, with MASS_MULTIPLIER and
+ * 			BOUNCE_FACTOR.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rigidbody		The rigidbody.
+ * @param	shape			The shape.
+ * @param	position		The position.
+ * @param	dimensions		The size of the shape's bounding box.
+ * @param	density			The density.
+ */
+void RBInitShape(Rigidbody *rigidbody, ShapeType shape, Vector3 position, Vector3 dimensions, float density);
+
+/**
+ * @brief	Saves the state of a rigidbody.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rigidbody	The rigidbody.
+ * @param 	state	 	The state to write to.
+ */
+void RBSaveState(Rigidbody *rigidbody, RigidbodyState *state);
+
+/**
+ * @brief	Restores a rigidbody from a saved state.
+ * @details	Restored rigidbodys continue exactly as the original would have, given the same params.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rigidbody	The rigidbody.
+ * @param 	state	 	The saved state.
+ * @param 	params	 	The params of the scene, which give the mass and bounce.
+ */
+void RBRestoreState(Rigidbody *rigidbody, RigidbodyState *state, RigidbodyParams *params);
+
+/**
+ * @brief	Gets the angular momentum that makes a body spin at an angular velocity.
+ * @details	For filling in RigidbodyState.angularMomentum from a spin, eg. to throw a body.
+ * 			Uses the state's shape, dimensions, density and orientation.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	state			The body's state.
+ * @param 	angularVelocity	The spin, in radians per second about each world axis.
+ * @param 	params			The params of the scene the body will be restored into.
+ * @return	The angular momentum.
+ */
+Vector3 RBAngularMomentumForSpin(RigidbodyState *state, Vector3 angularVelocity, RigidbodyParams *params);
+
+/**
+ * @brief	Calculates a rigidbodys transformed vertices, and the box around them.
+ * @detaisl	Call after moving and before checking collisions
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param 	rigidbody	The rigidbody.
+ */
+void RBCalculateVertices(Rigidbody *rigidbody);
+
+/**
+ * @brief	Checks whether two rigidbodys could be within a distance of each other.
+ * @details	Compares bounding spheres, then boxes - both are cheap, so far apart bodies are
+ * 			rejected before any vertex is looked at.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	a	 	The first rigidbody. Vertices must be calculated.
+ * @param 	b	 	The second rigidbody. Vertices must be calculated.
+ * @param 	margin	The distance.
+ * @return	false if the rigidbodys are further apart than the margin.
+ */
+bool RBBoundsOverlap(Rigidbody *a, Rigidbody *b, float margin);
+
+/**
+ * @brief	Applys forces to a rigidbody. eg. gravity.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param 	rigidbody	The rigidbody.
+ * @param 	params   	The forces.
+ */
+void RBApplyForces(Rigidbody *rigidbody, RigidbodyParams *params);
+
+/**
+ * @brief	Integrates the rigidbodys velocities with respect to time.
+ * @details	Call before solving contacts, which correct the new velocities.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rigidbody	The rigidbody.
+ * @param	deltaTime	Time period to integrate over.
+ */
+void RBIntegrateVelocity(Rigidbody *rigidbody, float deltaTime);
+
+/**
+ * @brief	Integrates the rigidbodys position and orientation with respect to time.
+ * @details	Uses the velocities left by the contact solver.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rigidbody	The rigidbody.
+ * @param	deltaTime	Time period to integrate over.
+ */
+void RBIntegratePosition(Rigidbody *rigidbody, float deltaTime);
+
+/**
+ * @brief	Applies an impulse to a rigidbody.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rigidbody	The rigidbody.
+ * @param	impulse  	The impulse.
+ * @param	offset   	Where the impulse is applied, relative to the rigidbody's position.
+ */
+void RBApplyImpulse(Rigidbody *rigidbody, Vector3 impulse, Vector3 offset);
+
+/**
+ * @brief	Gets the velocity of a point on a rigidbody.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rigidbody	The rigidbody.
+ * @param	offset   	The point, relative to the rigidbody's position.
+ * @return	The velocity.
+ */
+Vector3 RBPointVelocity(Rigidbody *rigidbody, Vector3 offset);
+
+/**
+ * @brief	Gets the normal of a plane defined by three vertices.
+ * @detials	Used internally by RBGetNormalProjection.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	v1	The first vertex.
+ * @param	v2	The second vertex.
+ * @param	v3	The third vertex.
+ * @return	The normal of the plane.
+ */
+Vector3 RBGetNormal(Vector3 v1, Vector3 v2, Vector3 v3);
+
+/**
+ * @brief	Get the projection of a point from a plane defined by three vertices.
+ * @detials	Used internally by RBCheckCollisionPoint.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	point	The point.
+ * @param	v1   	The first vertex.
+ * @param	v2   	The second vertex.
+ * @param	v3   	The third vertex.
+ * @return	The projection.
+ */
+float RBGetNormalProjection(Vector3 point, Vector3 v1, Vector3 v2, Vector3 v3);
+
+/**
+ * @brief	Gets the distance of a point outside a rigidbody.
+ * @details	The point is moved into body space and tested against the precomputed face planes.
+ * 			The distance is that of the face plane the point is furthest in front of - exact
+ * 			inside the rigidbody and over a face, an underestimate past an edge or corner. Of
+ * 			faces level with the point (eg. at an edge) the one facing the direction is used.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rigidbody	The rigidbody.
+ * @param	point		The point.
+ * @param	direction	The preferred face normal, in world space.
+ * @param	face		Set to the index of the face.
+ * @return	The distance from the face, negative if the point is inside.
+ */
+float RBPointDistance(Rigidbody *rigidbody, Vector3 point, Vector3 direction, int *face);
+
+/**
+ * @brief	Finds the point of a line segment deepest inside, or nearest to, a rigidbody.
+ * @details	Distance is measured as by RBPointDistance. Along the segment that is the highest of
+ * 			one line per face, so its lowest point is found exactly by following the highest
+ * 			line from the start. If the segment runs level with a face the first lowest point
+ * 			is found - search from the end too for the other.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rigidbody	The rigidbody.
+ * @param	start		The start of the segment.
+ * @param	end			The end of the segment.
+ * @param	fraction	Set to how far along the segment the point is, from 0 to 1.
+ * @param	face		Set to the index of the face.
+ * @return	The distance from the face, negative if the point is inside.
+ */
+float RBSegmentDistance(Rigidbody *rigidbody, Vector3 start, Vector3 end, float *fraction, int *face);
+
+/**
+ * @brief	Finds the vertex of a rigidbody furthest in a direction.
+ * @details	Hill climbs along the shape's edges from a starting vertex, so a start near the
+ * 			answer (eg. the previous result) takes very few steps.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rigidbody	The rigidbody. Vertices must be calculated.
+ * @param	direction	The direction in world space.
+ * @param 	vertex   	The vertex to start from, set to the index of the vertex found.
+ * @return	The vertex position in world space.
+ */
+Vector3 RBSupport(Rigidbody *rigidbody, Vector3 direction, int *vertex);
+
+#endif
@@ -0,0 +1,119 @@
+#include "Roll.h"
+#include "Scene.h"
+#include "Rigidbody.h"
+#include "MathUtils.h"
+#include <string.h>
+#include <math.h>
+
+static const float ROLL_TIME_STEP = 1.0f / 200.0f;
+static const float ROLL_MAX_TIME = 30.0f;
+const float REST_SPEED = 0.05f;					/* speed below which the die is still */
+const int REST_STEPS = 40;						/* steps it must stay still for */
+
+void RollParamsInit(RollParams *params, unsigned seed, ShapeType shape, Vector3 dimensions, float density, Vector3 position, Vector3 velocity, Vector3 spin)
+{
+	memset(params, 0, sizeof(RollParams));
+	params->seed = seed;
+	params->shape = shape;
+	params->density = density;
+	params->dimensions = dimensions;
+	params->position = position;
+	params->velocity = velocity;
+	params->spin = spin;
+
+	SceneParamsInit(&params->physics);
+}
+
+int RollGetFace(Rigidbody *rb)
+{
+	/* world up in body space is the second row of the orientation */
+	float *up = rb->orientation.elements[1];
+	Vector3 bodyUp = Vec3New(up[0], up[1], up[2]);
+	float projection, best = -2;
+	unsigned face = 0, i;
+	int axis = 0;
+
+	/* box faces in the order of their textures in RenderBoxFace: -x, +x, -y, +y, -z, +z */
+	if (rb->shapeType == SHAPE_BOX)
+	{
+		for (i = 1; i < 3; i++)
+			if (fabs(up[i]) > fabs(up[axis]))
+				axis = i;
+
+		return axis * 2 + (up[axis] > 0 ? 2 : 1);
+	}
+
+	/* a d4 has a corner on top, so it is read from the face underneath */
+	if (rb->shapeType == SHAPE_D4)
+		bodyUp = Vec3Mult(bodyUp, -1);
+
+	for (i = 0; i < rb->numFaces; i++)
+	{
+		projection = Vec3Dot(rb->bodyNormals[i], bodyUp);
+		if (projection > best)
+		{
+			best = projection;
+			face = i;
+		}
+	}
+
+	return face + 1;
+}
+
+bool RollIsStill(Rigidbody *die)
+{
+	/* spinning about the vertical can't change the face, so only tumbling counts */
+	Vector3 tumble = Vec3New(die->angularVelocity.x, 0, die->angularVelocity.z);
+
+	return Vec3Magnitude(die->velocity) < REST_SPEED && Vec3Magnitude(tumble) < REST_SPEED;
+}
+
+bool RollSimulate(RollParams *params, RollResult *result)
+{
+	Scene scene;
+	Rigidbody *die = &scene.objects[0];
+	RigidbodyState state;
+	Vector3 rotation;
+	int step, stillSteps = 0;
+	int maxSteps = (int)(ROLL_MAX_TIME / ROLL_TIME_STEP);
+
+	SceneInit(&scene, params->seed);
+	scene.params = params->physics;
+
+	rotation.x = GetRandomFloat(&scene.random, 0, 360);
+	rotation.y = GetRandomFloat(&scene.random, 0, 360);
+	rotation.z = GetRandomFloat(&scene.random, 0, 360);
+
+	state.shape = params->shape;
+	state.density = params->density;
+	state.dimensions = params->dimensions;
+	state.position = params->position;
+	state.orientation = M3FromEuler(rotation);
+	state.velocity = params->velocity;
+	state.angularMomentum = RBAngularMomentumForSpin(&state, params->spin, &params->physics.body);
+
+	scene.numObjects = 0;
+	SceneResetContacts(&scene);
+	SceneSpawnRigidbody(&scene, &state);
+
+	for (step = 1; step <= maxSteps; step++)
+	{
+		SceneUpdate(&scene, ROLL_TIME_STEP);
+
+		if (RollIsStill(die))
+			stillSteps++;
+		else
+			stillSteps = 0;
+
+		if (stillSteps == REST_STEPS)
+		{
+			result->face = RollGetFace(die);
+			result->settleTime = (step - REST_STEPS) * ROLL_TIME_STEP;
+			return true;
+		}
+	}
+
+	result->face = 0;
+	result->settleTime = ROLL_MAX_TIME;
+	return false;
+}
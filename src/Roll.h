@@ -0,0 +1,101 @@
+/**
+ * @file	Roll.h
+ * @brief	Simulates a single die roll to rest.
+ */
+
+#ifndef ROLL_H
+#define ROLL_H
+
+#include "Vector3.h"
+#include "Shape.h"
+#include "Boolean.h"
+#include "Rigidbody.h"
+#include "Scene.h"
+
+extern const float REST_SPEED;
+extern const int REST_STEPS;
+
+/**
+ * @brief	Everything that determines the outcome of a roll.
+ * @details	Plain floats and integers with no padding, so two rolls are the same if their
+ * 			params compare equal with memcmp. The physics parameters, including the mass and
+ * 			bounce of the die in physics.body, are included so results simulated with others
+ * 			are never reused.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct RollParams
+{
+	unsigned seed;								/* picks the starting orientation */
+	ShapeType shape;
+	float density;
+	Vector3 dimensions;
+	Vector3 position;							/* release position */
+	Vector3 velocity;							/* release velocity, 0 for a drop */
+	Vector3 spin;								/* angular velocity at release, radians per second */
+	SceneParams physics;						/* defaults filled in by RollParamsInit */
+};
+typedef struct RollParams RollParams;
+
+/**
+ * @brief	Outcome of a roll. 
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct RollResult
+{
+	int face;									/* 1 to the number of faces, or 0 if the die never came to rest */
+	float settleTime;							/* seconds from release until the die stopped */
+};
+typedef struct RollResult RollResult;
+
+/**
+ * @brief	Fills in roll params with the default physics parameters.
+ * @details	Change params->physics after to roll under other physics.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	params	  	The params.
+ * @param	seed	  	The seed.
+ * @param	shape	  	The die shape.
+ * @param	dimensions	The die dimensions.
+ * @param	density   	The density.
+ * @param	position  	The release position.
+ * @param	velocity  	The release velocity.
+ * @param	spin	  	The angular velocity at release, in radians per second.
+ */
+void RollParamsInit(RollParams *params, unsigned seed, ShapeType shape, Vector3 dimensions, float density, Vector3 position, Vector3 velocity, Vector3 spin);
+
+/**
+ * @brief	Gets the face of a die that counts as rolled.
+ * @details	Used internally by RollSimulate. The face pointing up, or for a d4 the face it rests
+ * 			on. Box faces are numbered as their textures; other shapes in Shape face order.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	rb	The die.
+ * @return	The face, from 1.
+ */
+int RollGetFace(Rigidbody *rb);
+
+/**
+ * @brief	Gets whether a die is moving slowly enough to count as at rest this step.
+ * @details	A die has come to rest once it has been still for REST_STEPS steps in a row.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	die	The die.
+ * @return	true if the die is still.
+ */
+bool RollIsStill(Rigidbody *die);
+
+/**
+ * @brief	Drops or throws a single die and simulates it until it comes to rest.
+ * @details	Uses a fixed time step so the same params always give the same result. The die is
+ * 			simulated in a scene of its own, so rolls can be simulated on many threads at once.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	params	The roll params.
+ * @param 	result	The result.
+ * @return	true if the die came to rest, false if it was still moving after ROLL_MAX_TIME.
+ */
+bool RollSimulate(RollParams *params, RollResult *result);
+
+#endif
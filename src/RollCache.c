@@ -0,0 +1,157 @@
+#include "RollCache.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+bool RollCacheCreate(RollCache *cache, unsigned capacity, char *filename)
+{
+	struct stat info;
+	unsigned char *data;
+	int file;
+
+	memset(cache, 0, sizeof(RollCache));
+
+	/* the bucket count doubles until the capacity fits, stopping before numEntries would wrap */
+	cache->numBuckets = 1;
+	while (cache->numBuckets * ROLL_CACHE_WAYS < capacity)
+	{
+		if (cache->numBuckets > UINT_MAX / (2 * ROLL_CACHE_WAYS))
+			return false;
+		cache->numBuckets *= 2;
+	}
+	capacity = cache->numBuckets * ROLL_CACHE_WAYS;
+	cache->size = sizeof(RollCacheHeader) + (unsigned long)capacity * sizeof(RollCacheEntry);
+
+	if (filename == NULL)
+	{
+		data = (unsigned char*)calloc(1, cache->size);
+		if (data == NULL)
+			return false;
+	}
+	else
+	{
+		file = open(filename, O_RDWR | O_CREAT, 0644);
+		if (file < 0)
+			return false;
+
+		/* a file of another size is replaced - the header check below clears the contents */
+		if (fstat(file, &info) != 0 || ((unsigned long)info.st_size != cache->size && ftruncate(file, cache->size) != 0))
+		{
+			close(file);
+			return false;
+		}
+
+		data = (unsigned char*)mmap(NULL, cache->size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+		close(file);
+
+		if (data == (unsigned char*)MAP_FAILED)
+			return false;
+
+		cache->mapped = true;
+	}
+
+	cache->header = (RollCacheHeader*)data;
+	cache->entries = (RollCacheEntry*)(data + sizeof(RollCacheHeader));
+
+	if (memcmp(cache->header->magic, "DRLC", 4) != 0 || cache->header->version != ROLL_CACHE_VERSION ||
+		cache->header->numEntries != capacity)
+	{
+		memset(data, 0, cache->size);
+		memcpy(cache->header->magic, "DRLC", 4);
+		cache->header->version = ROLL_CACHE_VERSION;
+		cache->header->numEntries = capacity;
+	}
+
+	return true;
+}
+
+void RollCacheClose(RollCache *cache)
+{
+	if (cache->header == NULL)
+		return;
+
+	if (cache->mapped)
+		munmap(cache->header, cache->size);
+	else
+		free(cache->header);
+
+	cache->header = NULL;
+	cache->entries = NULL;
+}
+
+unsigned long long RollCacheHash(RollParams *params)
+{
+	unsigned char *data = (unsigned char*)params;
+	unsigned long long hash = 14695981039346656037ULL;
+	size_t i;
+
+	for (i = 0; i < sizeof(RollParams); i++)
+		hash = (hash ^ data[i]) * 1099511628211ULL;
+
+	/* 0 marks an empty entry */
+	return hash != 0 ? hash : 1;
+}
+
+bool RollCacheLookup(RollCache *cache, RollParams *params, RollResult *result)
+{
+	unsigned long long key = RollCacheHash(params);
+	RollCacheEntry *bucket = &cache->entries[(key & (cache->numBuckets - 1)) * ROLL_CACHE_WAYS];
+	int i;
+
+	for (i = 0; i < ROLL_CACHE_WAYS; i++)
+	{
+		if (bucket[i].key == key && memcmp(&bucket[i].params, params, sizeof(RollParams)) == 0)
+		{
+			bucket[i].lastUsed = ++cache->header->clock;
+			*result = bucket[i].result;
+			cache->hits++;
+			return true;
+		}
+	}
+
+	cache->misses++;
+	return false;
+}
+
+void RollCacheInsert(RollCache *cache, RollParams *params, RollResult *result)
+{
+	unsigned long long key = RollCacheHash(params);
+	RollCacheEntry *bucket = &cache->entries[(key & (cache->numBuckets - 1)) * ROLL_CACHE_WAYS];
+	RollCacheEntry *entry = &bucket[0];
+	int i;
+
+	/* use the matching or an empty entry, otherwise evict the least recently used */
+	for (i = 0; i < ROLL_CACHE_WAYS; i++)
+	{
+		if (bucket[i].key == 0 || (bucket[i].key == key && memcmp(&bucket[i].params, params, sizeof(RollParams)) == 0))
+		{
+			entry = &bucket[i];
+			break;
+		}
+		if (bucket[i].lastUsed < entry->lastUsed)
+			entry = &bucket[i];
+	}
+
+	if (i == ROLL_CACHE_WAYS)
+		cache->evictions++;
+
+	entry->params = *params;
+	entry->result = *result;
+	entry->lastUsed = ++cache->header->clock;
+	entry->key = key;
+	cache->inserts++;
+}
+
+void RollCacheRoll(RollCache *cache, RollParams *params, RollResult *result)
+{
+	if (RollCacheLookup(cache, params, result))
+		return;
+
+	RollSimulate(params, result);
+	RollCacheInsert(cache, params, result);
+}
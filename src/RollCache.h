@@ -0,0 +1,142 @@
+/**
+ * @file	RollCache.h
+ * @brief	Caches roll results by their params.
+ */
+
+#ifndef ROLLCACHE_H
+#define ROLLCACHE_H
+
+#include "Roll.h"
+#include "Boolean.h"
+
+/**
+ * @brief	Roll cache file format version. Increase when the layout or the simulation changes,
+ * 			so stored results from an older build are discarded. 
+ */
+enum { ROLL_CACHE_VERSION = 6 };
+
+/**
+ * @brief	Number of entries per bucket. A full bucket evicts its least recently used entry. 
+ */
+enum { ROLL_CACHE_WAYS = 4 };
+
+/**
+ * @brief	Header at the start of a roll cache. 
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct RollCacheHeader
+{
+	char magic[4];					/* "DRLC" */
+	unsigned int version;
+	unsigned int numEntries;
+	unsigned int clock;				/* incremented on every access, for least recently used eviction */
+};
+typedef struct RollCacheHeader RollCacheHeader;
+
+/**
+ * @brief	One cached result. 
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct RollCacheEntry
+{
+	unsigned long long key;			/* hash of params, 0 if the entry is empty */
+	RollParams params;				/* compared in full, so hash collisions can't return a wrong result */
+	RollResult result;
+	unsigned int lastUsed;
+	unsigned int reserved;
+};
+typedef struct RollCacheEntry RollCacheEntry;
+
+/**
+ * @brief	A roll cache, in memory or memory mapped from a file.
+ * @details	The file is the table itself, so results are stored as soon as they are inserted.
+ * 			Values are in native byte order.
+ *
+ * 			Not safe to share. Lookups as well as inserts write to the table, with no locking,
+ * 			so a cache must only be used by one thread at a time, and a file must only be open
+ * 			in one process at a time - mapped shared, two processes would corrupt each other's
+ * 			entries. Give each worker its own file.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct RollCache
+{
+	RollCacheHeader *header;
+	RollCacheEntry *entries;
+	unsigned numBuckets;
+	unsigned long size;				/* size of the header and entries */
+	bool mapped;					/* true if backed by a file */
+
+	/* statistics since the cache was opened */
+	unsigned long hits;
+	unsigned long misses;
+	unsigned long inserts;
+	unsigned long evictions;
+};
+typedef struct RollCache RollCache;
+
+/**
+ * @brief	Creates a roll cache.
+ * @details	With a file name the table is memory mapped from that file. An existing file with the
+ * 			same version and capacity is reused, anything else is replaced with an empty table.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache   	The cache.
+ * @param	capacity	The number of results to keep. Rounded up to a power of two buckets.
+ * @param 	filename	The file to store results in, or NULL to keep them in memory only.
+ * @return	true if it succeeds, false if it fails or the capacity is above 2^31.
+ */
+bool RollCacheCreate(RollCache *cache, unsigned capacity, char *filename);
+
+/**
+ * @brief	Frees a roll cache, unmapping its file.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache	The cache.
+ */
+void RollCacheClose(RollCache *cache);
+
+/**
+ * @brief	Looks up the result of a roll.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache 	The cache.
+ * @param 	params	The roll params.
+ * @param 	result	The cached result.
+ * @return	true if the result was cached.
+ */
+bool RollCacheLookup(RollCache *cache, RollParams *params, RollResult *result);
+
+/**
+ * @brief	Stores the result of a roll.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache 	The cache.
+ * @param 	params	The roll params.
+ * @param 	result	The result.
+ */
+void RollCacheInsert(RollCache *cache, RollParams *params, RollResult *result);
+
+/**
+ * @brief	Gets the result of a roll from the cache, simulating and storing it on a miss.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache 	The cache.
+ * @param 	params	The roll params.
+ * @param 	result	The result.
+ */
+void RollCacheRoll(RollCache *cache, RollParams *params, RollResult *result);
+
+/**
+ * @brief	Hashes roll params.
+ * @details	Used internally by the cache. 64 bit FNV-1a over the bytes of the params, never 0.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	params	The roll params.
+ * @return	The hash.
+ */
+unsigned long long RollCacheHash(RollParams *params);
+
+#endif
@@ -0,0 +1,411 @@
+
+#include "Scenario.h"
+#include "Roll.h"
+#include "MathUtils.h"
+#include "FramePacer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+static const float ESCAPE_DEPTH = 1.0f;			/* distance below the floor at which a body has fallen through */
+static const float LIVE_TIME = 1.5f;			/* typical seconds from a throw until the die settles, from the benchmark and soak runs */
+
+/**
+ * @brief	Values that represent how far a body in a scenario has got.
+ */
+enum BodyProgress { BODY_MOVING = 0, BODY_SETTLED };
+
+/**
+ * @brief	What a scenario run knows about one body in the scene.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct ScenarioBody
+{
+	enum BodyProgress progress;
+	float spawnTime;
+	float settleTime;					/* time it came to rest, once settled */
+	int stillSteps;
+};
+typedef struct ScenarioBody ScenarioBody;
+
+static void GroupInit(ScenarioGroup *group);
+static bool ReadSetting(Scenario *scenario, char *line);
+static bool ReadRange(char *values, float *min, float *max);
+static bool ReadVectorRange(char *values, Vector3 *min, Vector3 *max);
+static void CheckOverlap(Scenario *scenario, char *filename);
+static void DrawBody(ScenarioGroup *group, Random *random, RigidbodyParams *params, RigidbodyState *state);
+static void SpawnBodies(Scene *scene, ScenarioBody *bodies, RigidbodyState *states, int *numStates, float time);
+static void RemoveBody(Scene *scene, ScenarioBody *bodies, ScenarioStats *stats);
+static int CompareFloats(const void *a, const void *b);
+static int CompareDoubles(const void *a, const void *b);
+
+bool ScenarioRead(Scenario *scenario, char *filename)
+{
+	char line[256];
+	int lineNumber = 0;
+	bool valid = true;
+	FILE *file;
+
+	memset(scenario, 0, sizeof(Scenario));
+	scenario->seed = 1;
+	scenario->duration = 10;
+	scenario->timeStep = 1.0f / 200.0f;
+
+	file = fopen(filename, "r");
+	if (!file)
+		return false;
+
+	while (fgets(line, sizeof(line), file))
+	{
+		lineNumber++;
+		if (!ReadSetting(scenario, line))
+		{
+			fprintf(stderr, "%s line %d not understood: %s", filename, lineNumber, line);
+			valid = false;
+		}
+	}
+
+	fclose(file);
+	if (valid)
+		CheckOverlap(scenario, filename);
+	return valid;
+}
+
+/* Sets a group to drop a single die the way DemoCreateRigidbodys does. */
+static void GroupInit(ScenarioGroup *group)
+{
+	memset(group, 0, sizeof(ScenarioGroup));
+	group->count = 1;
+	group->shape = SHAPE_BOX;
+	group->minSize = 0.5f;
+	group->maxSize = 1;
+	group->minDensity = group->maxDensity = 3;
+	group->minPosition = Vec3New(-1.2f, 5, -1);
+	group->maxPosition = Vec3New(1.2f, 20, 1);
+}
+
+/* Applies one line of a scenario file. Returns false if it is invalid. */
+static bool ReadSetting(Scenario *scenario, char *line)
+{
+	ScenarioGroup *group = scenario->numGroups > 0 ? &scenario->groups[scenario->numGroups - 1] : NULL;
+	char keyword[32], *values, *comment;
+	int length, sides;
+
+	comment = strchr(line, '#');
+	if (comment)
+		*comment = '\0';
+
+	if (sscanf(line, "%31s%n", keyword, &length) != 1)
+		return true;
+	values = line + length;
+
+	if (strcmp(keyword, "seed") == 0)
+		return sscanf(values, "%u", &scenario->seed) == 1;
+	if (strcmp(keyword, "duration") == 0)
+		return sscanf(values, "%f", &scenario->duration) == 1 && scenario->duration > 0;
+	if (strcmp(keyword, "step") == 0)
+		return sscanf(values, "%f", &scenario->timeStep) == 1 && scenario->timeStep > 0;
+
+	if (strcmp(keyword, "group") == 0)
+	{
+		if (scenario->numGroups == MAX_SCENARIO_GROUPS)
+			return false;
+		GroupInit(&scenario->groups[scenario->numGroups++]);
+		return true;
+	}
+
+	/* everything else sets up the last group */
+	if (group == NULL)
+		return false;
+
+	if (strcmp(keyword, "start") == 0)
+		return sscanf(values, "%f", &group->start) == 1 && group->start >= 0;
+	if (strcmp(keyword, "interval") == 0)
+		return sscanf(values, "%f", &group->interval) == 1 && group->interval >= 0;
+	if (strcmp(keyword, "count") == 0)
+		return sscanf(values, "%d", &group->count) == 1 && group->count >= 0;
+	if (strcmp(keyword, "shape") == 0)
+		return sscanf(values, "%d", &sides) == 1 && ShapeFromSides(sides, &group->shape);
+	if (strcmp(keyword, "size") == 0)
+		return ReadRange(values, &group->minSize, &group->maxSize) && group->minSize > 0;
+	if (strcmp(keyword, "density") == 0)
+		return ReadRange(values, &group->minDensity, &group->maxDensity) && group->minDensity > 0;
+	if (strcmp(keyword, "volume") == 0)
+		return ReadVectorRange(values, &group->minPosition, &group->maxPosition);
+	if (strcmp(keyword, "velocity") == 0)
+		return ReadVectorRange(values, &group->minVelocity, &group->maxVelocity);
+	if (strcmp(keyword, "spin") == 0)
+		return ReadVectorRange(values, &group->minSpin, &group->maxSpin);
+
+	return false;
+}
+
+/* Reads "min max", or a single value for both. */
+static bool ReadRange(char *values, float *min, float *max)
+{
+	int fields = sscanf(values, "%f %f", min, max);
+
+	if (fields == 1)
+		*max = *min;
+	return fields >= 1 && *min <= *max;
+}
+
+/* Reads "minx miny minz maxx maxy maxz", or a single vector for both. */
+static bool ReadVectorRange(char *values, Vector3 *min, Vector3 *max)
+{
+	int fields = sscanf(values, "%f %f %f %f %f %f", &min->x, &min->y, &min->z, &max->x, &max->y, &max->z);
+
+	if (fields == 3)
+		*max = *min;
+	return (fields == 3 || fields == 6) && min->x <= max->x && min->y <= max->y && min->z <= max->z;
+}
+
+/* Warns if more bodies are due within LIVE_TIME of each other than the scene holds, as some
+   will then be replaced while still moving. */
+static void CheckOverlap(Scenario *scenario, char *filename)
+{
+	ScenarioGroup *group;
+	float *times, peakTime = 0;
+	int total = 0, peak = 0, first = 0, i, j;
+
+	for (i = 0; i < scenario->numGroups; i++)
+		total += scenario->groups[i].count;
+
+	times = (float*)malloc((total > 0 ? total : 1) * sizeof(float));
+	if (!times)
+		return;
+
+	/* spawn times as ScenarioRun works them out */
+	total = 0;
+	for (i = 0; i < scenario->numGroups; i++)
+	{
+		group = &scenario->groups[i];
+		for (j = 0; j < group->count; j++)
+			times[total++] = group->start + j * group->interval;
+	}
+	qsort(times, total, sizeof(float), CompareFloats);
+
+	for (i = 0; i < total; i++)
+	{
+		while (times[first] <= times[i] - LIVE_TIME)
+			first++;
+		if (i - first + 1 > peak)
+		{
+			peak = i - first + 1;
+			peakTime = times[i];
+		}
+	}
+
+	if (peak > MAX_OBJECTS)
+		fprintf(stderr, "WARNING: %s spawns %d bodies within %.1f s up to %.2f s, but only %d are simulated at once - "
+			"bodies still moving will be replaced\n", filename, peak, LIVE_TIME, peakTime, MAX_OBJECTS);
+
+	free(times);
+}
+
+bool ScenarioRun(Scenario *scenario, Scene *scene, ScenarioStats *stats)
+{
+	ScenarioBody bodies[MAX_OBJECTS];
+	RigidbodyState states[MAX_OBJECTS];
+	int spawned[MAX_SCENARIO_GROUPS] = { 0 };
+	ScenarioGroup *group;
+	ContactCache *contacts = &scene->contacts;
+	unsigned long pairsTested = contacts->pairsTested, found = contacts->found, warmStarted = contacts->warmStarted;
+	int numSteps = (int)ceil(scenario->duration / scenario->timeStep);
+	int step, i, numStates, total = 0;
+	float time, *settleTimes;
+	double start, *stepTimes;
+	Rigidbody *rb;
+
+	for (i = 0; i < scenario->numGroups; i++)
+		total += scenario->groups[i].count;
+
+	settleTimes = (float*)malloc((total > 0 ? total : 1) * sizeof(float));
+	stepTimes = (double*)malloc((numSteps > 0 ? numSteps : 1) * sizeof(double));
+	if (!settleTimes || !stepTimes)
+	{
+		free(settleTimes);
+		free(stepTimes);
+		return false;
+	}
+
+	memset(stats, 0, sizeof(ScenarioStats));
+	InitRandomGenerationSeed(&scene->random, scenario->seed);
+	scene->numObjects = 0;
+	SceneResetContacts(scene);
+
+	for (step = 0; step < numSteps; step++)
+	{
+		time = step * scenario->timeStep;
+		numStates = 0;
+
+		/* spawn bodies that are due in one batch, making room by removing the one at rest longest */
+		for (i = 0; i < scenario->numGroups; i++)
+		{
+			group = &scenario->groups[i];
+			while (spawned[i] < group->count && group->start + spawned[i] * group->interval <= time)
+			{
+				if (scene->numObjects + numStates == MAX_OBJECTS)
+				{
+					SpawnBodies(scene, bodies, states, &numStates, time);
+					RemoveBody(scene, bodies, stats);
+				}
+
+				DrawBody(group, &scene->random, &scene->params.body, &states[numStates++]);
+				spawned[i]++;
+				stats->spawned++;
+			}
+		}
+		SpawnBodies(scene, bodies, states, &numStates, time);
+
+		start = FramePacerTime();
+		SceneUpdate(scene, scenario->timeStep);
+		stepTimes[step] = FramePacerTime() - start;
+
+		stats->steps++;
+		stats->bodySteps += scene->numObjects;
+
+		/* bodies that left the world are removed before they disturb the others, and bodies at
+		   rest for REST_STEPS in a row have settled, as in RollSimulate */
+		for (i = 0; i < scene->numObjects; i++)
+		{
+			rb = &scene->objects[i];
+			if (!isfinite(rb->position.x) || !isfinite(rb->position.y) || !isfinite(rb->position.z) || rb->position.y < -ESCAPE_DEPTH)
+			{
+				stats->escaped++;
+				SceneRemoveRigidbody(scene, i);
+				bodies[i] = bodies[scene->numObjects];
+				i--;
+				continue;
+			}
+
+			if (bodies[i].progress != BODY_MOVING)
+				continue;
+
+			bodies[i].stillSteps = RollIsStill(rb) ? bodies[i].stillSteps + 1 : 0;
+			if (bodies[i].stillSteps == REST_STEPS)
+			{
+				bodies[i].progress = BODY_SETTLED;
+				bodies[i].settleTime = (step + 1 - REST_STEPS) * scenario->timeStep;
+				settleTimes[stats->settled++] = bodies[i].settleTime - bodies[i].spawnTime;
+			}
+		}
+	}
+
+	for (i = 0; i < scene->numObjects; i++)
+		if (bodies[i].progress == BODY_MOVING)
+			stats->moving++;
+
+	/* step times */
+	for (i = 0; i < numSteps; i++)
+		stats->wallTime += stepTimes[i];
+	if (numSteps > 0)
+	{
+		qsort(stepTimes, numSteps, sizeof(double), CompareDoubles);
+		stats->meanStepTime = stats->wallTime / numSteps;
+		stats->p99StepTime = stepTimes[(int)(0.99 * (numSteps - 1))];
+		stats->maxStepTime = stepTimes[numSteps - 1];
+	}
+
+	/* settle times */
+	if (stats->settled > 0)
+	{
+		for (i = 0; i < stats->settled; i++)
+			stats->meanSettleTime += settleTimes[i] / stats->settled;
+		qsort(settleTimes, stats->settled, sizeof(float), CompareFloats);
+		stats->medianSettleTime = settleTimes[(stats->settled - 1) / 2];
+		stats->p95SettleTime = settleTimes[(int)(0.95f * (stats->settled - 1))];
+		stats->maxSettleTime = settleTimes[stats->settled - 1];
+	}
+
+	stats->pairsTested = contacts->pairsTested - pairsTested;
+	stats->contacts = contacts->found - found;
+	stats->warmStarted = contacts->warmStarted - warmStarted;
+
+	free(settleTimes);
+	free(stepTimes);
+	return true;
+}
+
+/* Draws the state of a body from a group's ranges. Each value is drawn in its own statement,
+   as in DemoCreateRigidbodys. */
+static void DrawBody(ScenarioGroup *group, Random *random, RigidbodyParams *params, RigidbodyState *state)
+{
+	Vector3 rotation, spin;
+	float size;
+
+	size = GetRandomFloat(random, group->minSize, group->maxSize);
+	state->density = GetRandomFloat(random, group->minDensity, group->maxDensity);
+	state->position.x = GetRandomFloat(random, group->minPosition.x, group->maxPosition.x);
+	state->position.y = GetRandomFloat(random, group->minPosition.y, group->maxPosition.y);
+	state->position.z = GetRandomFloat(random, group->minPosition.z, group->maxPosition.z);
+	rotation.x = GetRandomFloat(random, 0, 360);
+	rotation.y = GetRandomFloat(random, 0, 360);
+	rotation.z = GetRandomFloat(random, 0, 360);
+	state->velocity.x = GetRandomFloat(random, group->minVelocity.x, group->maxVelocity.x);
+	state->velocity.y = GetRandomFloat(random, group->minVelocity.y, group->maxVelocity.y);
+	state->velocity.z = GetRandomFloat(random, group->minVelocity.z, group->maxVelocity.z);
+	spin.x = GetRandomFloat(random, group->minSpin.x, group->maxSpin.x);
+	spin.y = GetRandomFloat(random, group->minSpin.y, group->maxSpin.y);
+	spin.z = GetRandomFloat(random, group->minSpin.z, group->maxSpin.z);
+
+	state->shape = group->shape;
+	state->dimensions = Vec3New(size, size, size);
+	state->orientation = M3FromEuler(rotation);
+	state->angularMomentum = RBAngularMomentumForSpin(state, spin, params);
+}
+
+/* Adds the drawn bodies to the end of the scene. */
+static void SpawnBodies(Scene *scene, ScenarioBody *bodies, RigidbodyState *states, int *numStates, float time)
+{
+	int i, first = scene->numObjects;
+
+	SceneSpawnRigidbodys(scene, states, *numStates);
+	for (i = first; i < scene->numObjects; i++)
+	{
+		memset(&bodies[i], 0, sizeof(ScenarioBody));
+		bodies[i].spawnTime = time;
+	}
+
+	*numStates = 0;
+}
+
+/* Removes the body that has been at rest longest, or else the oldest. The last body takes its
+   place, as in SceneRemoveRigidbody. */
+static void RemoveBody(Scene *scene, ScenarioBody *bodies, ScenarioStats *stats)
+{
+	int i, best = 0;
+
+	for (i = 1; i < scene->numObjects; i++)
+	{
+		if (bodies[i].progress != bodies[best].progress)
+		{
+			if (bodies[i].progress == BODY_SETTLED)
+				best = i;
+		}
+		else if (bodies[i].progress == BODY_SETTLED ? bodies[i].settleTime < bodies[best].settleTime : bodies[i].spawnTime < bodies[best].spawnTime)
+			best = i;
+	}
+
+	if (bodies[best].progress == BODY_MOVING)
+		stats->replaced++;
+
+	SceneRemoveRigidbody(scene, best);
+	bodies[best] = bodies[scene->numObjects];
+}
+
+/* qsort comparison of floats in increasing order. */
+static int CompareFloats(const void *a, const void *b)
+{
+	float x = *(const float*)a, y = *(const float*)b;
+	return (x > y) - (x < y);
+}
+
+/* qsort comparison of doubles in increasing order. */
+static int CompareDoubles(const void *a, const void *b)
+{
+	double x = *(const double*)a, y = *(const double*)b;
+	return (x > y) - (x < y);
+}
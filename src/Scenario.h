@@ -0,0 +1,131 @@
+/**
+ * @file	Scenario.h
+ * @brief	Scripted runs of many bodies for benchmarks and soak tests.
+ */
+
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include "Scene.h"
+#include "Shape.h"
+#include "Vector3.h"
+#include "Boolean.h"
+
+/**
+ * @brief	Defines the maximum number of spawn groups in a scenario.
+ */
+enum { MAX_SCENARIO_GROUPS = 32 };
+
+/**
+ * @brief	A set of bodies spawned one after another with properties drawn from ranges.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct ScenarioGroup
+{
+	float start;						/* seconds from the start of the run to the first body */
+	float interval;						/* seconds between bodies, 0 to spawn them together */
+	int count;
+	ShapeType shape;
+	float minSize, maxSize;				/* edge length of the bounding box */
+	float minDensity, maxDensity;
+	Vector3 minPosition, maxPosition;	/* corners of the spawn volume */
+	Vector3 minVelocity, maxVelocity;
+	Vector3 minSpin, maxSpin;			/* angular velocity in radians per second */
+};
+typedef struct ScenarioGroup ScenarioGroup;
+
+/**
+ * @brief	A scripted run.
+ * @details	Read from a text file of one setting per line, eg:
+ * 			<pre>
+ * 			seed 7
+ * 			duration 60						# seconds of simulated time
+ * 			step 0.005						# seconds per step
+ * 			group							# later lines set up this group
+ * 			start 0
+ * 			count 100
+ * 			interval 0.25
+ * 			shape 6							# sides
+ * 			size 0.5 1						# min max
+ * 			density 3 3
+ * 			volume -1.2 1 -1  1.2 3 1		# min corner, max corner
+ * 			velocity -2 0 -2  2 1 2
+ * 			spin -10 -10 -10  10 10 10
+ * 			</pre>
+ * 			Everything after # is ignored. Only MAX_OBJECTS bodies are simulated at once - when
+ * 			the scene is full, a new body replaces the one that has been at rest longest, or the
+ * 			oldest if none are. Bodies that fall through the floor or stop being finite are
+ * 			removed.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct Scenario
+{
+	unsigned seed;
+	float duration;
+	float timeStep;
+	ScenarioGroup groups[MAX_SCENARIO_GROUPS];
+	int numGroups;
+};
+typedef struct Scenario Scenario;
+
+/**
+ * @brief	What happened in a scenario run.
+ * @details	Settle times are seconds of simulated time from a body spawning until it came to
+ * 			rest, as RollSimulate measures them.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct ScenarioStats
+{
+	int steps;
+	long bodySteps;						/* bodies simulated, summed over steps */
+	double wallTime;					/* milliseconds spent stepping the scene */
+	double meanStepTime;
+	double p99StepTime;
+	double maxStepTime;
+
+	int spawned;
+	int settled;
+	int replaced;						/* replaced while still moving */
+	int moving;							/* still moving at the end */
+	int escaped;						/* left the world or stopped being finite, and removed */
+	float meanSettleTime;
+	float medianSettleTime;
+	float p95SettleTime;
+	float maxSettleTime;
+
+	unsigned long pairsTested;			/* from the scene's ContactCache */
+	unsigned long contacts;
+	unsigned long warmStarted;
+};
+typedef struct ScenarioStats ScenarioStats;
+
+/**
+ * @brief	Reads a scenario file.
+ * @details	Lines that can't be read are reported to stderr, as is a schedule that spawns more
+ * 			than MAX_OBJECTS bodies within the time one takes to settle.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	scenario	The scenario.
+ * @param 	filename	The file to read.
+ * @return	false if the file is missing or any line is invalid.
+ */
+bool ScenarioRead(Scenario *scenario, char *filename);
+
+/**
+ * @brief	Runs a scenario with fixed time steps.
+ * @details	The scene's bodies are removed first; its static mesh and parameters are kept.
+ * 			Reseeds the scene's random generator, so the same scenario always gives the same
+ * 			bodies and settle times.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	scenario	The scenario.
+ * @param 	scene   	An initialized scene.
+ * @param 	stats   	The statistics of the run.
+ * @return	false if memory could not be allocated.
+ */
+bool ScenarioRun(Scenario *scenario, Scene *scene, ScenarioStats *stats);
+
+#endif
@@ -1,184 +1,309 @@
-
-#include "Scene.h"
-#include "Rigidbody.h"
-#include <stdlib.h>
-#include "Boolean.h"
-#include "KeyInput.h"
-#include "MathUtils.h"
-#include <assert.h>
-#include <stdio.h>
-
-void SceneInit(Scene *scene)
-{
-	/* init camera */
-	scene->camera.position = Vec3New(10, 3, 0);
-	scene->camera.focus = Vec3New(0, 0, 0);
-	scene->camera.speed = 80;
-	scene->camera.orbitAngle = 0;
-	scene->camera.orbitRadius = 10;
-	scene->camera.minY = 3;
-	scene->camera.maxY = 10;
-
-	/* init light */
-	scene->light.enabled = true;
-	scene->light.type = DIRECTIONAL_LIGHT;
-	scene->light.position = Vec3New(1, 1, 0);
-	scene->light.ambient = ColourNew(0.5f, 0.5f, 0.5f, 1);
-	scene->light.diffuse = ColourNew(1, 1, 1, 1);
-	scene->light.specular = ColourNew(1, 1, 1, 1);
-
-	/* init input control */
-	scene->createdObjects = false;
-	scene->increasedNumObjects = false;
-	scene->decreasedNumObjects = false;
-
-	/* init objects */
-	scene->numObjectsCreate = 8;
-	SceneCreateRigidbodys(scene);
-}
-
-void SceneUpdate(Scene *scene, float deltaTime)
-{
-	int timeDivisionsCount;
-	int maxTimeDivisions = 20;
-
-	float currentTime;
-	float targetTime = deltaTime;
-
-	Rigidbody object;
-
-	int i;
-
-	/* reset objects, increase/decrease quantity */
-	SceneHandleInput(scene);
-
-	/* loop through each object */
-	for (i = 0; i < scene->numObjects; i++)
-	{
-		currentTime = 0;
-		targetTime = deltaTime;
-
-		timeDivisionsCount = 0;
-
-		/* make sure nothing is stuck */
-		SceneResolvePenetration(scene, &scene->objects[i]);
-
-		while (currentTime < deltaTime && timeDivisionsCount < maxTimeDivisions)
-		{
-			/* copy object so we can revert back if penetration occurs */
-			object = scene->objects[i];
-
-			/* step simulation forward */
-			RBApplyForces(&object);
-			RBIntegrate(&object, targetTime - currentTime);
-			RBCalculateVertices(&object);
-
-			/* check for collisions */
-			RBCheckCollisionFloor(&object);
-			SceneCheckBodyCollisions(scene, &object);
-
-			switch (object.Collision.state)
-			{
-				case PENETRATING:
-					/* subdivide time - binary search for exact time of collison */
-					targetTime = (currentTime + targetTime) / 2.0f;
-					/* limit time subdivisions to prevent infinite loop if collision can't be found */
-					timeDivisionsCount++;
-					break;
-
-				case COLLIDING:
-					/* respond to collision and check nothing it penetrating */
-					RBResolveCollisions(&object);
-					SceneResolvePenetration(scene, &scene->objects[i]);
-				
-				case NO_COLLISION:
-					/* successful step - move forward in time */
-					currentTime = targetTime;
-					targetTime = deltaTime;
-
-					/* save updated object back into array */
-					scene->objects[i] = object;
-					break;
-			}
-		}
-	}
-
-	/* camera movement */
-	CameraUpdate(&scene->camera, deltaTime);
-}
-
-void SceneCheckBodyCollisions(Scene *scene, Rigidbody *rb)
-{
-	int i;
-	for (i = 0; i < scene->numObjects && rb->Collision.state == NO_COLLISION; i++)
-	{
-		if (rb != &scene->objects[i])
-			RBCheckCollisionBody(rb, &scene->objects[i]);
-	}
-}
-
-void SceneResolvePenetration(Scene *scene, Rigidbody *rb)
-{
-	int i, j;
-	const int numInterations = 10;
-
-	for (i = 0; i < numInterations; i++)
-	{
-		RBCalculateVertices(rb);
-		RBMoveOutOfFloor(rb);
-
-		for (j = 0; j < scene->numObjects; j++)
-		{
-			RBCalculateVertices(rb);
-			RBMoveOutOfBody(rb, &scene->objects[j]);
-		}
-	}
-}
-
-void SceneCreateRigidbodys(Scene *scene)
-{
-	float size;
-	int i;
-
-	/* random initialization of rigidbodys */
-	for (i = 0; i < scene->numObjectsCreate; i++)
-	{	
-		size = GetRandomFloat(0.5f, 1);
-		RBInit(&scene->objects[i], Vec3New(GetRandomFloat(-1.2f, 1.2f), GetRandomFloat(5, 20), GetRandomFloat(-1, 1)), Vec3New(size, size, size), 3);
-		scene->objects[i].orientation = M3FromEuler(Vec3New(GetRandomFloat(0, 90), GetRandomFloat(0, 90), GetRandomFloat(0, 90)));
-	}
-
-	scene->numObjects = scene->numObjectsCreate;
-}
-
-void SceneHandleInput(Scene *scene)
-{
-	/* create new rigidbodys */
-	if (KeyDown(KEY_C) && scene->createdObjects == false)
-	{
-		scene->createdObjects = true;
-		SceneCreateRigidbodys(scene);
-	}
-	if (!KeyDown(KEY_C))
-		scene->createdObjects = false;
-
-	/* increase number of rigidbodys */
-	if (KeyDown(KEY_PLUS) && scene->increasedNumObjects == false)
-	{
-		scene->increasedNumObjects = true;
-		if (scene->numObjectsCreate < MAX_OBJECTS)
-			scene->numObjectsCreate++;
-	}
-	if (!KeyDown(KEY_PLUS))
-		scene->increasedNumObjects = false;
-
-	/* decrease number of rigidbodys */
-	if (KeyDown(KEY_MINUS) && scene->decreasedNumObjects == false)
-	{
-		scene->decreasedNumObjects = true;
-		if (scene->numObjectsCreate > 1)
-			scene->numObjectsCreate--;
-	}
-	if (!KeyDown(KEY_MINUS))
-		scene->decreasedNumObjects = false;
-}
+
+#include "Scene.h"
+#include "Rigidbody.h"
+#include <stdlib.h>
+#include "Boolean.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+/* true if a body read from a file can be restored - a known shape with a positive size and density */
+static bool ValidObject(RigidbodyState *state);
+
+/* true if x is finite and above zero */
+static bool Positive(float x);
+
+void SceneParamsInit(SceneParams *params)
+{
+	RBParamsInit(&params->body);
+	ContactParamsInit(&params->contact);
+	params->solverIterations = SOLVER_ITERATIONS;
+}
+
+void SceneInit(Scene *scene, unsigned seed)
+{
+	SceneParamsInit(&scene->params);
+	InitRandomGenerationSeed(&scene->random, seed);
+
+	/* no static geometry but the floor */
+	scene->staticMesh = NULL;
+
+	/* no objects */
+	scene->numObjects = 0;
+	SceneResetContacts(scene);
+}
+
+void SceneUpdate(Scene *scene, float deltaTime)
+{
+	int i;
+
+	/* apply forces to the velocities */
+	for (i = 0; i < scene->numObjects; i++)
+	{
+		RBApplyForces(&scene->objects[i], &scene->params.body);
+		RBIntegrateVelocity(&scene->objects[i], deltaTime);
+	}
+
+	/* correct the velocities at every contact together, starting from last step's impulses */
+	SceneFindContacts(scene, deltaTime);
+	ContactPrepare(&scene->contacts, scene->objects, &scene->params.contact, deltaTime);
+	for (i = 0; i < scene->params.solverIterations; i++)
+		ContactSolve(&scene->contacts, scene->objects, &scene->params.contact, i % 2 == 1);
+
+	/* move with the corrected velocities */
+	for (i = 0; i < scene->numObjects; i++)
+	{
+		RBIntegratePosition(&scene->objects[i], deltaTime);
+		RBCalculateVertices(&scene->objects[i]);
+	}
+}
+
+void SceneSaveState(Scene *scene, SceneState *state)
+{
+	int i, j;
+
+	state->numObjects = scene->numObjects;
+	for (i = 0; i < scene->numObjects; i++)
+	{
+		RBSaveState(&scene->objects[i], &state->objects[i]);
+		for (j = i + 1; j < scene->numObjects; j++)
+			state->pairCache[i][j] = scene->pairCache[i][j];
+	}
+
+	state->numContacts = scene->contacts.numContacts;
+	memcpy(state->contacts, scene->contacts.contacts, state->numContacts * sizeof(Contact));
+}
+
+void SceneRestoreState(Scene *scene, SceneState *state)
+{
+	int i, j;
+
+	/* pairs of unused objects are forgotten, the rest are as they were saved */
+	SceneResetContacts(scene);
+
+	scene->numObjects = state->numObjects;
+	for (i = 0; i < state->numObjects; i++)
+	{
+		RBRestoreState(&scene->objects[i], &state->objects[i], &scene->params.body);
+		for (j = i + 1; j < state->numObjects; j++)
+			scene->pairCache[i][j] = state->pairCache[i][j];
+	}
+
+	/* the next step matches its contacts against these to start from their impulses */
+	scene->contacts.numContacts = state->numContacts;
+	memcpy(scene->contacts.contacts, state->contacts, state->numContacts * sizeof(Contact));
+}
+
+bool SceneStateWrite(SceneState *state, char *filename)
+{
+	int header[4] = { 0x504E5344 /* "DSNP" */, SCENE_STATE_VERSION, 0, 0 };
+	bool result;
+	int i;
+	FILE *file = fopen(filename, "wb");
+
+	if (!file)
+		return false;
+
+	header[2] = state->numObjects;
+	header[3] = state->numContacts;
+	result = fwrite(header, sizeof(header), 1, file) == 1 &&
+		fwrite(state->objects, sizeof(RigidbodyState), state->numObjects, file) == (size_t)state->numObjects &&
+		fwrite(state->contacts, sizeof(Contact), state->numContacts, file) == (size_t)state->numContacts;
+
+	/* the used part of each row of pairs */
+	for (i = 0; i < state->numObjects - 1 && result; i++)
+		result = fwrite(&state->pairCache[i][i + 1], sizeof(GJKCache), state->numObjects - i - 1, file) == (size_t)(state->numObjects - i - 1);
+
+	fclose(file);
+	return result;
+}
+
+unsigned long long SceneStateHash(SceneState *state, unsigned long long hash)
+{
+	unsigned char *data = (unsigned char*)state->objects;
+	size_t size = state->numObjects * sizeof(RigidbodyState);
+	size_t i;
+
+	/* 64 bit FNV-1a over the bit patterns of the state */
+	hash = (hash ^ (unsigned)state->numObjects) * 1099511628211ULL;
+	for (i = 0; i < size; i++)
+		hash = (hash ^ data[i]) * 1099511628211ULL;
+
+	return hash;
+}
+
+bool SceneStateRead(SceneState *state, char *filename)
+{
+	int header[4];
+	bool result;
+	int i, j;
+	FILE *file = fopen(filename, "rb");
+
+	if (!file)
+		return false;
+
+	if (fread(header, sizeof(header), 1, file) != 1 || header[0] != 0x504E5344 || header[1] != SCENE_STATE_VERSION ||
+		header[2] < 0 || header[2] > MAX_OBJECTS || header[3] < 0 || header[3] > MAX_CONTACTS)
+	{
+		fclose(file);
+		return false;
+	}
+
+	state->numObjects = header[2];
+	state->numContacts = header[3];
+	result = fread(state->objects, sizeof(RigidbodyState), state->numObjects, file) == (size_t)state->numObjects &&
+		fread(state->contacts, sizeof(Contact), state->numContacts, file) == (size_t)state->numContacts;
+
+	for (i = 0; i < state->numObjects - 1 && result; i++)
+		result = fread(&state->pairCache[i][i + 1], sizeof(GJKCache), state->numObjects - i - 1, file) == (size_t)(state->numObjects - i - 1);
+
+	/* nothing read is trusted - GJK checks the cached vertices against the bodies, but not the
+	   number of them, and contacts are matched by body index */
+	for (i = 0; i < state->numObjects && result; i++)
+	{
+		result = ValidObject(&state->objects[i]);
+		for (j = i + 1; j < state->numObjects; j++)
+			if (state->pairCache[i][j].numPoints < 0 || state->pairCache[i][j].numPoints > 4)
+				result = false;
+	}
+	for (i = 0; i < state->numContacts && result; i++)
+	{
+		result = state->contacts[i].bodyA >= 0 && state->contacts[i].bodyA < state->numObjects &&
+			state->contacts[i].bodyB >= CONTACT_STATIC && state->contacts[i].bodyB < state->numObjects;
+	}
+
+	fclose(file);
+	return result;
+}
+
+void SceneFindContacts(Scene *scene, float deltaTime)
+{
+	int i, j;
+
+	/* ordered by first body, then second (static mesh, floor, bodies), as ContactBegin requires */
+	ContactBegin(&scene->contacts);
+	for (i = 0; i < scene->numObjects; i++)
+	{
+		if (scene->staticMesh != NULL)
+			ContactFindMesh(&scene->contacts, &scene->objects[i], i, scene->staticMesh, &scene->params.contact, deltaTime);
+		ContactFindFloor(&scene->contacts, &scene->objects[i], i, &scene->params.contact, deltaTime);
+
+		for (j = i + 1; j < scene->numObjects; j++)
+			ContactFindBodies(&scene->contacts, &scene->objects[i], i, &scene->objects[j], j, &scene->pairCache[i][j], &scene->params.contact, deltaTime);
+	}
+}
+
+void SceneResetContacts(Scene *scene)
+{
+	int i, j;
+
+	for (i = 0; i < MAX_OBJECTS; i++)
+		for (j = 0; j < MAX_OBJECTS; j++)
+			GJKCacheReset(&scene->pairCache[i][j]);
+
+	ContactCacheReset(&scene->contacts);
+}
+
+int SceneSpawnRigidbody(Scene *scene, RigidbodyState *state)
+{
+	return SceneSpawnRigidbodys(scene, state, 1) == 1 ? scene->numObjects - 1 : -1;
+}
+
+int SceneSpawnRigidbodys(Scene *scene, RigidbodyState *states, int count)
+{
+	int first = scene->numObjects;
+	int i, j;
+
+	if (count < 0)
+		return 0;
+	if (count > MAX_OBJECTS - first)
+		count = MAX_OBJECTS - first;
+
+	/* restoring gives the vertices needed to find contacts in the first step */
+	for (i = first; i < first + count; i++)
+	{
+		RBRestoreState(&scene->objects[i], &states[i - first], &scene->params.body);
+
+		/* forget the pairs of any body that had this index before */
+		for (j = 0; j < MAX_OBJECTS; j++)
+		{
+			GJKCacheReset(&scene->pairCache[i][j]);
+			GJKCacheReset(&scene->pairCache[j][i]);
+		}
+	}
+
+	scene->numObjects += count;
+
+	/* new bodies can be placed in others */
+	SceneSeparateRigidbodys(scene, first);
+	return count;
+}
+
+void SceneRemoveRigidbody(Scene *scene, int index)
+{
+	int last, i;
+
+	if (index < 0 || index >= scene->numObjects)
+		return;
+
+	last = --scene->numObjects;
+	scene->objects[index] = scene->objects[last];
+
+	/* the last body's pairs follow it, the lower index first as SceneFindContacts queries them */
+	for (i = 0; i < last; i++)
+	{
+		if (i < index)
+			scene->pairCache[i][index] = scene->pairCache[i][last];
+		else if (i > index)
+		{
+			scene->pairCache[index][i] = scene->pairCache[i][last];
+			GJKCacheSwap(&scene->pairCache[index][i]);
+		}
+	}
+	for (i = 0; i < MAX_OBJECTS; i++)
+	{
+		GJKCacheReset(&scene->pairCache[i][last]);
+		GJKCacheReset(&scene->pairCache[last][i]);
+	}
+
+	ContactCacheRemoveBody(&scene->contacts, index, last);
+}
+
+void SceneSeparateRigidbodys(Scene *scene, int first)
+{
+	GJKResult result;
+	int i, j, pass;
+	bool moved = true;
+
+	/* move bodies apart, as contacts only push out a little each step */
+	for (pass = 0; pass < 10 && moved; pass++)
+	{
+		moved = false;
+		for (i = first; i < scene->numObjects; i++)
+		{
+			for (j = 0; j < i; j++)
+			{
+				if (RBBoundsOverlap(&scene->objects[i], &scene->objects[j], 0) && GJKQuery(&scene->objects[i], &scene->objects[j], NULL, &result))
+				{
+					scene->objects[i].position = Vec3Add(scene->objects[i].position, Vec3Mult(result.normal, result.distance - scene->params.contact.penetrationSlop));
+					RBCalculateVertices(&scene->objects[i]);
+					moved = true;
+				}
+			}
+		}
+	}
+}
+
+/* true if a body read from a file can be restored - a known shape with a positive size and density */
+static bool ValidObject(RigidbodyState *state)
+{
+	return (unsigned)state->shape < NUM_SHAPES && Positive(state->density) &&
+		Positive(state->dimensions.x) && Positive(state->dimensions.y) && Positive(state->dimensions.z);
+}
+
+/* true if x is finite and above zero */
+static bool Positive(float x)
+{
+	return isfinite(x) && x > 0;
+}
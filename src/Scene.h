@@ -1,87 +1,244 @@
-
-#ifndef SCENE_H
-#define SCENE_H
-
-#include "Camera.h"
-#include "Rigidbody.h"
-#include "Light.h"
-#include "Boolean.h"
-
-/**
- * @brief	Defines the maximum number of objects allowed. 
- */
-enum { MAX_OBJECTS = 10 };
-
-/**
- * @brief	Contains objects, light, and camera. 
- * @author	Matt Drage
- * @date	11/03/2012
- */
-struct Scene
-{
-	Camera camera;
-
-	Rigidbody objects[MAX_OBJECTS];
-	int numObjects;				/* current number of objects */
-	int numObjectsCreate;		/* number of objects created when the key c is pressed */
-
-	Light light;
-
-	bool createdObjects;		/* makes action occur once per key press rather than continuously */
-	bool increasedNumObjects;	/* makes action occur once per key press rather than continuously */	
-	bool decreasedNumObjects;	/* makes action occur once per key press rather than continuously */
-};
-typedef struct Scene Scene;
-
-/**
- * @brief	Handle user input.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	scene	The scene.
- */
-void SceneHandleInput(Scene *scene);
-
-/**
- * @brief	Creates and initializes rigidbodys.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	scene	The scene.
- */
-void SceneCreateRigidbodys(Scene *scene);
-
-/**
- * @brief	Initializes the scene
- * @author	Matt Drage
- * @date	11/03/2012
- * @param	scene	The scene.
- */
-void SceneInit(Scene *scene);
-
-/**
- * @brief	Updates the scene.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	scene		The scene.
- * @param	deltaTime	Time elapsed since last update.
- */
-void SceneUpdate(Scene *scene, float deltaTime);
-
-/**
- * @brief	Checks a rigidbody for collisions.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	scene	The scene.
- * @param 	rb   	The rigidbody.
- */
-void SceneCheckBodyCollisions(Scene *scene, Rigidbody *rb);
-
-/**
- * @brief	Resolve any penetrating objects.
- * @author	Matt Drage
- * @date	11/03/2012
- * @param 	scene	The scene.
- * @param 	rb   	The rigidbody.
- */
-void SceneResolvePenetration(Scene *scene, Rigidbody *rb);
-
-#endif
+
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "Rigidbody.h"
+#include "Contact.h"
+#include "MathUtils.h"
+#include "Boolean.h"
+
+/**
+ * @brief	Defines the maximum number of objects allowed. 
+ */
+enum { MAX_OBJECTS = 10 };
+
+/**
+ * @brief	Defines the default number of contact solver iterations per step. Contacts start
+ * 			from the impulses they ended the last step with, so few are needed.
+ */
+enum { SOLVER_ITERATIONS = 2 };
+
+/**
+ * @brief	Size of a cache line. Scenes start on one, so scenes stepped on different threads
+ * 			never write to the same line.
+ */
+enum { CACHE_LINE_SIZE = 64 };
+
+/**
+ * @brief	The physics parameters of a scene.
+ * @details	Plain floats and integers with no padding. SceneParamsInit fills in the defaults.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct SceneParams
+{
+	RigidbodyParams body;
+	ContactParams contact;
+	int solverIterations;
+};
+typedef struct SceneParams SceneParams;
+
+/**
+ * @brief	Contains the simulated objects and what they collide with.
+ * @details	Everything a step reads or writes is in the scene, so any number of scenes can be
+ * 			stepped on separate threads without locks.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ */
+struct Scene
+{
+	_Alignas(CACHE_LINE_SIZE) SceneParams params;
+	Random random;				/* for whatever places bodies in the scene - the simulation is not random */
+
+	Rigidbody objects[MAX_OBJECTS];
+	int numObjects;				/* current number of objects */
+	GJKCache pairCache[MAX_OBJECTS][MAX_OBJECTS];	/* collision state of each pair, by object index */
+	ContactCache contacts;		/* contacts of the last step, with their impulses */
+	StaticMesh *staticMesh;		/* walls or ground as well as the floor, or NULL - not owned by the scene */
+};
+typedef struct Scene Scene;
+
+/**
+ * @brief	Scene state file format version. Increase when RigidbodyState, Contact or GJKCache
+ * 			changes.
+ */
+enum { SCENE_STATE_VERSION = 3 };
+
+/**
+ * @brief	Snapshot of the simulated state of a scene.
+ * @details	Plain data - a snapshot can be copied with memcpy and restored any number of
+ * 			times to branch the simulation from the same point. The contacts and GJK state of
+ * 			each pair are kept too, so a restored scene takes exactly the steps the saved one
+ * 			would have.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct SceneState
+{
+	int numObjects;
+	RigidbodyState objects[MAX_OBJECTS];
+	int numContacts;
+	Contact contacts[MAX_CONTACTS];			/* last step's contacts, for their impulses */
+	GJKCache pairCache[MAX_OBJECTS][MAX_OBJECTS];	/* only pairs of used objects, first index lower */
+};
+typedef struct SceneState SceneState;
+
+/**
+ * @brief	Adds a body to the scene, eg. a die being thrown.
+ * @details	The state gives the shape, size, density, position, orientation, linear velocity
+ * 			and angular momentum (see RBAngularMomentumForSpin). The body is moved out of any
+ * 			body it overlaps; no others are moved.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	scene	The scene.
+ * @param 	state	The state to start from.
+ * @return	The index of the body, or -1 if the scene already has MAX_OBJECTS.
+ */
+int SceneSpawnRigidbody(Scene *scene, RigidbodyState *state);
+
+/**
+ * @brief	Adds many bodies to the scene at once.
+ * @details	As SceneSpawnRigidbody for each state, but the new bodies are separated in one pass.
+ * 			Bodies are added until the scene has MAX_OBJECTS.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	scene 	The scene.
+ * @param 	states	The states to start from.
+ * @param 	count 	Number of states - none are added if it is negative.
+ * @return	The number of bodies added, from index numObjects before the call.
+ */
+int SceneSpawnRigidbodys(Scene *scene, RigidbodyState *states, int count);
+
+/**
+ * @brief	Removes a body from the scene.
+ * @details	The last body takes its index, keeping its contacts and GJK state. Invalid indices
+ * 			are ignored.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	scene	The scene.
+ * @param 	index	Index of the body.
+ */
+void SceneRemoveRigidbody(Scene *scene, int index);
+
+/**
+ * @brief	Moves bodies out of any other body they overlap.
+ * @details	Each body from first on is pushed out of the bodies before it. Bodies before first
+ * 			are not moved, so new bodies can be added to the end without disturbing the rest.
+ * 			Vertices must be up to date.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	scene	The scene.
+ * @param 	first	Index of the first body that may be moved.
+ */
+void SceneSeparateRigidbodys(Scene *scene, int first);
+
+/**
+ * @brief	Fills in the default physics parameters.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	params	The params.
+ */
+void SceneParamsInit(SceneParams *params);
+
+/**
+ * @brief	Initializes the scene
+ * @details	The scene starts empty, with only the floor and the default parameters.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param	scene	The scene.
+ * @param	seed 	Seed of the scene's random generator.
+ */
+void SceneInit(Scene *scene, unsigned seed);
+
+/**
+ * @brief	Updates the scene.
+ * @details	Steps the simulation: forces, contacts, then positions.
+ * @author	Matt Drage
+ * @date	11/03/2012
+ * @param 	scene		The scene.
+ * @param	deltaTime	Time elapsed since last update.
+ */
+void SceneUpdate(Scene *scene, float deltaTime);
+
+/**
+ * @brief	Saves the simulated state of the scene.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	scene	The scene.
+ * @param 	state	The state to write to.
+ */
+void SceneSaveState(Scene *scene, SceneState *state);
+
+/**
+ * @brief	Restores the simulated state of the scene.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	scene	The scene.
+ * @param 	state	The saved state.
+ */
+void SceneRestoreState(Scene *scene, SceneState *state);
+
+/**
+ * @brief	Writes a scene state to a binary file.
+ * @details	Only the used objects, contacts and pairs are written. Values are stored in native
+ * 			byte order.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	state   	The state.
+ * @param 	filename	The file to write.
+ * @return	true if it succeeds, false if it fails.
+ */
+bool SceneStateWrite(SceneState *state, char *filename);
+
+/**
+ * @brief	Reads a scene state from a binary file.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	state   	The state to read into.
+ * @param 	filename	The file to read.
+ * @details	Bodies must have a known shape and finite, positive dimensions and density, and
+ * 			contacts must be between bodies in the state, so a corrupt file can't be restored.
+ * @return	true if it succeeds, false if the file is missing, invalid or from another version.
+ */
+bool SceneStateRead(SceneState *state, char *filename);
+
+/**
+ * @brief	Starting value for SceneStateHash.
+ */
+#define SCENE_HASH_SEED 14695981039346656037ULL
+
+/**
+ * @brief	Hashes a scene state.
+ * @details	Pass the previous result to hash a sequence of states, or SCENE_HASH_SEED to start.
+ * 			Only the objects are hashed. Two states hash the same only if their objects are
+ * 			bit-identical, so comparing hashes of a trajectory shows whether two builds simulate
+ * 			exactly the same rolls.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	state	The state.
+ * @param 	hash	The hash so far.
+ * @return	The updated hash.
+ */
+unsigned long long SceneStateHash(SceneState *state, unsigned long long hash);
+
+/**
+ * @brief	Finds the contacts between objects, and between objects and the floor or static mesh.
+ * @details	Contacts that were there last step keep their impulses. Call after integrating
+ * 			velocities, as gaps that will close this step are contacts too.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	scene	 	The scene.
+ * @param 	deltaTime	The step.
+ */
+void SceneFindContacts(Scene *scene, float deltaTime);
+
+/**
+ * @brief	Forgets the GJK state and contacts of every pair of objects.
+ * @details	Call when objects are replaced.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	scene	The scene.
+ */
+void SceneResetContacts(Scene *scene);
+
+#endif
@@ -0,0 +1,225 @@
+#include "Shape.h"
+#include "MathUtils.h"
+#include <math.h>
+#include <pthread.h>
+
+static Shape shapes[NUM_SHAPES];
+static pthread_once_t shapesBuilt = PTHREAD_ONCE_INIT;
+
+static const float PLANE_EPSILON = 1e-4f;
+
+static void AddNeighbour(Shape *shape, int a, int b)
+{
+	int i;
+
+	for (i = 0; i < shape->numNeighbours[a]; i++)
+		if (shape->neighbours[a][i] == b)
+			return;
+
+	if (shape->numNeighbours[a] < MAX_NEIGHBOURS)
+		shape->neighbours[a][shape->numNeighbours[a]++] = b;
+}
+
+bool ShapeBuild(Shape *shape, Vector3 *vertices, int numVerts)
+{
+	Vector3 normal, centre, u, w, offset;
+	float distance, d, angles[MAX_FACE_VERTS], swapAngle;
+	int i, j, k, m, n, above, below, count, swap, vertex;
+	bool found;
+
+	shape->numVerts = numVerts;
+	shape->numFaces = 0;
+	for (i = 0; i < numVerts; i++)
+	{
+		shape->vertices[i] = vertices[i];
+		shape->numNeighbours[i] = 0;
+	}
+
+	/* every plane through three points with all points on one side is a face */
+	for (i = 0; i < numVerts; i++)
+	for (j = i + 1; j < numVerts; j++)
+	for (k = j + 1; k < numVerts; k++)
+	{
+		normal = Vec3Cross(Vec3Sub(vertices[j], vertices[i]), Vec3Sub(vertices[k], vertices[i]));
+		if (Vec3Magnitude(normal) < PLANE_EPSILON)
+			continue;
+
+		normal = Vec3Normalize(normal);
+		distance = Vec3Dot(normal, vertices[i]);
+
+		above = below = 0;
+		for (m = 0; m < numVerts; m++)
+		{
+			d = Vec3Dot(normal, vertices[m]) - distance;
+			if (d > PLANE_EPSILON)
+				above++;
+			else if (d < -PLANE_EPSILON)
+				below++;
+		}
+
+		if (above > 0 && below > 0)
+			continue;
+
+		/* face outwards */
+		if (above > 0)
+		{
+			normal = Vec3Mult(normal, -1);
+			distance = -distance;
+		}
+
+		/* coplanar with a face already found */
+		found = false;
+		for (m = 0; m < shape->numFaces && !found; m++)
+			found = Vec3Dot(normal, shape->normals[m]) > 1 - PLANE_EPSILON;
+		if (found)
+			continue;
+
+		if (shape->numFaces == MAX_FACES)
+			return false;
+
+		/* collect the face's vertices */
+		n = shape->numFaces;
+		count = 0;
+		centre = Vec3New(0, 0, 0);
+		for (m = 0; m < numVerts; m++)
+		{
+			if (Vec3Dot(normal, vertices[m]) - distance > -PLANE_EPSILON)
+			{
+				if (count == MAX_FACE_VERTS)
+					return false;
+				shape->faces[n][count++] = m;
+				centre = Vec3Add(centre, vertices[m]);
+			}
+		}
+		centre = Vec3Mult(centre, 1.0f / count);
+
+		/* sort them by angle around the normal - counter-clockwise seen from outside */
+		u = Vec3Normalize(Vec3Sub(vertices[shape->faces[n][0]], centre));
+		w = Vec3Cross(normal, u);
+		for (m = 0; m < count; m++)
+		{
+			offset = Vec3Sub(vertices[shape->faces[n][m]], centre);
+			angles[m] = (float)atan2(Vec3Dot(offset, w), Vec3Dot(offset, u));
+		}
+		for (m = 1; m < count; m++)
+		{
+			for (swap = m; swap > 0 && angles[swap - 1] > angles[swap]; swap--)
+			{
+				swapAngle = angles[swap];
+				angles[swap] = angles[swap - 1];
+				angles[swap - 1] = swapAngle;
+
+				vertex = shape->faces[n][swap];
+				shape->faces[n][swap] = shape->faces[n][swap - 1];
+				shape->faces[n][swap - 1] = vertex;
+			}
+		}
+
+		shape->normals[n] = normal;
+		shape->numFaceVerts[n] = count;
+		shape->numFaces++;
+	}
+
+	/* edges join consecutive face vertices */
+	for (i = 0; i < shape->numFaces; i++)
+	{
+		for (j = 0; j < shape->numFaceVerts[i]; j++)
+		{
+			k = shape->faces[i][(j + 1) % shape->numFaceVerts[i]];
+			AddNeighbour(shape, shape->faces[i][j], k);
+			AddNeighbour(shape, k, shape->faces[i][j]);
+		}
+	}
+
+	return true;
+}
+
+static void BuildShapes()
+{
+	Vector3 v[MAX_VERTS];
+	const float phi = 1.61803399f;			/* golden ratio */
+	const float ringHeight = 0.1056f;		/* d10 ring offset, gives an apex height of 1 */
+	float fifth = PI / 5;
+	float apex, s;
+	int i, n;
+
+	/* six sided - same vertex order as the original box */
+	v[0] = Vec3New(-0.5f, -0.5f,  0.5f);
+	v[1] = Vec3New(-0.5f, -0.5f, -0.5f);
+	v[2] = Vec3New( 0.5f, -0.5f, -0.5f);
+	v[3] = Vec3New( 0.5f, -0.5f,  0.5f);
+	v[4] = Vec3New(-0.5f,  0.5f,  0.5f);
+	v[5] = Vec3New( 0.5f,  0.5f,  0.5f);
+	v[6] = Vec3New( 0.5f,  0.5f, -0.5f);
+	v[7] = Vec3New(-0.5f,  0.5f, -0.5f);
+	ShapeBuild(&shapes[SHAPE_BOX], v, 8);
+
+	/* tetrahedron - alternate corners of the box */
+	v[0] = Vec3New( 0.5f,  0.5f,  0.5f);
+	v[1] = Vec3New( 0.5f, -0.5f, -0.5f);
+	v[2] = Vec3New(-0.5f,  0.5f, -0.5f);
+	v[3] = Vec3New(-0.5f, -0.5f,  0.5f);
+	ShapeBuild(&shapes[SHAPE_D4], v, 4);
+
+	/* octahedron */
+	v[0] = Vec3New( 0.5f, 0, 0);	v[1] = Vec3New(-0.5f, 0, 0);
+	v[2] = Vec3New(0,  0.5f, 0);	v[3] = Vec3New(0, -0.5f, 0);
+	v[4] = Vec3New(0, 0,  0.5f);	v[5] = Vec3New(0, 0, -0.5f);
+	ShapeBuild(&shapes[SHAPE_D8], v, 6);
+
+	/* pentagonal trapezohedron - two apexes and a zig-zag ring of ten; the apex height
+	   keeps each kite face planar */
+	apex = ringHeight * (1 + Cos(fifth)) / (1 - Cos(fifth));
+	v[0] = Vec3New(0,  0.5f * apex, 0);
+	v[1] = Vec3New(0, -0.5f * apex, 0);
+	for (i = 0; i < 10; i++)
+	{
+		v[2 + i] = Vec3New(0.5f * Cos(i * fifth), i % 2 == 0 ? 0.5f * ringHeight : -0.5f * ringHeight, 0.5f * Sin(i * fifth));
+	}
+	ShapeBuild(&shapes[SHAPE_D10], v, 12);
+
+	/* dodecahedron - cube corners plus three golden rectangles */
+	s = 0.5f / phi;
+	n = 0;
+	for (i = 0; i < 8; i++)
+		v[n++] = Vec3New(i & 1 ? s : -s, i & 2 ? s : -s, i & 4 ? s : -s);
+	for (i = 0; i < 4; i++)
+	{
+		v[n++] = Vec3New(0, (i & 1 ? s : -s) / phi, (i & 2 ? s : -s) * phi);
+		v[n++] = Vec3New((i & 1 ? s : -s) / phi, (i & 2 ? s : -s) * phi, 0);
+		v[n++] = Vec3New((i & 2 ? s : -s) * phi, 0, (i & 1 ? s : -s) / phi);
+	}
+	ShapeBuild(&shapes[SHAPE_D12], v, n);
+
+	/* icosahedron - three golden rectangles */
+	n = 0;
+	for (i = 0; i < 4; i++)
+	{
+		v[n++] = Vec3New(0, i & 1 ? s : -s, (i & 2 ? s : -s) * phi);
+		v[n++] = Vec3New(i & 1 ? s : -s, (i & 2 ? s : -s) * phi, 0);
+		v[n++] = Vec3New((i & 2 ? s : -s) * phi, 0, i & 1 ? s : -s);
+	}
+	ShapeBuild(&shapes[SHAPE_D20], v, n);
+}
+
+const Shape *ShapeGet(ShapeType type)
+{
+	pthread_once(&shapesBuilt, BuildShapes);
+	return &shapes[type];
+}
+
+bool ShapeFromSides(int sides, ShapeType *type)
+{
+	int i;
+
+	for (i = 0; i < NUM_SHAPES; i++)
+	{
+		if (ShapeGet((ShapeType)i)->numFaces == sides)
+		{
+			*type = (ShapeType)i;
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file	Shape.h
+ * @brief	Convex die shapes and their topology.
+ */
+
+#ifndef SHAPE_H
+#define SHAPE_H
+
+#include "Vector3.h"
+#include "Boolean.h"
+
+/**
+ * @brief	Defines the maximum amount of verticies, faces and per face/vertex links a shape can have. 
+ */
+enum { MAX_VERTS = 20, MAX_FACES = 20, MAX_FACE_VERTS = 5, MAX_NEIGHBOURS = 5 };
+
+/**
+ * @brief	The die shapes. SHAPE_BOX is the six sided die. 
+ */
+enum ShapeType { SHAPE_BOX = 0, SHAPE_D4, SHAPE_D8, SHAPE_D10, SHAPE_D12, SHAPE_D20, NUM_SHAPES };
+typedef enum ShapeType ShapeType;
+
+/**
+ * @brief	Topology of a convex shape, shared by every rigidbody of that type.
+ * @details	Vertices fit the box [-0.5, 0.5] on each axis and are centred on the centre of mass,
+ * 			so scaling them by a rigidbody's dimensions gives its body space vertices.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct Shape
+{
+	int numVerts;
+	Vector3 vertices[MAX_VERTS];
+
+	int numFaces;
+	Vector3 normals[MAX_FACES];							/* outward unit normals */
+	int numFaceVerts[MAX_FACES];
+	int faces[MAX_FACES][MAX_FACE_VERTS];				/* vertex indexes, counter-clockwise seen from outside */
+
+	int numNeighbours[MAX_VERTS];
+	int neighbours[MAX_VERTS][MAX_NEIGHBOURS];			/* vertices sharing an edge, for hill climbing */
+};
+typedef struct Shape Shape;
+
+/**
+ * @brief	Gets the topology of a shape type.
+ * @details	The shapes are built on first use.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param	type	The shape type.
+ * @return	The shape.
+ */
+const Shape *ShapeGet(ShapeType type);
+
+/**
+ * @brief	Gets the shape type of a die with the given number of sides.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param	sides	The number of sides.
+ * @param 	type 	The shape type.
+ * @return	true if there is a die with that many sides.
+ */
+bool ShapeFromSides(int sides, ShapeType *type);
+
+/**
+ * @brief	Builds the faces and edges of the convex hull of a set of points.
+ * @details	Used internally by ShapeGet. Every point must be a corner of the hull. Coplanar
+ * 			triangles are merged into a single face.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	shape   	The shape to build.
+ * @param 	vertices	The points.
+ * @param	numVerts	The number of points.
+ * @return	true if it succeeds, false if a face or vertex has too many links.
+ */
+bool ShapeBuild(Shape *shape, Vector3 *vertices, int numVerts);
+
+#endif
@@ -0,0 +1,341 @@
+#include "StaticMesh.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* true if two boxes overlap */
+static bool BoxesOverlap(Vector3 minA, Vector3 maxA, Vector3 minB, Vector3 maxB)
+{
+	return minA.x <= maxB.x && maxA.x >= minB.x && minA.y <= maxB.y && maxA.y >= minB.y && minA.z <= maxB.z && maxA.z >= minB.z;
+}
+
+/* grows a box to contain a point */
+static void BoxAdd(Vector3 *min, Vector3 *max, Vector3 point)
+{
+	if (point.x < min->x) min->x = point.x;
+	if (point.y < min->y) min->y = point.y;
+	if (point.z < min->z) min->z = point.z;
+	if (point.x > max->x) max->x = point.x;
+	if (point.y > max->y) max->y = point.y;
+	if (point.z > max->z) max->z = point.z;
+}
+
+/* bounds of a triangle */
+static void TriangleBounds(StaticTriangle *triangle, Vector3 *min, Vector3 *max)
+{
+	*min = *max = triangle->vertices[0];
+	BoxAdd(min, max, triangle->vertices[1]);
+	BoxAdd(min, max, triangle->vertices[2]);
+}
+
+/* reorders triangles (and their centroids) so the one at index k along an axis is in place,
+   with smaller ones before it and larger ones after */
+static void SelectTriangle(StaticTriangle *triangles, Vector3 *centroids, int count, int k, int axis)
+{
+	StaticTriangle triangle;
+	Vector3 centroid;
+	float pivot;
+	int low = 0, high = count - 1, i, j;
+
+	while (low < high)
+	{
+		pivot = Vec3GetElement(&centroids[(low + high) / 2], axis);
+		i = low;
+		j = high;
+		while (i <= j)
+		{
+			while (Vec3GetElement(&centroids[i], axis) < pivot)
+				i++;
+			while (Vec3GetElement(&centroids[j], axis) > pivot)
+				j--;
+			if (i <= j)
+			{
+				triangle = triangles[i]; triangles[i] = triangles[j]; triangles[j] = triangle;
+				centroid = centroids[i]; centroids[i] = centroids[j]; centroids[j] = centroid;
+				i++;
+				j--;
+			}
+		}
+
+		if (k <= j)
+			high = j;
+		else if (k >= i)
+			low = i;
+		else
+			break;
+	}
+}
+
+/* one side of a triangle, for finding which triangles share it */
+struct Edge
+{
+	int low, high;					/* vertex indices, lowest first */
+	int triangle;
+	int edge;						/* index of the edge's first vertex in the triangle */
+};
+typedef struct Edge Edge;
+
+/* sorts edges by their vertices */
+static int EdgeCompare(const void *a, const void *b)
+{
+	const Edge *edgeA = (const Edge*)a, *edgeB = (const Edge*)b;
+
+	if (edgeA->low != edgeB->low)
+		return edgeA->low < edgeB->low ? -1 : 1;
+	if (edgeA->high != edgeB->high)
+		return edgeA->high < edgeB->high ? -1 : 1;
+	return edgeA->triangle - edgeB->triangle;
+}
+
+/* marks the edges bodies need testing against - an edge of one triangle, or shared by two where
+   the surface bends away by more than a few degrees. A sharp shared edge is marked on only one
+   of its triangles, so it gives one contact */
+static bool FindSharpEdges(StaticMesh *mesh)
+{
+	StaticTriangle *triangle, *other;
+	Edge *edges;
+	int numEdges = mesh->numTriangles * 3, i, j, count;
+
+	edges = (Edge*)malloc((numEdges > 0 ? numEdges : 1) * sizeof(Edge));
+	if (edges == NULL)
+		return false;
+
+	for (i = 0; i < numEdges; i++)
+	{
+		triangle = &mesh->triangles[i / 3];
+		edges[i].low = triangle->indices[i % 3];
+		edges[i].high = triangle->indices[(i + 1) % 3];
+		if (edges[i].low > edges[i].high)
+		{
+			edges[i].low = triangle->indices[(i + 1) % 3];
+			edges[i].high = triangle->indices[i % 3];
+		}
+		edges[i].triangle = i / 3;
+		edges[i].edge = i % 3;
+		triangle->sharpEdges = 0;
+	}
+	qsort(edges, numEdges, sizeof(Edge), EdgeCompare);
+
+	for (i = 0; i < numEdges; i += count)
+	{
+		for (count = 1; i + count < numEdges && edges[i + count].low == edges[i].low && edges[i + count].high == edges[i].high; count++)
+			;
+
+		triangle = &mesh->triangles[edges[i].triangle];
+		if (count != 2)
+		{
+			/* boundary, or more than two triangles meeting - can't tell which way it bends */
+			for (j = i; j < i + count; j++)
+				mesh->triangles[edges[j].triangle].sharpEdges |= 1u << edges[j].edge;
+			continue;
+		}
+
+		/* the other triangle's far corner is behind this one's plane if the surface bends away */
+		other = &mesh->triangles[edges[i + 1].triangle];
+		if (Vec3Dot(Vec3Sub(other->vertices[(edges[i + 1].edge + 2) % 3], triangle->vertices[0]), triangle->normal) < 0 &&
+			Vec3Dot(triangle->normal, other->normal) < 0.995f)
+			triangle->sharpEdges |= 1u << edges[i].edge;
+	}
+
+	free(edges);
+	return true;
+}
+
+/* adds the node for a range of triangles and, below it, its subtree */
+static void BuildNode(StaticMesh *mesh, Vector3 *centroids, int first, int count)
+{
+	StaticMeshNode *node = &mesh->nodes[mesh->numNodes++];
+	Vector3 min, max, centroidMin, centroidMax, extent;
+	int i, axis;
+
+	TriangleBounds(&mesh->triangles[first], &node->min, &node->max);
+	centroidMin = centroidMax = centroids[first];
+	for (i = first + 1; i < first + count; i++)
+	{
+		TriangleBounds(&mesh->triangles[i], &min, &max);
+		BoxAdd(&node->min, &node->max, min);
+		BoxAdd(&node->min, &node->max, max);
+		BoxAdd(&centroidMin, &centroidMax, centroids[i]);
+	}
+
+	node->first = first;
+	node->count = count;
+	if (count > STATIC_MESH_LEAF_SIZE)
+	{
+		/* split at the median along the axis the triangles are most spread over */
+		extent = Vec3Sub(centroidMax, centroidMin);
+		axis = extent.x > extent.y && extent.x > extent.z ? 0 : (extent.y > extent.z ? 1 : 2);
+		SelectTriangle(&mesh->triangles[first], &centroids[first], count, count / 2, axis);
+
+		node->count = 0;
+		BuildNode(mesh, centroids, first, count / 2);
+		BuildNode(mesh, centroids, first + count / 2, count - count / 2);
+	}
+	node->skip = mesh->numNodes;
+}
+
+bool StaticMeshCreate(StaticMesh *mesh, const Vector3 *vertices, const int *indices, int numTriangles)
+{
+	StaticTriangle *triangle;
+	Vector3 *centroids;
+	Vector3 normal;
+	int i, j;
+
+	memset(mesh, 0, sizeof(StaticMesh));
+
+	mesh->triangles = (StaticTriangle*)malloc((numTriangles > 0 ? numTriangles : 1) * sizeof(StaticTriangle));
+	mesh->nodes = (StaticMeshNode*)malloc((numTriangles > 0 ? 2 * numTriangles : 1) * sizeof(StaticMeshNode));
+	centroids = (Vector3*)malloc((numTriangles > 0 ? numTriangles : 1) * sizeof(Vector3));
+	if (mesh->triangles == NULL || mesh->nodes == NULL || centroids == NULL)
+	{
+		free(centroids);
+		StaticMeshDestroy(mesh);
+		return false;
+	}
+
+	for (i = 0; i < numTriangles; i++)
+	{
+		triangle = &mesh->triangles[mesh->numTriangles];
+		for (j = 0; j < 3; j++)
+		{
+			triangle->indices[j] = indices[i * 3 + j];
+			triangle->vertices[j] = vertices[indices[i * 3 + j]];
+		}
+
+		/* skip triangles with no area - they have no normal */
+		normal = Vec3Cross(Vec3Sub(triangle->vertices[1], triangle->vertices[0]), Vec3Sub(triangle->vertices[2], triangle->vertices[0]));
+		if (Vec3Magnitude(normal) < 1e-12f)
+			continue;
+
+		triangle->normal = Vec3Normalize(normal);
+		centroids[mesh->numTriangles] = Vec3Div(Vec3Add(Vec3Add(triangle->vertices[0], triangle->vertices[1]), triangle->vertices[2]), 3);
+		mesh->numTriangles++;
+	}
+
+	if (!FindSharpEdges(mesh))
+	{
+		free(centroids);
+		StaticMeshDestroy(mesh);
+		return false;
+	}
+
+	if (mesh->numTriangles > 0)
+		BuildNode(mesh, centroids, 0, mesh->numTriangles);
+
+	free(centroids);
+	return true;
+}
+
+bool StaticMeshCreateHeightfield(StaticMesh *mesh, const float *heights, int width, int depth, float spacing, Vector3 origin)
+{
+	Vector3 *vertices;
+	int *indices;
+	int x, z, corner, numTriangles = 0;
+	bool result;
+
+	vertices = (Vector3*)malloc(width * depth * sizeof(Vector3));
+	indices = (int*)malloc((width - 1) * (depth - 1) * 6 * sizeof(int));
+	if (vertices == NULL || indices == NULL)
+	{
+		free(vertices);
+		free(indices);
+		return false;
+	}
+
+	for (z = 0; z < depth; z++)
+		for (x = 0; x < width; x++)
+			vertices[z * width + x] = Vec3Add(origin, Vec3New(x * spacing, heights[z * width + x], z * spacing));
+
+	/* two triangles per cell, counter-clockwise seen from above */
+	for (z = 0; z + 1 < depth; z++)
+	{
+		for (x = 0; x + 1 < width; x++)
+		{
+			corner = z * width + x;
+			indices[numTriangles * 3 + 0] = corner;
+			indices[numTriangles * 3 + 1] = corner + width;
+			indices[numTriangles * 3 + 2] = corner + 1;
+			numTriangles++;
+
+			indices[numTriangles * 3 + 0] = corner + 1;
+			indices[numTriangles * 3 + 1] = corner + width;
+			indices[numTriangles * 3 + 2] = corner + width + 1;
+			numTriangles++;
+		}
+	}
+
+	result = StaticMeshCreate(mesh, vertices, indices, numTriangles);
+
+	free(vertices);
+	free(indices);
+	return result;
+}
+
+bool StaticMeshCreateTray(StaticMesh *mesh, float width, float depth, float height)
+{
+	Vector3 vertices[8];
+	int indices[4 * 6];
+	int i, j;
+
+	/* corners anticlockwise seen from above, along the bottom then the top */
+	vertices[0] = Vec3New(-width / 2, 0, -depth / 2);
+	vertices[1] = Vec3New( width / 2, 0, -depth / 2);
+	vertices[2] = Vec3New( width / 2, 0,  depth / 2);
+	vertices[3] = Vec3New(-width / 2, 0,  depth / 2);
+	for (i = 0; i < 4; i++)
+		vertices[i + 4] = Vec3Add(vertices[i], Vec3New(0, height, 0));
+
+	/* a wall between each corner and the next, two triangles facing in */
+	for (i = 0; i < 4; i++)
+	{
+		j = (i + 1) % 4;
+		indices[i * 6 + 0] = i;
+		indices[i * 6 + 1] = j;
+		indices[i * 6 + 2] = j + 4;
+		indices[i * 6 + 3] = i;
+		indices[i * 6 + 4] = j + 4;
+		indices[i * 6 + 5] = i + 4;
+	}
+
+	return StaticMeshCreate(mesh, vertices, indices, 8);
+}
+
+void StaticMeshDestroy(StaticMesh *mesh)
+{
+	free(mesh->triangles);
+	free(mesh->nodes);
+	memset(mesh, 0, sizeof(StaticMesh));
+}
+
+int StaticMeshQuery(StaticMesh *mesh, Vector3 min, Vector3 max, int *triangles, int maxTriangles)
+{
+	StaticMeshNode *node;
+	Vector3 triangleMin, triangleMax;
+	int i = 0, j, found = 0;
+
+	/* depth first - a missed box or a finished leaf continues past its subtree */
+	while (i < mesh->numNodes)
+	{
+		node = &mesh->nodes[i];
+		if (!BoxesOverlap(min, max, node->min, node->max))
+		{
+			i = node->skip;
+			continue;
+		}
+
+		if (node->count == 0)
+		{
+			i++;
+			continue;
+		}
+
+		for (j = node->first; j < node->first + node->count && found < maxTriangles; j++)
+		{
+			TriangleBounds(&mesh->triangles[j], &triangleMin, &triangleMax);
+			if (BoxesOverlap(min, max, triangleMin, triangleMax))
+				triangles[found++] = j;
+		}
+		i = node->skip;
+	}
+
+	return found;
+}
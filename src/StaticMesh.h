@@ -0,0 +1,131 @@
+/**
+ * @file	StaticMesh.h
+ * @brief	Static triangle meshes (dice trays, boards, heightfields) that rigidbodys collide with.
+ */
+
+#ifndef STATICMESH_H
+#define STATICMESH_H
+
+#include "Vector3.h"
+#include "Boolean.h"
+
+/**
+ * @brief	Maximum number of triangles in a BVH leaf.
+ */
+enum { STATIC_MESH_LEAF_SIZE = 4 };
+
+/**
+ * @brief	A triangle of a static mesh.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct StaticTriangle
+{
+	Vector3 vertices[3];			/* counter-clockwise seen from the solid side's outside */
+	Vector3 normal;					/* unit normal, pointing out of the solid side */
+	int indices[3];					/* mesh vertex indices, so shared vertices can be told apart */
+	unsigned sharpEdges;			/* bit i set if the edge from vertex i is on the boundary or the
+									   surface bends away there - flat and hollow edges can't
+									   touch a body before a face or vertex does */
+};
+typedef struct StaticTriangle StaticTriangle;
+
+/**
+ * @brief	A node of a flattened bounding volume hierarchy.
+ * @details	Nodes are stored depth first, so a node's first child follows it and skip is the
+ * 			index just past its subtree. Queries walk the array forwards with no stack, jumping
+ * 			to skip past boxes that miss.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct StaticMeshNode
+{
+	Vector3 min, max;				/* bounds of every triangle below */
+	int skip;						/* next node to visit if this box misses, or after a leaf */
+	int first;						/* first triangle of a leaf */
+	int count;						/* number of triangles in a leaf, 0 for inner nodes */
+};
+typedef struct StaticMeshNode StaticMeshNode;
+
+/**
+ * @brief	A triangle mesh that never moves.
+ * @details	Triangles are reordered so each leaf's triangles are next to each other, and leaves
+ * 			are in the same order as their triangles - queries return triangles in index order.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct StaticMesh
+{
+	StaticTriangle *triangles;
+	int numTriangles;
+
+	StaticMeshNode *nodes;
+	int numNodes;
+};
+typedef struct StaticMesh StaticMesh;
+
+/**
+ * @brief	Creates a static mesh from indexed triangles.
+ * @details	Triangles sharing an edge must share its vertex indices for the edge to be found
+ * 			smooth.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	mesh		 	The mesh.
+ * @param 	vertices	 	The vertices.
+ * @param 	indices		 	Three vertex indices per triangle, counter-clockwise seen from the
+ * 							solid side's outside. Bodies are only pushed out that way.
+ * @param 	numTriangles	Number of triangles.
+ * @return	false if memory could not be allocated.
+ */
+bool StaticMeshCreate(StaticMesh *mesh, const Vector3 *vertices, const int *indices, int numTriangles);
+
+/**
+ * @brief	Creates a static mesh from a grid of heights.
+ * @details	Each cell is split into two triangles, facing up.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	mesh   	The mesh.
+ * @param 	heights	width * depth heights, in rows of increasing z.
+ * @param 	width  	Number of heights along x. At least 2.
+ * @param 	depth  	Number of heights along z. At least 2.
+ * @param 	spacing	Distance between neighbouring heights.
+ * @param 	origin 	Position of the first height's grid point.
+ * @return	false if memory could not be allocated.
+ */
+bool StaticMeshCreateHeightfield(StaticMesh *mesh, const float *heights, int width, int depth, float spacing, Vector3 origin);
+
+/**
+ * @brief	Creates the walls of a dice tray standing on the floor, centred on the origin.
+ * @details	The floor itself is the scene's. Walls face inwards.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	mesh  	The mesh.
+ * @param 	width 	Inside size along x.
+ * @param 	depth 	Inside size along z.
+ * @param 	height	Height of the walls.
+ * @return	false if memory could not be allocated.
+ */
+bool StaticMeshCreateTray(StaticMesh *mesh, float width, float depth, float height);
+
+/**
+ * @brief	Frees a static mesh.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	mesh	The mesh.
+ */
+void StaticMeshDestroy(StaticMesh *mesh);
+
+/**
+ * @brief	Finds the triangles whose bounds overlap a box.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	mesh		 	The mesh.
+ * @param 	min			 	The box's minimum corner.
+ * @param 	max			 	The box's maximum corner.
+ * @param 	triangles	 	Set to the triangle indices found, in increasing order.
+ * @param 	maxTriangles	Size of triangles. Further triangles are not returned.
+ * @return	Number of triangles found.
+ */
+int StaticMeshQuery(StaticMesh *mesh, Vector3 min, Vector3 max, int *triangles, int maxTriangles);
+
+#endif
@@ -0,0 +1,264 @@
+#include "TextureCache.h"
+#include "ImageTGA.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static unsigned LevelSize(unsigned size, unsigned level)
+{
+	size >>= level;
+	return size > 0 ? size : 1;
+}
+
+/* Gets the number of levels in a full chain down to 1x1. */
+static unsigned FullChainLevels(unsigned width, unsigned height)
+{
+	unsigned levels = 1;
+
+	while (LevelSize(width, levels - 1) > 1 || LevelSize(height, levels - 1) > 1)
+		levels++;
+
+	return levels;
+}
+
+/* Gets the size in bytes of the first numLevels levels of an RGBA chain. */
+static unsigned long long ChainSize(unsigned width, unsigned height, unsigned numLevels)
+{
+	unsigned long long size = 0;
+	unsigned i;
+
+	for (i = 0; i < numLevels; i++)
+		size += (unsigned long long)LevelSize(width, i) * LevelSize(height, i) * 4;
+
+	return size;
+}
+
+bool TextureCacheBuild(char *cacheFile, char **files, int numFiles)
+{
+	TextureCacheHeader header;
+	TextureCacheEntry *entries;
+	struct stat info;
+	ImageTGA tga;
+	unsigned char *levels, *level;
+	unsigned long long offset;
+	unsigned w, h, j;
+	unsigned long p;
+	int i;
+	FILE *file;
+	bool result = true;
+
+	entries = (TextureCacheEntry*)calloc(numFiles, sizeof(TextureCacheEntry));
+	if (entries == NULL)
+		return false;
+
+	file = fopen(cacheFile, "wb");
+	if (!file)
+	{
+		free(entries);
+		return false;
+	}
+
+	memcpy(header.magic, "DTXC", 4);
+	header.version = TEXTURE_CACHE_VERSION;
+	header.numEntries = numFiles;
+	header.reserved = 0;
+
+	/* pixel data starts after the entry table - written once entries are complete */
+	offset = sizeof(TextureCacheHeader) + numFiles * sizeof(TextureCacheEntry);
+	fseek(file, (long)offset, SEEK_SET);
+
+	for (i = 0; i < numFiles && result; i++)
+	{
+		if (stat(files[i], &info) != 0 || !TGALoad(&tga, files[i]))
+		{
+			result = false;
+			break;
+		}
+
+		strncpy(entries[i].path, files[i], sizeof(entries[i].path) - 1);
+		entries[i].modifiedTime = info.st_mtime;
+		entries[i].fileSize = info.st_size;
+		entries[i].width = tga.width;
+		entries[i].height = tga.height;
+		entries[i].offset = offset;
+
+		/* full chain down to 1x1 */
+		entries[i].numLevels = FullChainLevels(tga.width, tga.height);
+		entries[i].dataSize = ChainSize(tga.width, tga.height, entries[i].numLevels);
+
+		levels = (unsigned char*)malloc(entries[i].dataSize);
+		if (levels == NULL)
+		{
+			TGAFree(&tga);
+			result = false;
+			break;
+		}
+
+		/* expand level 0 to RGBA */
+		for (p = 0; p < (unsigned long)tga.width * tga.height; p++)
+		{
+			levels[p * 4 + 0] = tga.image[p * (tga.bpp / 8) + 0];
+			levels[p * 4 + 1] = tga.image[p * (tga.bpp / 8) + 1];
+			levels[p * 4 + 2] = tga.image[p * (tga.bpp / 8) + 2];
+			levels[p * 4 + 3] = tga.bpp == 32 ? tga.image[p * 4 + 3] : 255;
+		}
+		TGAFree(&tga);
+
+		/* build each level from the previous one */
+		level = levels;
+		for (j = 1; j < entries[i].numLevels; j++)
+		{
+			w = LevelSize(entries[i].width, j - 1);
+			h = LevelSize(entries[i].height, j - 1);
+			TextureCacheDownsample(level, w, h, level + w * h * 4);
+			level += w * h * 4;
+		}
+
+		if (fwrite(levels, entries[i].dataSize, 1, file) != 1)
+			result = false;
+
+		offset += entries[i].dataSize;
+		free(levels);
+	}
+
+	/* header and entry table */
+	fseek(file, 0, SEEK_SET);
+	if (result && (fwrite(&header, sizeof(header), 1, file) != 1 || fwrite(entries, sizeof(TextureCacheEntry), numFiles, file) != (size_t)numFiles))
+		result = false;
+
+	fclose(file);
+	free(entries);
+
+	if (!result)
+		remove(cacheFile);
+
+	return result;
+}
+
+bool TextureCacheOpen(TextureCache *cache, char *cacheFile)
+{
+	TextureCacheEntry *entry;
+	struct stat info;
+	unsigned i;
+	int file;
+
+	cache->data = NULL;
+
+	file = open(cacheFile, O_RDONLY);
+	if (file < 0)
+		return false;
+
+	if (fstat(file, &info) != 0 || (unsigned long)info.st_size < sizeof(TextureCacheHeader))
+	{
+		close(file);
+		return false;
+	}
+
+	cache->data = (unsigned char*)mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (cache->data == (unsigned char*)MAP_FAILED)
+	{
+		cache->data = NULL;
+		return false;
+	}
+
+	cache->size = info.st_size;
+	cache->header = (TextureCacheHeader*)cache->data;
+	cache->entries = (TextureCacheEntry*)(cache->data + sizeof(TextureCacheHeader));
+
+	/* validate header and that every entry lies inside the file */
+	if (memcmp(cache->header->magic, "DTXC", 4) != 0 || cache->header->version != TEXTURE_CACHE_VERSION ||
+		sizeof(TextureCacheHeader) + (unsigned long long)cache->header->numEntries * sizeof(TextureCacheEntry) > cache->size)
+	{
+		TextureCacheClose(cache);
+		return false;
+	}
+
+	/* levels are found from the dimensions, so the chain they describe must be the data stored */
+	for (i = 0; i < cache->header->numEntries; i++)
+	{
+		entry = &cache->entries[i];
+		if (entry->width == 0 || entry->height == 0 || entry->numLevels == 0 ||
+			entry->numLevels > FullChainLevels(entry->width, entry->height) ||
+			entry->dataSize != ChainSize(entry->width, entry->height, entry->numLevels) ||
+			entry->offset > cache->size || entry->dataSize > cache->size - entry->offset)
+		{
+			TextureCacheClose(cache);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void TextureCacheClose(TextureCache *cache)
+{
+	if (cache->data != NULL)
+		munmap(cache->data, cache->size);
+
+	cache->data = NULL;
+}
+
+TextureCacheEntry *TextureCacheFind(TextureCache *cache, char *file)
+{
+	struct stat info;
+	unsigned i;
+
+	if (cache->data == NULL || stat(file, &info) != 0)
+		return NULL;
+
+	for (i = 0; i < cache->header->numEntries; i++)
+	{
+		if (strncmp(cache->entries[i].path, file, sizeof(cache->entries[i].path)) == 0)
+		{
+			/* source changed since the cache was built */
+			if (cache->entries[i].modifiedTime != info.st_mtime || cache->entries[i].fileSize != info.st_size)
+				return NULL;
+
+			return &cache->entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+unsigned char *TextureCacheGetLevel(TextureCache *cache, TextureCacheEntry *entry, unsigned level, unsigned *width, unsigned *height)
+{
+	unsigned long long offset = entry->offset + ChainSize(entry->width, entry->height, level);
+
+	*width = LevelSize(entry->width, level);
+	*height = LevelSize(entry->height, level);
+
+	return cache->data + offset;
+}
+
+void TextureCacheDownsample(unsigned char *source, unsigned width, unsigned height, unsigned char *dest)
+{
+	unsigned destWidth = width > 1 ? width / 2 : 1;
+	unsigned destHeight = height > 1 ? height / 2 : 1;
+	unsigned x, y, x1, y1, c;
+
+	for (y = 0; y < destHeight; y++)
+	{
+		y1 = (y * 2 + 1 < height) ? y * 2 + 1 : y * 2;
+
+		for (x = 0; x < destWidth; x++)
+		{
+			x1 = (x * 2 + 1 < width) ? x * 2 + 1 : x * 2;
+
+			/* average 2x2 block, rounded */
+			for (c = 0; c < 4; c++)
+			{
+				dest[(y * destWidth + x) * 4 + c] = (unsigned char)((
+					source[(y * 2 * width + x * 2) * 4 + c] + source[(y * 2 * width + x1) * 4 + c] +
+					source[(y1 * width + x * 2) * 4 + c] + source[(y1 * width + x1) * 4 + c] + 2) / 4);
+			}
+		}
+	}
+}
@@ -0,0 +1,128 @@
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include "Boolean.h"
+
+/**
+ * @brief	Texture cache file format version. Increase when the layout changes. 
+ */
+enum { TEXTURE_CACHE_VERSION = 1 };
+
+/**
+ * @brief	Header at the start of a texture cache file. 
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct TextureCacheHeader
+{
+	char magic[4];					/* "DTXC" */
+	unsigned int version;
+	unsigned int numEntries;
+	unsigned int reserved;
+};
+typedef struct TextureCacheHeader TextureCacheHeader;
+
+/**
+ * @brief	Describes one cached texture. 
+ * @details	Entries follow the header. Pixel data is RGBA, 8 bits per channel, with each
+ * 			mip level stored directly after the previous one, largest first.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct TextureCacheEntry
+{
+	char path[256];					/* source image path, as passed to TextureCacheFind */
+	long long modifiedTime;			/* source mtime when the entry was built */
+	long long fileSize;				/* source size when the entry was built */
+	unsigned int width;
+	unsigned int height;
+	unsigned int numLevels;
+	unsigned int reserved;
+	unsigned long long offset;		/* offset of level 0 from the start of the file */
+	unsigned long long dataSize;	/* size of all levels */
+};
+typedef struct TextureCacheEntry TextureCacheEntry;
+
+/**
+ * @brief	An open (memory mapped) texture cache. 
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct TextureCache
+{
+	unsigned char *data;
+	unsigned long size;
+	TextureCacheHeader *header;
+	TextureCacheEntry *entries;
+};
+typedef struct TextureCache TextureCache;
+
+/**
+ * @brief	Builds a texture cache file from a list of TGA images.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cacheFile	The cache file to write.
+ * @param 	files		The image files.
+ * @param	numFiles	The number of image files.
+ * @return	true if it succeeds, false if it fails.
+ */
+bool TextureCacheBuild(char *cacheFile, char **files, int numFiles);
+
+/**
+ * @brief	Opens a texture cache file.
+ * @details	The file is rejected if any entry's dimensions and number of levels don't give its
+ * 			data size, or its data doesn't lie inside the file.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache		The cache.
+ * @param 	cacheFile	The cache file.
+ * @return	true if it succeeds, false if the file is missing or invalid.
+ */
+bool TextureCacheOpen(TextureCache *cache, char *cacheFile);
+
+/**
+ * @brief	Closes a texture cache.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache	The cache.
+ */
+void TextureCacheClose(TextureCache *cache);
+
+/**
+ * @brief	Finds the cached version of an image.
+ * @details	Entries are only returned if the source file's mtime and size are unchanged.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache	The cache.
+ * @param 	file 	The source image file.
+ * @return	The entry, or NULL if the image is not cached or is out of date.
+ */
+TextureCacheEntry *TextureCacheFind(TextureCache *cache, char *file);
+
+/**
+ * @brief	Gets the pixel data of one mip level.
+ * @details	TextureCacheOpen checks every entry's levels lie inside the file.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	cache 	The cache.
+ * @param 	entry 	The entry.
+ * @param	level 	The mip level, 0 is full size, less than entry->numLevels.
+ * @param 	width 	Set to the width of the level.
+ * @param 	height	Set to the height of the level.
+ * @return	The RGBA pixel data.
+ */
+unsigned char *TextureCacheGetLevel(TextureCache *cache, TextureCacheEntry *entry, unsigned level, unsigned *width, unsigned *height);
+
+/**
+ * @brief	Downsamples an RGBA image by half with a box filter.
+ * @details	Used internally by TextureCacheBuild. Odd edges are clamped.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	source	The source pixels.
+ * @param	width 	The source width.
+ * @param	height	The source height.
+ * @param 	dest  	The destination pixels, max(1, width/2) x max(1, height/2).
+ */
+void TextureCacheDownsample(unsigned char *source, unsigned width, unsigned height, unsigned char *dest);
+
+#endif
@@ -0,0 +1,67 @@
+#include "TextureLoader.h"
+#include <pthread.h>
+#include <unistd.h>
+
+static TextureLoadItem *loadItems;
+static int loadCount;
+static int nextItem;
+static pthread_t threads[MAX_LOADER_THREADS];
+static int numThreads;
+
+void TextureLoaderStart(TextureLoadItem *items, int count)
+{
+	long numCores = sysconf(_SC_NPROCESSORS_ONLN);
+	int i;
+
+	loadItems = items;
+	loadCount = count;
+	nextItem = 0;
+
+	/* one thread per texture, limited by available cores */
+	numThreads = count;
+	if (numCores > 0 && numThreads > numCores)
+		numThreads = (int)numCores;
+	if (numThreads > MAX_LOADER_THREADS)
+		numThreads = MAX_LOADER_THREADS;
+
+	for (i = 0; i < numThreads; i++)
+	{
+		/* fall back to loading on the calling thread */
+		if (pthread_create(&threads[i], NULL, TextureLoaderWorker, NULL) != 0)
+		{
+			numThreads = i;
+			TextureLoaderWorker(NULL);
+			break;
+		}
+	}
+}
+
+void TextureLoaderWait()
+{
+	int i;
+
+	for (i = 0; i < numThreads; i++)
+		pthread_join(threads[i], NULL);
+
+	numThreads = 0;
+}
+
+void *TextureLoaderWorker(void *arg)
+{
+	unsigned long j;
+	volatile unsigned char touch = 0;
+	int i;
+
+	while ((i = __sync_fetch_and_add(&nextItem, 1)) < loadCount)
+	{
+		loadItems[i].loaded = TGAMap(&loadItems[i].tga, loadItems[i].filename);
+
+		/* fault in mapped raw images here rather than during upload */
+		if (loadItems[i].loaded && loadItems[i].tga.mapping != NULL)
+			for (j = 0; j < loadItems[i].tga.imageSize; j += 4096)
+				touch = loadItems[i].tga.image[j];
+	}
+
+	(void)touch;
+	return NULL;
+}
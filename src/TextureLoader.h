@@ -0,0 +1,53 @@
+#ifndef TEXTURELOADER_H
+#define TEXTURELOADER_H
+
+#include "ImageTGA.h"
+#include "Boolean.h"
+
+/**
+ * @brief	Defines the maximum number of worker threads used to load textures. 
+ */
+enum { MAX_LOADER_THREADS = 8 };
+
+/**
+ * @brief	A texture file to be loaded in the background. 
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct TextureLoadItem
+{
+	char filename[256];
+	ImageTGA tga;
+	bool loaded;			/* false if the file could not be read */
+};
+typedef struct TextureLoadItem TextureLoadItem;
+
+/**
+ * @brief	Starts loading textures on a pool of worker threads.
+ * @details	Returns immediately. Items must stay valid until TextureLoaderWait returns.
+ * 			Images are mapped with TGAMap so must be released with TGAFree.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	items	The textures to load.
+ * @param	count	The number of textures.
+ */
+void TextureLoaderStart(TextureLoadItem *items, int count);
+
+/**
+ * @brief	Waits for all textures started by TextureLoaderStart to finish loading.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+void TextureLoaderWait();
+
+/**
+ * @brief	Worker thread function.
+ * @details	Used internally by the texture loader. Takes items from the queue until it is empty.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	arg	Not used.
+ * @return	NULL.
+ */
+void *TextureLoaderWorker(void *arg);
+
+#endif
@@ -0,0 +1,356 @@
+#include "Trajectory.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+static const float POSITION_SCALE = 4096.0f;
+static const float SQRT2 = 1.41421356f;
+
+static void WriteFloat(unsigned char *data, float value)
+{
+	unsigned int bits;
+	memcpy(&bits, &value, 4);
+	data[0] = (unsigned char)bits; data[1] = (unsigned char)(bits >> 8);
+	data[2] = (unsigned char)(bits >> 16); data[3] = (unsigned char)(bits >> 24);
+}
+
+static float ReadFloat(unsigned char *data)
+{
+	unsigned int bits = data[0] | (data[1] << 8) | (data[2] << 16) | ((unsigned int)data[3] << 24);
+	float value;
+	memcpy(&value, &bits, 4);
+	return value;
+}
+
+static void WriteShort(unsigned char *data, int value)
+{
+	data[0] = (unsigned char)value;
+	data[1] = (unsigned char)(value >> 8);
+}
+
+static int ReadShort(unsigned char *data)
+{
+	return (short)(data[0] | (data[1] << 8));
+}
+
+static void AddKeyframe(Trajectory *trajectory, long offset, int frame)
+{
+	if (trajectory->numKeyframes == trajectory->maxKeyframes)
+	{
+		trajectory->maxKeyframes = trajectory->maxKeyframes ? trajectory->maxKeyframes * 2 : 64;
+		trajectory->keyframeOffsets = (long*)realloc(trajectory->keyframeOffsets, trajectory->maxKeyframes * sizeof(long));
+		trajectory->keyframeFrames = (int*)realloc(trajectory->keyframeFrames, trajectory->maxKeyframes * sizeof(int));
+	}
+
+	trajectory->keyframeOffsets[trajectory->numKeyframes] = offset;
+	trajectory->keyframeFrames[trajectory->numKeyframes] = frame;
+	trajectory->numKeyframes++;
+}
+
+bool TrajectoryCreate(Trajectory *trajectory, char *filename, float stepTime)
+{
+	unsigned char header[16];
+
+	memset(trajectory, 0, sizeof(Trajectory));
+
+	trajectory->file = fopen(filename, "wb");
+	if (!trajectory->file)
+		return false;
+
+	trajectory->writing = true;
+	trajectory->stepTime = stepTime;
+	trajectory->numBodies = -1;
+
+	memcpy(header, "DTRJ", 4);
+	WriteShort(&header[4], TRAJECTORY_VERSION);
+	WriteShort(&header[6], TRAJECTORY_KEYFRAME_INTERVAL);
+	WriteFloat(&header[8], stepTime);
+	memset(&header[12], 0, 4);
+
+	return fwrite(header, sizeof(header), 1, trajectory->file) == 1;
+}
+
+bool TrajectoryRecord(Trajectory *trajectory, Scene *scene)
+{
+	unsigned char data[3 + MAX_OBJECTS * TRAJECTORY_KEYFRAME_BODY_SIZE];
+	unsigned char *cur = &data[3];
+	Rigidbody *rb;
+	float q[4];
+	int delta[MAX_OBJECTS][3];
+	bool keyframe;
+	int i, j;
+
+	/* keyframe on interval, body count change, or a delta too large for 16 bits */
+	keyframe = trajectory->sinceKeyframe == 0 || trajectory->numBodies != scene->numObjects;
+	for (i = 0; i < scene->numObjects && !keyframe; i++)
+	{
+		rb = &scene->objects[i];
+		for (j = 0; j < 3 && !keyframe; j++)
+		{
+			delta[i][j] = (int)floor((Vec3GetElement(&rb->position, j) - Vec3GetElement(&trajectory->positions[i], j)) * POSITION_SCALE + 0.5f);
+			if (delta[i][j] < -32768 || delta[i][j] > 32767)
+				keyframe = true;
+		}
+		if (!Vec3Equal(rb->dimensions, trajectory->dimensions[i]) || rb->shapeType != trajectory->shapes[i])
+			keyframe = true;
+	}
+
+	if (keyframe)
+	{
+		AddKeyframe(trajectory, ftell(trajectory->file), trajectory->frame);
+		trajectory->numBodies = scene->numObjects;
+		trajectory->sinceKeyframe = 0;
+
+		for (i = 0; i < scene->numObjects; i++, cur += TRAJECTORY_KEYFRAME_BODY_SIZE)
+		{
+			rb = &scene->objects[i];
+			M3ToQuaternion(rb->orientation, q);
+			for (j = 0; j < 3; j++)
+			{
+				WriteFloat(&cur[j * 4], Vec3GetElement(&rb->dimensions, j));
+				WriteFloat(&cur[12 + j * 4], Vec3GetElement(&rb->position, j));
+			}
+			for (j = 0; j < 4; j++)
+				WriteFloat(&cur[24 + j * 4], q[j]);
+			cur[40] = (unsigned char)rb->shapeType;
+
+			trajectory->dimensions[i] = rb->dimensions;
+			trajectory->shapes[i] = rb->shapeType;
+			trajectory->positions[i] = rb->position;
+		}
+	}
+	else
+	{
+		for (i = 0; i < scene->numObjects; i++, cur += TRAJECTORY_DELTA_BODY_SIZE)
+		{
+			/* track the decoded position so quantization error does not accumulate */
+			for (j = 0; j < 3; j++)
+			{
+				WriteShort(&cur[j * 2], delta[i][j]);
+				Vec3SetElement(&trajectory->positions[i], j, Vec3GetElement(&trajectory->positions[i], j) + delta[i][j] / POSITION_SCALE);
+			}
+			TrajectoryPackOrientation(scene->objects[i].orientation, &cur[6]);
+		}
+	}
+
+	data[0] = keyframe ? 'K' : 'D';
+	WriteShort(&data[1], scene->numObjects);
+
+	if (++trajectory->sinceKeyframe == TRAJECTORY_KEYFRAME_INTERVAL)
+		trajectory->sinceKeyframe = 0;
+	trajectory->frame++;
+	trajectory->numFrames++;
+
+	return fwrite(data, cur - data, 1, trajectory->file) == 1;
+}
+
+bool TrajectoryOpen(Trajectory *trajectory, char *filename)
+{
+	unsigned char header[16];
+	unsigned char record[3];
+	long offset;
+	int numBodies;
+
+	memset(trajectory, 0, sizeof(Trajectory));
+
+	trajectory->file = fopen(filename, "rb");
+	if (!trajectory->file)
+		return false;
+
+	if (fread(header, sizeof(header), 1, trajectory->file) != 1 || memcmp(header, "DTRJ", 4) != 0 ||
+		ReadShort(&header[4]) != TRAJECTORY_VERSION)
+	{
+		TrajectoryClose(trajectory);
+		return false;
+	}
+
+	trajectory->stepTime = ReadFloat(&header[8]);
+
+	/* index keyframes by skipping over record payloads */
+	offset = sizeof(header);
+	while (fread(record, sizeof(record), 1, trajectory->file) == 1)
+	{
+		numBodies = ReadShort(&record[1]);
+		if ((record[0] != 'K' && record[0] != 'D') || numBodies < 0 || numBodies > MAX_OBJECTS ||
+			(record[0] == 'D' && trajectory->numKeyframes == 0))
+			break;
+
+		if (record[0] == 'K')
+			AddKeyframe(trajectory, offset, trajectory->numFrames);
+
+		offset += sizeof(record) + numBodies * (record[0] == 'K' ? TRAJECTORY_KEYFRAME_BODY_SIZE : TRAJECTORY_DELTA_BODY_SIZE);
+		if (fseek(trajectory->file, offset, SEEK_SET) != 0)
+			break;
+
+		trajectory->numFrames++;
+	}
+
+	if (trajectory->numKeyframes == 0)
+	{
+		TrajectoryClose(trajectory);
+		return false;
+	}
+
+	return TrajectorySeek(trajectory, 0);
+}
+
+bool TrajectorySeek(Trajectory *trajectory, int frame)
+{
+	int i, key = 0;
+
+	if (trajectory->writing || frame < 0 || frame >= trajectory->numFrames)
+		return false;
+
+	/* last keyframe at or before the frame */
+	for (i = 0; i < trajectory->numKeyframes && trajectory->keyframeFrames[i] <= frame; i++)
+		key = i;
+
+	fseek(trajectory->file, trajectory->keyframeOffsets[key], SEEK_SET);
+	trajectory->frame = trajectory->keyframeFrames[key];
+
+	/* decode up to the requested frame - positions are accumulated as we go */
+	while (trajectory->frame < frame)
+	{
+		if (!TrajectoryPlay(trajectory, NULL))
+			return false;
+	}
+
+	return true;
+}
+
+bool TrajectoryPlay(Trajectory *trajectory, Scene *scene)
+{
+	unsigned char data[MAX_OBJECTS * TRAJECTORY_KEYFRAME_BODY_SIZE];
+	unsigned char record[3];
+	unsigned char *cur = data;
+	Rigidbody *rb;
+	float q[4];
+	int numBodies, bodySize;
+	int i, j;
+
+	if (trajectory->writing || fread(record, sizeof(record), 1, trajectory->file) != 1)
+		return false;
+
+	numBodies = ReadShort(&record[1]);
+	if (numBodies < 0 || numBodies > MAX_OBJECTS || (record[0] == 'D' && numBodies != trajectory->numBodies))
+		return false;
+
+	bodySize = record[0] == 'K' ? TRAJECTORY_KEYFRAME_BODY_SIZE : TRAJECTORY_DELTA_BODY_SIZE;
+	if (numBodies > 0 && fread(data, numBodies * bodySize, 1, trajectory->file) != 1)
+		return false;
+
+	trajectory->numBodies = numBodies;
+	if (scene != NULL)
+		scene->numObjects = numBodies;
+
+	for (i = 0; i < numBodies; i++, cur += bodySize)
+	{
+		rb = scene != NULL ? &scene->objects[i] : NULL;
+
+		if (record[0] == 'K')
+		{
+			for (j = 0; j < 3; j++)
+			{
+				Vec3SetElement(&trajectory->dimensions[i], j, ReadFloat(&cur[j * 4]));
+				Vec3SetElement(&trajectory->positions[i], j, ReadFloat(&cur[12 + j * 4]));
+			}
+			for (j = 0; j < 4; j++)
+				q[j] = ReadFloat(&cur[24 + j * 4]);
+			if (cur[40] >= NUM_SHAPES)
+				return false;
+			trajectory->shapes[i] = (ShapeType)cur[40];
+
+			if (rb != NULL)
+			{
+				RBInitShape(rb, trajectory->shapes[i], trajectory->positions[i], trajectory->dimensions[i], 1);
+				rb->orientation = M3FromQuaternion(q);
+			}
+		}
+		else
+		{
+			for (j = 0; j < 3; j++)
+				Vec3SetElement(&trajectory->positions[i], j, Vec3GetElement(&trajectory->positions[i], j) + ReadShort(&cur[j * 2]) / POSITION_SCALE);
+
+			if (rb != NULL)
+			{
+				if (!Vec3Equal(rb->dimensions, trajectory->dimensions[i]) || rb->shapeType != trajectory->shapes[i])
+					RBInitShape(rb, trajectory->shapes[i], trajectory->positions[i], trajectory->dimensions[i], 1);
+				rb->position = trajectory->positions[i];
+				rb->orientation = TrajectoryUnpackOrientation(&cur[6]);
+			}
+		}
+
+		if (rb != NULL)
+			RBCalculateVertices(rb);
+	}
+
+	trajectory->frame++;
+	return true;
+}
+
+void TrajectoryClose(Trajectory *trajectory)
+{
+	if (trajectory->file)
+		fclose(trajectory->file);
+
+	free(trajectory->keyframeOffsets);
+	free(trajectory->keyframeFrames);
+	memset(trajectory, 0, sizeof(Trajectory));
+}
+
+void TrajectoryPackOrientation(Matrix3x3 orientation, unsigned char *data)
+{
+	unsigned long long bits;
+	float q[4];
+	int i, largest = 0;
+	int shift = 30;
+
+	M3ToQuaternion(orientation, q);
+
+	for (i = 1; i < 4; i++)
+		if (fabs(q[i]) > fabs(q[largest]))
+			largest = i;
+
+	/* q and -q are the same rotation - make the dropped component positive */
+	if (q[largest] < 0)
+		for (i = 0; i < 4; i++)
+			q[i] = -q[i];
+
+	/* remaining components lie in [-1/sqrt2, 1/sqrt2] */
+	bits = (unsigned long long)largest << 45;
+	for (i = 0; i < 4; i++)
+	{
+		if (i == largest)
+			continue;
+		bits |= (unsigned long long)(long)floor((q[i] * SQRT2 + 1.0f) * 0.5f * 32767.0f + 0.5f) << shift;
+		shift -= 15;
+	}
+
+	for (i = 0; i < 6; i++)
+		data[i] = (unsigned char)(bits >> (i * 8));
+}
+
+Matrix3x3 TrajectoryUnpackOrientation(unsigned char *data)
+{
+	unsigned long long bits = 0;
+	float q[4];
+	float sum = 0;
+	int i, largest;
+	int shift = 30;
+
+	for (i = 0; i < 6; i++)
+		bits |= (unsigned long long)data[i] << (i * 8);
+
+	largest = (int)(bits >> 45) & 3;
+	for (i = 0; i < 4; i++)
+	{
+		if (i == largest)
+			continue;
+		q[i] = (((bits >> shift) & 0x7FFF) / 32767.0f * 2.0f - 1.0f) / SQRT2;
+		sum += q[i] * q[i];
+		shift -= 15;
+	}
+	q[largest] = (float)sqrt(sum < 1 ? 1 - sum : 0);
+
+	return M3FromQuaternion(q);
+}
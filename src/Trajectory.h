@@ -0,0 +1,141 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <stdio.h>
+#include "Scene.h"
+#include "Boolean.h"
+
+/**
+ * @brief	Trajectory file format version. Increase when the frame layout changes. 
+ */
+enum { TRAJECTORY_VERSION = 2 };
+
+/**
+ * @brief	Number of frames between keyframes. 
+ */
+enum { TRAJECTORY_KEYFRAME_INTERVAL = 64 };
+
+/**
+ * @brief	Size in bytes of one body in a keyframe and in a delta frame. 
+ */
+enum { TRAJECTORY_KEYFRAME_BODY_SIZE = 41, TRAJECTORY_DELTA_BODY_SIZE = 12 };
+
+/**
+ * @brief	Recorded motion of a scene, stored as quantized per-frame deltas. 
+ * @details	File layout: 16 byte header, then one record per frame. Each record starts
+ * 			with a type byte ('K' keyframe or 'D' delta) and a 16 bit body count.
+ * 			Keyframe bodies store dimensions, position and orientation as floats, then the shape.
+ * 			Delta bodies store the position change in 1/4096 units as 16 bit integers
+ * 			and the orientation as a 48 bit smallest-three quaternion.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ */
+struct Trajectory
+{
+	FILE *file;
+	bool writing;
+	float stepTime;						/* nominal time between frames */
+
+	int numBodies;
+	Vector3 dimensions[MAX_OBJECTS];
+	ShapeType shapes[MAX_OBJECTS];
+	Vector3 positions[MAX_OBJECTS];		/* positions as decoded - deltas are relative to these */
+
+	int frame;							/* next frame to read or write */
+	int numFrames;
+	int sinceKeyframe;
+
+	long *keyframeOffsets;				/* file offset of each keyframe, for seeking */
+	int *keyframeFrames;				/* frame number of each keyframe */
+	int numKeyframes;
+	int maxKeyframes;
+};
+typedef struct Trajectory Trajectory;
+
+/**
+ * @brief	Creates a trajectory file for recording.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	trajectory	The trajectory.
+ * @param 	filename  	The file to write.
+ * @param	stepTime  	The time between recorded frames.
+ * @return	true if it succeeds, false if it fails.
+ */
+bool TrajectoryCreate(Trajectory *trajectory, char *filename, float stepTime);
+
+/**
+ * @brief	Appends the current state of a scene to a trajectory.
+ * @details	A keyframe is written every TRAJECTORY_KEYFRAME_INTERVAL frames, and whenever the
+ * 			number of bodies changes or a body moves too far to encode as a delta.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	trajectory	The trajectory.
+ * @param 	scene	  	The scene.
+ * @return	true if it succeeds, false if it fails.
+ */
+bool TrajectoryRecord(Trajectory *trajectory, Scene *scene);
+
+/**
+ * @brief	Opens a trajectory file for playback.
+ * @details	Builds the keyframe index by scanning the record headers.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	trajectory	The trajectory.
+ * @param 	filename  	The file to read.
+ * @return	true if it succeeds, false if the file is missing or invalid.
+ */
+bool TrajectoryOpen(Trajectory *trajectory, char *filename);
+
+/**
+ * @brief	Moves playback to a frame.
+ * @details	Decodes forward from the nearest keyframe at or before the frame.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	trajectory	The trajectory.
+ * @param	frame	  	The frame number.
+ * @return	true if it succeeds, false if the frame is out of range.
+ */
+bool TrajectorySeek(Trajectory *trajectory, int frame);
+
+/**
+ * @brief	Reads the next frame into a scene.
+ * @details	Sets the number of objects and their dimensions, positions, orientations and vertices.
+ * 			Only suitable for rendering - velocities are not recorded.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	trajectory	The trajectory.
+ * @param 	scene	  	The scene.
+ * @return	true if it succeeds, false at the end of the file.
+ */
+bool TrajectoryPlay(Trajectory *trajectory, Scene *scene);
+
+/**
+ * @brief	Closes a trajectory file.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	trajectory	The trajectory.
+ */
+void TrajectoryClose(Trajectory *trajectory);
+
+/**
+ * @brief	Packs an orientation into 6 bytes.
+ * @details	Used internally by the recorder. Stores the index of the largest quaternion component
+ * 			and the other three in 15 bits each.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param	orientation	The orientation.
+ * @param 	data	   	The 6 byte output.
+ */
+void TrajectoryPackOrientation(Matrix3x3 orientation, unsigned char *data);
+
+/**
+ * @brief	Unpacks an orientation packed by TrajectoryPackOrientation.
+ * @details	Used internally by playback.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	data	The 6 byte input.
+ * @return	The orientation.
+ */
+Matrix3x3 TrajectoryUnpackOrientation(unsigned char *data);
+
+#endif
@@ -1,64 +1,484 @@
-
-#include <stdio.h>
-#include "Graphics.h"
-#include "Scene.h"
-#include "KeyInput.h"
-#include <time.h>
-#include "MathUtils.h"
-
-void Update();
-float GetTime();
-float GetDeltaTime();
-
-Scene scene;
-float lastTime;
-
-int main(int argc, char **argv)
-{
-	/* set display properties */
-	DisplayProperties.FPS = 200;
-	DisplayProperties.windowCaption = "Dice Roll Physics Simulation";
-	DisplayProperties.windowWidth = 600;
-	DisplayProperties.windowHeight = 400;
-	DisplayProperties.fullscreen = false;
-	DisplayProperties.fov = 60;
-	DisplayProperties.zNear = 0.1f;
-	DisplayProperties.zFar = 1000.0f;
-	DisplayProperties.clearColour = ColourNew(100.0f/255, 149.0f/255, 237.0f/255, 1);
-	GraphicsInit(argv[0]);
-
-	/* intialization */
-	KeyInputInit();
-	InitRandomGeneration();
-	SceneInit(&scene);
-
-	lastTime = GetTime();
-
-	/* start simulation loop */
-	GraphicsStartLoop(Update);
-	return 0;
-}
-
-void Update()
-{
-	if (KeyDown(KEY_ESC))
-		ExitProgram();
-
-	SceneUpdate(&scene, GetDeltaTime());
-	RenderScene(&scene);
-}
-
-float GetTime()
-{
-	/* return current time */
-	return ((float)(clock())) / ((float)CLOCKS_PER_SEC);
-}
-
-float GetDeltaTime()
-{
-	/* return time since last call */
-	float time = GetTime();
-	float deltaTime = time - lastTime;
-	lastTime = time;
-	return deltaTime;
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Graphics.h"
+#include "Demo.h"
+#include "KeyInput.h"
+#include "InputScript.h"
+#include <time.h>
+#include "MathUtils.h"
+#include "Trajectory.h"
+#include "RollCache.h"
+#include "StaticMesh.h"
+#include "Scenario.h"
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h> 
+#else
+#include <GL/gl.h> 
+#endif
+
+void Update();
+void StepScene(float deltaTime);
+void ProcessInput();
+float GetDeltaTime();
+double GetWallTime();
+void LogStartupTime();
+int CaptureFrames(char *path, unsigned seed, int firstFrame, int numFrames, char *outputPrefix);
+void HashTrajectory(unsigned seed, int numFrames);
+int RunRolls(char *queryFile, char *cacheFile);
+int RunScenario(char *filename);
+bool CreateEnvironment(char *name);
+
+Demo demo;
+double lastTime;
+double startTime;
+bool logStartupTime = false;
+
+Trajectory trajectory;
+bool recording = false;
+bool playing = false;
+
+StaticMesh environment;
+bool hasEnvironment = false;
+ShapeType startShape = SHAPE_BOX;	/* shape of the objects dropped at the start */
+
+InputQueue keyQueue;		/* filled by the glut keyboard callbacks */
+InputQueue scriptQueue;		/* filled from inputScript */
+InputScript inputScript;
+InputScript inputRecord;
+bool inputPlaying = false;
+bool inputRecording = false;
+int inputFrame = 0;			/* frames of input processed */
+
+int main(int argc, char **argv)
+{
+	char *captureArgs[4] = { NULL };
+	char *hashArgs[2] = { NULL };
+	char *recordFile = NULL, *playFile = NULL;
+	char *rollFile = NULL, *rollCacheFile = NULL;
+	char *inputFile = NULL, *inputRecordFile = NULL;
+	char *scenarioFile = NULL;
+	int i;
+
+	startTime = GetWallTime();
+
+	/* set display properties */
+	DisplayProperties.FPS = 200;
+	DisplayProperties.windowCaption = "Dice Roll Physics Simulation";
+	DisplayProperties.windowWidth = 600;
+	DisplayProperties.windowHeight = 400;
+	DisplayProperties.fullscreen = false;
+	DisplayProperties.fov = 60;
+	DisplayProperties.zNear = 0.1f;
+	DisplayProperties.zFar = 1000.0f;
+	DisplayProperties.clearColour = ColourNew(100.0f/255, 149.0f/255, 237.0f/255, 1);
+
+	for (i = 1; i < argc; i++)
+	{
+		/* report time from process start to first rendered frame */
+		if (strcmp(argv[i], "--startup-time") == 0)
+			logStartupTime = true;
+
+		/* print frame timing, GPU time of each render pass and draw calls */
+		else if (strcmp(argv[i], "--frame-stats") == 0)
+			DisplayProperties.logFrameStats = true;
+
+		/* record motion of every frame: --record <file> */
+		else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+			recordFile = argv[++i];
+
+		/* replay a recording instead of simulating: --play <file> */
+		else if (strcmp(argv[i], "--play") == 0 && i + 1 < argc)
+			playFile = argv[++i];
+
+		/* drive the scene from an input script: --input <file> */
+		else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc)
+			inputFile = argv[++i];
+
+		/* write the actions of each frame to an input script: --record-input <file> */
+		else if (strcmp(argv[i], "--record-input") == 0 && i + 1 < argc)
+			inputRecordFile = argv[++i];
+
+		/* headless capture: diceroll --capture <seed> <first frame> <num frames> <output prefix> */
+		else if (strcmp(argv[i], "--capture") == 0 && i + 4 < argc)
+		{
+			memcpy(captureArgs, &argv[i+1], sizeof(captureArgs));
+			i += 4;
+		}
+
+		/* simulate without graphics and print a hash of every frame: --hash <seed> <num frames> */
+		else if (strcmp(argv[i], "--hash") == 0 && i + 2 < argc)
+		{
+			memcpy(hashArgs, &argv[i+1], sizeof(hashArgs));
+			i += 2;
+		}
+
+		/* answer roll queries without graphics: --rolls <query file> */
+		else if (strcmp(argv[i], "--rolls") == 0 && i + 1 < argc)
+			rollFile = argv[++i];
+
+		/* run a scenario without graphics and report timing and settle statistics: --scenario <file> */
+		else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc)
+			scenarioFile = argv[++i];
+
+		/* keep roll results between runs: --roll-cache <file> */
+		else if (strcmp(argv[i], "--roll-cache") == 0 && i + 1 < argc)
+			rollCacheFile = argv[++i];
+
+		/* drop dice of another shape at the start: --shape 4|6|8|10|12|20 */
+		else if (strcmp(argv[i], "--shape") == 0 && i + 1 < argc)
+		{
+			if (!ShapeFromSides(atoi(argv[++i]), &startShape))
+			{
+				fprintf(stderr, "No die has %s sides\n", argv[i]);
+				return 1;
+			}
+		}
+
+		/* roll into static geometry: --environment tray|terrain */
+		else if (strcmp(argv[i], "--environment") == 0 && i + 1 < argc)
+		{
+			if (!CreateEnvironment(argv[++i]))
+			{
+				fprintf(stderr, "Failed to create environment %s\n", argv[i]);
+				return 1;
+			}
+		}
+	}
+
+	if (rollFile != NULL)
+		return RunRolls(rollFile, rollCacheFile);
+
+	if (scenarioFile != NULL)
+		return RunScenario(scenarioFile);
+
+	InputQueueInit(&keyQueue);
+	InputQueueInit(&scriptQueue);
+	if (inputFile != NULL)
+	{
+		inputPlaying = InputScriptOpen(&inputScript, inputFile);
+		if (!inputPlaying)
+		{
+			fprintf(stderr, "Failed to open %s\n", inputFile);
+			return 1;
+		}
+	}
+	if (inputRecordFile != NULL)
+	{
+		inputRecording = InputScriptCreate(&inputRecord, inputRecordFile);
+		if (!inputRecording)
+			fprintf(stderr, "Failed to create %s\n", inputRecordFile);
+	}
+
+	if (hashArgs[0] != NULL)
+	{
+		HashTrajectory((unsigned)strtoul(hashArgs[0], NULL, 10), atoi(hashArgs[1]));
+		InputScriptClose(&inputScript);
+		InputScriptClose(&inputRecord);
+		return 0;
+	}
+
+	if (recordFile != NULL)
+	{
+		recording = TrajectoryCreate(&trajectory, recordFile, 1.0f / DisplayProperties.FPS);
+		if (!recording)
+			fprintf(stderr, "Failed to create %s\n", recordFile);
+	}
+	else if (playFile != NULL)
+	{
+		playing = TrajectoryOpen(&trajectory, playFile);
+		if (!playing)
+		{
+			fprintf(stderr, "Failed to open %s\n", playFile);
+			return 1;
+		}
+	}
+
+	if (captureArgs[0] != NULL)
+	{
+		i = CaptureFrames(argv[0], (unsigned)strtoul(captureArgs[0], NULL, 10), atoi(captureArgs[1]), atoi(captureArgs[2]), captureArgs[3]);
+		TrajectoryClose(&trajectory);
+		InputScriptClose(&inputScript);
+		InputScriptClose(&inputRecord);
+		return i;
+	}
+
+	GraphicsInit(argv[0]);
+
+	/* intialization */
+	KeyInputInit(&keyQueue);
+	DemoInit(&demo, (unsigned)time(NULL), startShape);
+	demo.scene.staticMesh = hasEnvironment ? &environment : NULL;
+
+	lastTime = GetWallTime();
+
+	/* start simulation loop */
+	GraphicsStartLoop(Update);
+	return 0;
+}
+
+void Update()
+{
+	StepScene(GetDeltaTime());
+
+	if (ActionPresses(&demo.input, ACTION_QUIT) > 0)
+	{
+		TrajectoryClose(&trajectory);
+		InputScriptClose(&inputScript);
+		InputScriptClose(&inputRecord);
+		ExitProgram();
+	}
+
+	RenderScene(&demo);
+	LogStartupTime();
+}
+
+void StepScene(float deltaTime)
+{
+	ProcessInput();
+
+	if (playing)
+	{
+		/* loop the recording */
+		if (!TrajectoryPlay(&trajectory, &demo.scene))
+		{
+			TrajectorySeek(&trajectory, 0);
+			TrajectoryPlay(&trajectory, &demo.scene);
+		}
+		CameraUpdate(&demo.camera, &demo.input, deltaTime);
+		return;
+	}
+
+	DemoUpdate(&demo, deltaTime);
+
+	if (recording)
+		TrajectoryRecord(&trajectory, &demo.scene);
+}
+
+void ProcessInput()
+{
+	InputEvent event;
+
+	/* script events are due on the frame they were recorded on, so runs repeat exactly */
+	if (inputPlaying)
+		InputScriptPlay(&inputScript, inputFrame, &scriptQueue);
+
+	InputStateBeginFrame(&demo.input);
+	while (InputQueuePop(&scriptQueue, &event) || InputQueuePop(&keyQueue, &event))
+	{
+		InputStateApply(&demo.input, event);
+		if (inputRecording)
+			InputScriptRecord(&inputRecord, inputFrame, event);
+	}
+
+	inputFrame++;
+}
+
+int CaptureFrames(char *path, unsigned seed, int firstFrame, int numFrames, char *outputPrefix)
+{
+	char filename[1024];
+	float deltaTime = 1.0f / DisplayProperties.FPS;
+	double frameStart;
+	int frame;
+
+	if (!GraphicsInitOffscreen(path))
+	{
+		fprintf(stderr, "Failed to create offscreen rendering context\n");
+		return 1;
+	}
+
+	/* same seed and fixed time step give the same frames every run */
+	DemoInit(&demo, seed, startShape);
+	demo.scene.staticMesh = hasEnvironment ? &environment : NULL;
+
+	/* advance to the first requested frame without rendering */
+	if (playing)
+		TrajectorySeek(&trajectory, firstFrame);
+	else
+		for (frame = 0; frame < firstFrame; frame++)
+			StepScene(deltaTime);
+
+	for (frame = firstFrame; frame < firstFrame + numFrames; frame++)
+	{
+		frameStart = GetWallTime();
+		StepScene(deltaTime);
+		RenderScene(&demo);
+		LogStartupTime();
+
+		/* GPU times are from an earlier frame - the queries are read back a few frames late */
+		if (DisplayProperties.logFrameStats)
+			fprintf(stderr, "frame %d: cpu %.2f ms, gpu floor %.3f shadows %.3f objects %.3f ms, %d draw calls, %d state changes\n",
+				frame, GetWallTime() - frameStart, RenderStats.gpuTime[PASS_FLOOR], RenderStats.gpuTime[PASS_SHADOWS], RenderStats.gpuTime[PASS_OBJECTS],
+				RenderStats.drawCalls, RenderStats.stateChanges);
+
+		sprintf(filename, "%.1000s%05d.tga", outputPrefix, frame);
+		if (!GraphicsCaptureFrame(filename))
+		{
+			fprintf(stderr, "Failed to write %s\n", filename);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+void HashTrajectory(unsigned seed, int numFrames)
+{
+	SceneState state;
+	unsigned long long hash = SCENE_HASH_SEED;
+	float deltaTime = 1.0f / DisplayProperties.FPS;
+	int frame;
+
+	DemoInit(&demo, seed, startShape);
+	demo.scene.staticMesh = hasEnvironment ? &environment : NULL;
+
+	for (frame = 0; frame < numFrames; frame++)
+	{
+		ProcessInput();
+		DemoUpdate(&demo, deltaTime);
+		SceneSaveState(&demo.scene, &state);
+		hash = SceneStateHash(&state, hash);
+	}
+
+	printf("%016llx\n", hash);
+}
+
+int RunRolls(char *queryFile, char *cacheFile)
+{
+	RollCache cache;
+	RollParams params;
+	RollResult result;
+	ShapeType shape;
+	unsigned seed;
+	float w, h, d, density, x, y, z;
+	Vector3 velocity, spin;
+	int sides, fields;
+	char line[256];
+	FILE *file;
+
+	/* one roll per line: seed width height depth density x y z [sides [vx vy vz [spin x y z]]] */
+	file = fopen(queryFile, "r");
+	if (!file)
+	{
+		fprintf(stderr, "Failed to open %s\n", queryFile);
+		return 1;
+	}
+
+	if (!RollCacheCreate(&cache, 65536, cacheFile))
+	{
+		fprintf(stderr, "Failed to create roll cache %s\n", cacheFile);
+		fclose(file);
+		return 1;
+	}
+
+	while (fgets(line, sizeof(line), file))
+	{
+		sides = 6;
+		velocity = spin = Vec3New(0, 0, 0);
+		fields = sscanf(line, "%u %f %f %f %f %f %f %f %d %f %f %f %f %f %f", &seed, &w, &h, &d, &density, &x, &y, &z, &sides,
+			&velocity.x, &velocity.y, &velocity.z, &spin.x, &spin.y, &spin.z);
+		if (fields < 8 || !ShapeFromSides(sides, &shape))
+			continue;
+
+		RollParamsInit(&params, seed, shape, Vec3New(w, h, d), density, Vec3New(x, y, z), velocity, spin);
+		RollCacheRoll(&cache, &params, &result);
+		printf("%u %d %.3f\n", seed, result.face, result.settleTime);
+	}
+
+	fprintf(stderr, "%lu hits, %lu misses (%.1f%% hit rate), %lu inserts, %lu evictions\n", cache.hits, cache.misses,
+		cache.hits + cache.misses > 0 ? 100.0 * cache.hits / (cache.hits + cache.misses) : 0.0, cache.inserts, cache.evictions);
+
+	RollCacheClose(&cache);
+	fclose(file);
+	return 0;
+}
+
+int RunScenario(char *filename)
+{
+	Scenario scenario;
+	ScenarioStats stats;
+	double simulated;
+
+	if (!ScenarioRead(&scenario, filename))
+	{
+		fprintf(stderr, "Failed to read scenario %s\n", filename);
+		return 1;
+	}
+
+	SceneInit(&demo.scene, 0);
+	demo.scene.staticMesh = hasEnvironment ? &environment : NULL;
+	if (!ScenarioRun(&scenario, &demo.scene, &stats))
+	{
+		fprintf(stderr, "Failed to run scenario %s\n", filename);
+		return 1;
+	}
+
+	simulated = stats.steps * (double)scenario.timeStep;
+	printf("steps: %d (%.1f s simulated)\n", stats.steps, simulated);
+	printf("wall time: %.1f ms (%.1fx real time)\n", stats.wallTime, stats.wallTime > 0 ? simulated * 1000 / stats.wallTime : 0.0);
+	printf("step time: mean %.4f ms, p99 %.4f ms, max %.4f ms\n", stats.meanStepTime, stats.p99StepTime, stats.maxStepTime);
+	printf("throughput: %.0f steps/s, %.0f body steps/s\n", stats.wallTime > 0 ? stats.steps * 1000 / stats.wallTime : 0.0,
+		stats.wallTime > 0 ? stats.bodySteps * 1000 / stats.wallTime : 0.0);
+	printf("bodies: %d spawned, %d settled, %d replaced while moving, %d moving at end, %d escaped\n",
+		stats.spawned, stats.settled, stats.replaced, stats.moving, stats.escaped);
+	printf("settle time: mean %.3f s, median %.3f s, p95 %.3f s, max %.3f s\n",
+		stats.meanSettleTime, stats.medianSettleTime, stats.p95SettleTime, stats.maxSettleTime);
+	printf("contacts: %.2f pairs tested, %.2f contacts, %.2f warm started per step\n", (double)stats.pairsTested / stats.steps,
+		(double)stats.contacts / stats.steps, (double)stats.warmStarted / stats.steps);
+
+	/* the figures above are not for the load the scenario describes if bodies were cut short */
+	if (stats.replaced > 0)
+		fprintf(stderr, "WARNING: %d bodies were replaced while still moving, as only %d are simulated at once\n", stats.replaced, MAX_OBJECTS);
+
+	/* bodies falling out of the world is a failure worth a nonzero exit in soak runs */
+	return stats.escaped > 0 ? 2 : 0;
+}
+
+bool CreateEnvironment(char *name)
+{
+	float heights[64 * 64];
+	int x, z;
+
+	/* walls of a dice tray around where dice are dropped */
+	if (strcmp(name, "tray") == 0)
+		hasEnvironment = StaticMeshCreateTray(&environment, 6, 5, 3);
+
+	/* rolling hills, 16 units across */
+	else if (strcmp(name, "terrain") == 0)
+	{
+		for (z = 0; z < 64; z++)
+			for (x = 0; x < 64; x++)
+				heights[z * 64 + x] = 0.4f + 0.4f * Sin(x * 0.35f) * Cos(z * 0.3f);
+		hasEnvironment = StaticMeshCreateHeightfield(&environment, heights, 64, 64, 0.25f, Vec3New(-8, 0, -8));
+	}
+
+	return hasEnvironment;
+}
+
+void LogStartupTime()
+{
+	if (logStartupTime)
+	{
+		glFinish();
+		printf("First frame rendered %.1f ms after start\n", GetWallTime() - startTime);
+		logStartupTime = false;
+	}
+}
+
+double GetWallTime()
+{
+	/* return milliseconds from an arbitrary fixed point */
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+float GetDeltaTime()
+{
+	/* return seconds since last call - wall time, as frames are paced by it */
+	double time = GetWallTime();
+	float deltaTime = (float)((time - lastTime) / 1000);
+	lastTime = time;
+	return deltaTime;
+}
@@ -0,0 +1,154 @@
+
+#include "../Physics.h"
+#include "../MathUtils.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_STEPS 400
+#define MAX_THREADS 64
+
+void *Worker(void *arg);
+unsigned long long RunWorld(int index);
+unsigned long long HashBody(PhysicsWorld *world, PhysicsBody body, unsigned long long hash);
+
+/* a ramp across the middle of the floor, shared read only by every world that copies it */
+static const float rampVertices[] = { -3, 0, -3,  -3, 0, 3,  3, 1, 3,  3, 1, -3 };
+static const int rampIndices[] = { 0, 1, 2,  0, 2, 3 };
+
+/* the pool's work - each world is run by whichever thread takes its index */
+static int numWorlds;
+static atomic_int nextWorld;
+static unsigned long long *hashes;
+
+/* Steps many worlds at once from a thread pool, and checks each ends as it does on its own:
+ *     ./concurrentscenes [worlds [threads]]
+ * Defaults to 200 worlds on 8 threads. Every world is run once on this thread, then all of them
+ * again from the pool. Worlds differ in gravity, solver iterations, shapes and whether they
+ * have a ramp, and some remove a body part way through. Built with -fsanitize=thread by
+ * 'make tsan', so any state shared between worlds is reported as a race.
+ */
+int main(int argc, char **argv)
+{
+	pthread_t threads[MAX_THREADS];
+	unsigned long long *serial;
+	int numThreads = argc > 2 ? atoi(argv[2]) : 8;
+	int i, failed = 0;
+
+	numWorlds = argc > 1 ? atoi(argv[1]) : 200;
+	if (numWorlds < 1 || numThreads < 1 || numThreads > MAX_THREADS)
+	{
+		fprintf(stderr, "Usage: %s [worlds [threads, at most %d]]\n", argv[0], MAX_THREADS);
+		return 1;
+	}
+
+	serial = (unsigned long long*)malloc(numWorlds * sizeof(unsigned long long));
+	hashes = (unsigned long long*)malloc(numWorlds * sizeof(unsigned long long));
+	if (!serial || !hashes)
+		return 1;
+
+	for (i = 0; i < numWorlds; i++)
+		serial[i] = RunWorld(i);
+
+	atomic_init(&nextWorld, 0);
+	for (i = 0; i < numThreads; i++)
+	{
+		if (pthread_create(&threads[i], NULL, Worker, NULL) != 0)
+		{
+			fprintf(stderr, "Cannot start thread %d\n", i);
+			return 1;
+		}
+	}
+	for (i = 0; i < numThreads; i++)
+		pthread_join(threads[i], NULL);
+
+	for (i = 0; i < numWorlds; i++)
+	{
+		if (hashes[i] != serial[i])
+		{
+			printf("FAILED world %d: %016llx on the pool, %016llx on its own\n", i, hashes[i], serial[i]);
+			failed++;
+		}
+	}
+
+	printf("%d worlds on %d threads, %d differ from the serial run\n", numWorlds, numThreads, failed);
+	free(serial);
+	free(hashes);
+	return failed > 0;
+}
+
+/* Runs worlds until there are none left. */
+void *Worker(void *arg)
+{
+	int i;
+
+	while ((i = atomic_fetch_add(&nextWorld, 1)) < numWorlds)
+		hashes[i] = RunWorld(i);
+
+	return NULL;
+}
+
+/* Creates, steps and destroys a world, returning a hash of its bodies after each step. */
+unsigned long long RunWorld(int index)
+{
+	static const int sides[] = { 4, 6, 8, 10, 12, 20 };
+	PhysicsWorld *world = PhysicsCreate();
+	PhysicsBody bodies[4];
+	PhysicsBodyDesc desc;
+	PhysicsParams params;
+	unsigned long long hash = 14695981039346656037ULL;
+	Random random;
+	int i, j;
+
+	if (world == NULL)
+		return 0;
+
+	PhysicsGetParams(world, &params);
+	params.gravity = 10 + index % 20;
+	params.solverIterations = 1 + index % 3;
+	PhysicsSetParams(world, &params);
+	if (index % 2 == 1)
+		PhysicsSetMesh(world, rampVertices, 4, rampIndices, 2);
+
+	InitRandomGenerationSeed(&random, index + 1);
+	for (i = 0; i < 4; i++)
+	{
+		PhysicsBodyDescInit(&desc, sides[(index + i) % 6], GetRandomFloat(&random, 0.5f, 1), 3);
+		desc.position[0] = GetRandomFloat(&random, -1, 1);
+		desc.position[1] = GetRandomFloat(&random, 2, 5);
+		desc.position[2] = GetRandomFloat(&random, -1, 1);
+		desc.velocity[0] = GetRandomFloat(&random, -2, 2);
+		desc.spin[2] = GetRandomFloat(&random, -10, 10);
+		bodies[i] = PhysicsAddBody(world, &desc);
+	}
+
+	for (i = 0; i < NUM_STEPS; i++)
+	{
+		if (index % 3 == 0 && i == NUM_STEPS / 2)
+			PhysicsRemoveBody(world, bodies[index % 4]);
+
+		PhysicsStep(world, 0.005f);
+		for (j = 0; j < 4; j++)
+			hash = HashBody(world, bodies[j], hash);
+	}
+
+	PhysicsDestroy(world);
+	return hash;
+}
+
+/* Adds a body's state to a 64 bit FNV-1a hash, or nothing if it has been removed. */
+unsigned long long HashBody(PhysicsWorld *world, PhysicsBody body, unsigned long long hash)
+{
+	PhysicsBodyState state;
+	unsigned char *data = (unsigned char*)&state;
+	size_t i;
+
+	if (!PhysicsGetBody(world, body, &state))
+		return hash;
+
+	for (i = 0; i < sizeof(state); i++)
+		hash = (hash ^ data[i]) * 1099511628211ULL;
+
+	return hash;
+}
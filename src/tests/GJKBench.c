@@ -0,0 +1,98 @@
+
+#include "../Scene.h"
+#include "../GJK.h"
+#include "../MathUtils.h"
+#include "TestScene.h"
+#include "Timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_BODIES 8
+#define REPEATS 10
+
+/* pairs further apart than this are rejected by their bounds before GJK in the scene */
+#define PAIR_MARGIN 0.5f
+
+/* Compares GJK queries with and without warm starting from the pair cache:
+ *     ./gjkbench [steps]
+ * For each shape, 8 dice are dropped and simulated for 2000 steps. After every step each pair
+ * close enough to be tested is queried from scratch (cold) and from the simplex kept from its
+ * last query (warm), several times each for timing. Resting and slowly moving pairs should
+ * mostly exit after one warm iteration.
+ */
+int main(int argc, char **argv)
+{
+	const int sides[NUM_SHAPES] = { 6, 4, 8, 10, 12, 20 };
+	int numSteps = argc > 1 ? atoi(argv[1]) : 2000;
+	static Scene scene;
+	static GJKCache caches[NUM_BODIES][NUM_BODIES];
+	GJKCache cache;
+	GJKResult result;
+	long long coldIterations, warmIterations, numQueries, oneIteration;
+	double coldTime, warmTime, start;
+	int shape, step, i, j, k;
+	Random random;
+
+	if (numSteps < 1)
+	{
+		fprintf(stderr, "Usage: %s [steps]\n", argv[0]);
+		return 1;
+	}
+
+	InitRandomGenerationSeed(&random, 1);
+	printf("shape  queries  cold its  warm its  warm 1 it  cold ns  warm ns\n");
+
+	for (shape = 0; shape < NUM_SHAPES; shape++)
+	{
+		SceneInit(&scene, 1);
+		TestSceneDrop(&scene, (ShapeType)shape, NUM_BODIES, &random);
+		for (i = 0; i < NUM_BODIES; i++)
+			for (j = 0; j < NUM_BODIES; j++)
+				GJKCacheReset(&caches[i][j]);
+
+		coldIterations = warmIterations = numQueries = oneIteration = 0;
+		coldTime = warmTime = 0;
+
+		for (step = 0; step < numSteps; step++)
+		{
+			SceneUpdate(&scene, 1.0f / 200);
+
+			for (i = 0; i < scene.numObjects; i++)
+			{
+				for (j = i + 1; j < scene.numObjects; j++)
+				{
+					if (!RBBoundsOverlap(&scene.objects[i], &scene.objects[j], PAIR_MARGIN))
+						continue;
+
+					start = TimingNow();
+					for (k = 0; k < REPEATS; k++)
+						GJKQuery(&scene.objects[i], &scene.objects[j], NULL, &result);
+					coldTime += TimingNow() - start;
+					coldIterations += result.iterations;
+
+					/* each repeat starts from the same cache, as a single query in the scene would */
+					start = TimingNow();
+					for (k = 0; k < REPEATS; k++)
+					{
+						cache = caches[i][j];
+						GJKQuery(&scene.objects[i], &scene.objects[j], &cache, &result);
+					}
+					warmTime += TimingNow() - start;
+					caches[i][j] = cache;
+					warmIterations += result.iterations;
+					oneIteration += result.iterations == 1;
+
+					numQueries++;
+				}
+			}
+		}
+
+		if (numQueries == 0)
+			numQueries = 1;
+		printf("d%-4d  %7lld  %8.2f  %8.2f  %8.1f%%  %7.0f  %7.0f\n", sides[shape], numQueries,
+			(double)coldIterations / numQueries, (double)warmIterations / numQueries, 100.0 * oneIteration / numQueries,
+			coldTime * 1e6 / (numQueries * REPEATS), warmTime * 1e6 / (numQueries * REPEATS));
+	}
+
+	return 0;
+}
@@ -0,0 +1,125 @@
+
+#include "../StaticMesh.h"
+#include "../MathUtils.h"
+#include "Timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define NUM_QUERIES 20000
+#define MAX_FOUND 4096
+#define SPACING 0.25f
+
+double TimeQueries(StaticMesh *mesh, Vector3 *mins, Vector3 *maxs, int numQueries, long *found);
+double TimeScan(StaticMesh *mesh, Vector3 *mins, Vector3 *maxs, int numQueries, long *found);
+bool TriangleOverlaps(StaticTriangle *triangle, Vector3 min, Vector3 max);
+
+/* Times static mesh queries against a scan of every triangle:
+ *     ./meshbench [largest grid]
+ * Heightfields of rolling ground from 16x16 points up to the largest grid (default 1024x1024)
+ * are built, then queried with die sized boxes resting on them, as each body's contacts query
+ * the mesh every step. The scan counts the triangles whose bounds overlap each box, which the
+ * query must match.
+ */
+int main(int argc, char **argv)
+{
+	int largest = argc > 1 ? atoi(argv[1]) : 1024;
+	static Vector3 mins[NUM_QUERIES], maxs[NUM_QUERIES];
+	double start, build, query, scan;
+	long found, scanned;
+	float extent, x, z, *heights;
+	int size, numScans, i, j;
+	StaticMesh mesh;
+	Random random;
+
+	if (largest < 16)
+	{
+		fprintf(stderr, "Usage: %s [largest grid, at least 16]\n", argv[0]);
+		return 1;
+	}
+
+	InitRandomGenerationSeed(&random, 1);
+	printf("grid       triangles    nodes  build ms  query ns  found  scan ns\n");
+
+	for (size = 16; size <= largest; size *= 2)
+	{
+		extent = (size - 1) * SPACING / 2;
+		heights = (float*)malloc((size_t)size * size * sizeof(float));
+		for (i = 0; i < size; i++)
+			for (j = 0; j < size; j++)
+				heights[i * size + j] = 0.4f + 0.4f * Sin(j * 0.35f) * Cos(i * 0.3f);
+
+		start = TimingNow();
+		if (!StaticMeshCreateHeightfield(&mesh, heights, size, size, SPACING, Vec3New(-extent, 0, -extent)))
+		{
+			fprintf(stderr, "Cannot build a %dx%d heightfield\n", size, size);
+			return 1;
+		}
+		build = TimingNow() - start;
+		free(heights);
+
+		for (i = 0; i < NUM_QUERIES; i++)
+		{
+			x = GetRandomFloat(&random, -extent + 1, extent - 1);
+			z = GetRandomFloat(&random, -extent + 1, extent - 1);
+			mins[i] = Vec3New(x - 0.5f, 0, z - 0.5f);
+			maxs[i] = Vec3New(x + 0.5f, 1, z + 0.5f);
+		}
+
+		/* the scan is slow on large meshes, so it covers fewer boxes */
+		numScans = mesh.numTriangles > 100000 ? 100 : 2000;
+		query = TimeQueries(&mesh, mins, maxs, numScans, &found);
+		scan = TimeScan(&mesh, mins, maxs, numScans, &scanned);
+		if (found != scanned)
+		{
+			fprintf(stderr, "%dx%d: the query found %ld triangles, the scan %ld\n", size, size, found, scanned);
+			return 1;
+		}
+
+		query = TimeQueries(&mesh, mins, maxs, NUM_QUERIES, &found);
+		printf("%4dx%-4d  %9d  %7d  %8.1f  %8.0f  %5.1f  %7.0f\n", size, size, mesh.numTriangles, mesh.numNodes,
+			build, query * 1e6 / NUM_QUERIES, (double)found / NUM_QUERIES, scan * 1e6 / numScans);
+
+		StaticMeshDestroy(&mesh);
+	}
+
+	return 0;
+}
+
+/* Gets the time in milliseconds to query the mesh with each box, and the triangles found. */
+double TimeQueries(StaticMesh *mesh, Vector3 *mins, Vector3 *maxs, int numQueries, long *found)
+{
+	static int triangles[MAX_FOUND];
+	double start = TimingNow();
+	int i;
+
+	*found = 0;
+	for (i = 0; i < numQueries; i++)
+		*found += StaticMeshQuery(mesh, mins[i], maxs[i], triangles, MAX_FOUND);
+
+	return TimingNow() - start;
+}
+
+/* Gets the time in milliseconds to test every triangle against each box, and the triangles found. */
+double TimeScan(StaticMesh *mesh, Vector3 *mins, Vector3 *maxs, int numQueries, long *found)
+{
+	double start = TimingNow();
+	int i, j;
+
+	*found = 0;
+	for (i = 0; i < numQueries; i++)
+		for (j = 0; j < mesh->numTriangles; j++)
+			*found += TriangleOverlaps(&mesh->triangles[j], mins[i], maxs[i]);
+
+	return TimingNow() - start;
+}
+
+/* true if a triangle's bounds overlap a box. */
+bool TriangleOverlaps(StaticTriangle *triangle, Vector3 min, Vector3 max)
+{
+	Vector3 *v = triangle->vertices;
+
+	return fminf(v[0].x, fminf(v[1].x, v[2].x)) <= max.x && fmaxf(v[0].x, fmaxf(v[1].x, v[2].x)) >= min.x &&
+		fminf(v[0].y, fminf(v[1].y, v[2].y)) <= max.y && fmaxf(v[0].y, fmaxf(v[1].y, v[2].y)) >= min.y &&
+		fminf(v[0].z, fminf(v[1].z, v[2].z)) <= max.z && fmaxf(v[0].z, fmaxf(v[1].z, v[2].z)) >= min.z;
+}
@@ -0,0 +1,129 @@
+
+#include "../RollCache.h"
+#include <stdio.h>
+#include <string.h>
+
+void MakeParams(RollParams *params, unsigned seed);
+bool Hits(RollCache *cache, RollParams *params, int face);
+bool Missing(RollCache *cache, RollParams *params);
+void Check(bool passed, char *name);
+
+/* checks failed so far */
+static int failed = 0;
+
+/* Checks the roll cache:
+ *     ./rollcachetest <cache file>
+ * Hits and misses, that params are compared in full rather than by hash, least recently used
+ * eviction within a bucket, rolls simulated on a miss, and that a cache file is reused by a
+ * cache of the same capacity and version and cleared otherwise. Results are made up, except
+ * for the one simulated roll, so the checks don't depend on the simulation.
+ */
+int main(int argc, char **argv)
+{
+	RollParams params[ROLL_CACHE_WAYS + 1], other;
+	RollResult result, cached;
+	RollCache cache;
+	FILE *file;
+	int i;
+
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s <cache file>\n", argv[0]);
+		return 1;
+	}
+
+	for (i = 0; i <= ROLL_CACHE_WAYS; i++)
+		MakeParams(&params[i], i + 1);
+
+	/* a capacity of one bucket, so every roll shares it */
+	Check(RollCacheCreate(&cache, ROLL_CACHE_WAYS, NULL) && cache.numBuckets == 1, "in memory cache of one bucket");
+	Check(Missing(&cache, &params[0]), "miss in an empty cache");
+	for (i = 0; i < ROLL_CACHE_WAYS; i++)
+	{
+		result.face = i + 1;
+		result.settleTime = 1;
+		RollCacheInsert(&cache, &params[i], &result);
+	}
+	Check(Hits(&cache, &params[0], 1) && Hits(&cache, &params[ROLL_CACHE_WAYS - 1], ROLL_CACHE_WAYS), "hits after insert");
+
+	/* params differing only in their physics are a different roll */
+	other = params[0];
+	other.physics.body.bounceFactor *= 0.5f;
+	Check(Missing(&cache, &other), "miss for other physics");
+
+	/* an entry with the right hash but other params, as a hash collision would leave */
+	cache.entries[1].key = RollCacheHash(&other);
+	Check(Missing(&cache, &other), "miss on a hash match with other params");
+	cache.entries[1].key = RollCacheHash(&params[1]);
+
+	/* params[0] and the last were used since params[1] was inserted, so a fifth evicts params[1] */
+	Hits(&cache, &params[2], 3);
+	result.face = ROLL_CACHE_WAYS + 1;
+	RollCacheInsert(&cache, &params[ROLL_CACHE_WAYS], &result);
+	Check(cache.evictions == 1 && Missing(&cache, &params[1]), "least recently used entry evicted");
+	Check(Hits(&cache, &params[0], 1) && Hits(&cache, &params[2], 3) && Hits(&cache, &params[3], 4) &&
+		Hits(&cache, &params[ROLL_CACHE_WAYS], ROLL_CACHE_WAYS + 1), "other entries kept");
+
+	/* a real roll is simulated once, then cached */
+	RollCacheRoll(&cache, &params[1], &result);
+	RollCacheRoll(&cache, &params[1], &cached);
+	Check(cache.inserts == ROLL_CACHE_WAYS + 2 && result.face == cached.face && result.settleTime == cached.settleTime, "roll simulated on a miss, then hit");
+	RollCacheClose(&cache);
+
+	/* a file keeps its results for a cache of the same capacity */
+	remove(argv[1]);
+	Check(RollCacheCreate(&cache, ROLL_CACHE_WAYS, argv[1]) && Missing(&cache, &params[0]), "new cache file is empty");
+	result.face = 7;
+	RollCacheInsert(&cache, &params[0], &result);
+	RollCacheClose(&cache);
+	Check(RollCacheCreate(&cache, ROLL_CACHE_WAYS, argv[1]) && Hits(&cache, &params[0], 7), "hit after reopening the file");
+	RollCacheClose(&cache);
+
+	Check(RollCacheCreate(&cache, ROLL_CACHE_WAYS * 2, argv[1]) && Missing(&cache, &params[0]), "file of another capacity cleared");
+	RollCacheInsert(&cache, &params[0], &result);
+	RollCacheClose(&cache);
+
+	/* the version follows the magic in the header */
+	file = fopen(argv[1], "r+b");
+	i = ROLL_CACHE_VERSION - 1;
+	Check(file != NULL && fseek(file, 4, SEEK_SET) == 0 && fwrite(&i, sizeof(i), 1, file) == 1, "version rewritten");
+	if (file)
+		fclose(file);
+	Check(RollCacheCreate(&cache, ROLL_CACHE_WAYS * 2, argv[1]) && Missing(&cache, &params[0]), "file of another version cleared");
+	RollCacheClose(&cache);
+
+	Check(!RollCacheCreate(&cache, 0xFFFFFFFFu, NULL), "capacity too large to count refused");
+
+	remove(argv[1]);
+	return failed > 0;
+}
+
+/* Fills in the params of a drop, different for each seed. */
+void MakeParams(RollParams *params, unsigned seed)
+{
+	RollParamsInit(params, seed, SHAPE_BOX, Vec3New(1, 1, 1), 3, Vec3New(0, 2, 0), Vec3New(0, 0, 0), Vec3New(0, 0, 0));
+}
+
+/* true if the cache has a result for the params, with the given face. */
+bool Hits(RollCache *cache, RollParams *params, int face)
+{
+	RollResult result;
+
+	return RollCacheLookup(cache, params, &result) && result.face == face;
+}
+
+/* true if the cache has no result for the params. */
+bool Missing(RollCache *cache, RollParams *params)
+{
+	RollResult result;
+
+	return !RollCacheLookup(cache, params, &result);
+}
+
+/* Reports a check. */
+void Check(bool passed, char *name)
+{
+	printf("%s %s\n", passed ? "ok" : "FAILED", name);
+	if (!passed)
+		failed++;
+}
@@ -0,0 +1,137 @@
+
+#include "../Scene.h"
+#include "../MathUtils.h"
+#include "TestScene.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define NUM_BODIES 8
+#define FIRST_STEPS 150
+#define BRANCH_STEPS 400
+
+unsigned long long HashSteps(Scene *scene, int numSteps);
+bool ReadsCorrupt(SceneState *state, int corruption, char *filename);
+
+enum { NUM_CORRUPTIONS = 6 };
+
+/* Checks that a restored snapshot carries on exactly as the scene it was taken from:
+ *     ./scenebranch <snapshot file>
+ * For each shape, 8 dice are dropped and simulated for 150 steps, then a snapshot is taken and
+ * the scene goes on for 400 more. The snapshot is restored into a scene that was simulating
+ * something else, and read back from the file into another, and both must take the same 400
+ * steps, bit for bit. Then snapshots with a bad shape, size, density or contact are written,
+ * and reading any of them must fail.
+ */
+int main(int argc, char **argv)
+{
+	const int sides[NUM_SHAPES] = { 6, 4, 8, 10, 12, 20 };
+	static Scene scene, branch;
+	static SceneState state, read;
+	unsigned long long expected, restored, loaded;
+	int shape, i, failed = 0;
+	Random random;
+
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s <snapshot file>\n", argv[0]);
+		return 1;
+	}
+
+	InitRandomGenerationSeed(&random, 1);
+
+	for (shape = 0; shape < NUM_SHAPES; shape++)
+	{
+		SceneInit(&scene, 1);
+		TestSceneDrop(&scene, (ShapeType)shape, NUM_BODIES, &random);
+		HashSteps(&scene, FIRST_STEPS);
+		SceneSaveState(&scene, &state);
+		expected = HashSteps(&scene, BRANCH_STEPS);
+
+		/* the branch starts with contacts and pairs of its own, which the restore replaces */
+		SceneInit(&branch, 2);
+		TestSceneDrop(&branch, (ShapeType)((shape + 1) % NUM_SHAPES), NUM_BODIES, &random);
+		HashSteps(&branch, FIRST_STEPS);
+		SceneRestoreState(&branch, &state);
+		restored = HashSteps(&branch, BRANCH_STEPS);
+
+		if (!SceneStateWrite(&state, argv[1]) || !SceneStateRead(&read, argv[1]))
+		{
+			fprintf(stderr, "Cannot write and read %s\n", argv[1]);
+			return 1;
+		}
+		SceneInit(&branch, 3);
+		SceneRestoreState(&branch, &read);
+		loaded = HashSteps(&branch, BRANCH_STEPS);
+
+		if (restored != expected || loaded != expected)
+		{
+			printf("FAILED d%d: %016llx restored, %016llx read from file, expected %016llx\n", sides[shape], restored, loaded, expected);
+			failed++;
+		}
+		else
+			printf("ok d%d branch %016llx\n", sides[shape], expected);
+	}
+
+	for (i = 0; i < NUM_CORRUPTIONS; i++)
+	{
+		if (ReadsCorrupt(&state, i, argv[1]))
+		{
+			printf("FAILED corrupt snapshot %d was read\n", i);
+			failed++;
+		}
+	}
+	if (failed == 0)
+		printf("ok %d corrupt snapshots rejected\n", NUM_CORRUPTIONS);
+
+	remove(argv[1]);
+	return failed > 0;
+}
+
+/* Writes a copy of a snapshot with one thing wrong, and returns true if it is read back. */
+bool ReadsCorrupt(SceneState *state, int corruption, char *filename)
+{
+	static SceneState corrupt, read;
+
+	corrupt = *state;
+	switch (corruption)
+	{
+		case 0:
+			corrupt.objects[1].shape = NUM_SHAPES;
+			break;
+		case 1:
+			corrupt.objects[1].shape = (ShapeType)-1;
+			break;
+		case 2:
+			corrupt.objects[2].density = 0;
+			break;
+		case 3:
+			corrupt.objects[3].dimensions.y = -1;
+			break;
+		case 4:
+			corrupt.objects[4].dimensions.z = NAN;
+			break;
+		case 5:
+			corrupt.contacts[corrupt.numContacts - 1].bodyB = corrupt.numObjects;
+			break;
+	}
+
+	return SceneStateWrite(&corrupt, filename) && SceneStateRead(&read, filename);
+}
+
+/* Steps a scene and hashes the state after each step. */
+unsigned long long HashSteps(Scene *scene, int numSteps)
+{
+	static SceneState state;
+	unsigned long long hash = SCENE_HASH_SEED;
+	int i;
+
+	for (i = 0; i < numSteps; i++)
+	{
+		SceneUpdate(scene, 1.0f / 200);
+		SceneSaveState(scene, &state);
+		hash = SceneStateHash(&state, hash);
+	}
+
+	return hash;
+}
@@ -0,0 +1,152 @@
+
+#include "../Scene.h"
+#include "../Roll.h"
+#include "../MathUtils.h"
+#include "TestScene.h"
+#include "Timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_POINTS 1024
+#define NUM_DIRECTIONS 100000
+#define NUM_STEPS 2000
+
+double TimePoints(Rigidbody *rb, Random *random);
+double TimeSupport(Rigidbody *rb, bool warm);
+double TimeSteps(ShapeType shape, Random *random);
+double TimeRolls(ShapeType shape, int numRolls, double *settleTime);
+
+/* results are added up here so the queries timed can't be optimised away */
+volatile float sink;
+
+/* Times the queries and simulation of each die shape:
+ *     ./shapebench [rolls per shape]
+ * For each shape: the point distance test contacts use, the support function GJK uses
+ * started from the first vertex (cold) and from the last answer (warm) as the direction turns
+ * slowly, a step of a scene of 8 of the dice dropped as the demo drops them, and rolls of one
+ * die to rest.
+ */
+int main(int argc, char **argv)
+{
+	const int sides[NUM_SHAPES] = { 6, 4, 8, 10, 12, 20 };
+	int numRolls = argc > 1 ? atoi(argv[1]) : 20;
+	double points, cold, warm, step, roll, settleTime;
+	Rigidbody rb;
+	Random random;
+	int shape;
+
+	if (numRolls < 1)
+	{
+		fprintf(stderr, "Usage: %s [rolls per shape]\n", argv[0]);
+		return 1;
+	}
+
+	InitRandomGenerationSeed(&random, 1);
+	printf("shape verts faces  point ns  support cold ns  warm ns  step us  roll ms  settle s\n");
+
+	for (shape = 0; shape < NUM_SHAPES; shape++)
+	{
+		RBInitShape(&rb, (ShapeType)shape, Vec3New(0, 0, 0), Vec3New(1, 1, 1), 3);
+		rb.orientation = M3FromEuler(Vec3New(20, 30, 40));
+		RBCalculateVertices(&rb);
+
+		points = TimePoints(&rb, &random);
+		cold = TimeSupport(&rb, false);
+		warm = TimeSupport(&rb, true);
+		step = TimeSteps((ShapeType)shape, &random);
+		roll = TimeRolls((ShapeType)shape, numRolls, &settleTime);
+
+		printf("d%-4d %5d %5d  %8.1f  %15.1f  %7.1f  %7.1f  %7.2f  %8.2f\n", sides[shape], rb.numVerts, rb.numFaces,
+			points, cold, warm, step, roll, settleTime);
+	}
+
+	return 0;
+}
+
+/* Gets the time of a point distance test in nanoseconds, for points in and around the die. */
+double TimePoints(Rigidbody *rb, Random *random)
+{
+	Vector3 points[NUM_POINTS];
+	double start, best = 1e30;
+	float total = 0;
+	int face, i, j;
+
+	for (i = 0; i < NUM_POINTS; i++)
+		points[i] = Vec3New(GetRandomFloat(random, -0.6f, 0.6f), GetRandomFloat(random, -0.6f, 0.6f), GetRandomFloat(random, -0.6f, 0.6f));
+
+	for (j = 0; j < 5; j++)
+	{
+		start = TimingNow();
+		for (i = 0; i < NUM_POINTS * 100; i++)
+			total += RBPointDistance(rb, points[i % NUM_POINTS], Vec3New(0, 1, 0), &face);
+		best = TimingBest(best, start);
+	}
+
+	sink = total;
+	return best * 1e6 / (NUM_POINTS * 100);
+}
+
+/* Gets the time of a support query in nanoseconds, as the direction turns a little each time. */
+double TimeSupport(Rigidbody *rb, bool warm)
+{
+	static Vector3 directions[NUM_DIRECTIONS];
+	Vector3 total = Vec3New(0, 0, 0);
+	double start, best = 1e30;
+	int vertex = 0, i, j;
+
+	for (i = 0; i < NUM_DIRECTIONS; i++)
+		directions[i] = Vec3New(Cos(i * 0.001f), 0.3f, Sin(i * 0.001f));
+
+	for (j = 0; j < 5; j++)
+	{
+		start = TimingNow();
+		for (i = 0; i < NUM_DIRECTIONS; i++)
+		{
+			if (!warm)
+				vertex = 0;
+			total = Vec3Add(total, RBSupport(rb, directions[i], &vertex));
+		}
+		best = TimingBest(best, start);
+	}
+
+	sink = total.x;
+	return best * 1e6 / NUM_DIRECTIONS;
+}
+
+/* Gets the time of a step of 8 dice dropped from the demo's heights, in microseconds. */
+double TimeSteps(ShapeType shape, Random *random)
+{
+	static Scene scene;
+	double start;
+	int i;
+
+	SceneInit(&scene, 1);
+	TestSceneDrop(&scene, shape, 8, random);
+
+	start = TimingNow();
+	for (i = 0; i < NUM_STEPS; i++)
+		SceneUpdate(&scene, 1.0f / 200);
+
+	return (TimingNow() - start) * 1e3 / NUM_STEPS;
+}
+
+/* Gets the mean time to simulate a drop to rest in milliseconds, and the mean simulated time it took. */
+double TimeRolls(ShapeType shape, int numRolls, double *settleTime)
+{
+	RollParams params;
+	RollResult result;
+	double start;
+	int i;
+
+	*settleTime = 0;
+	start = TimingNow();
+	for (i = 0; i < numRolls; i++)
+	{
+		RollParamsInit(&params, i + 1, shape, Vec3New(1, 1, 1), 3, Vec3New(0, 6, 0), Vec3New(0, 0, 0), Vec3New(0, 0, 0));
+		RollSimulate(&params, &result);
+		*settleTime += result.settleTime;
+	}
+
+	*settleTime /= numRolls;
+	return (TimingNow() - start) / numRolls;
+}
@@ -0,0 +1,158 @@
+
+#include "../ImageTGA.h"
+#include "TestImage.h"
+#include "Timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPEATS 5
+
+void DecodeReference(ImageTGA *tga, unsigned char *data);
+void SwapReference(ImageTGA *tga);
+void Report(char *name, double ms, unsigned long bytes);
+
+/* Times the TGA decoder and colour swizzle on large images:
+ *     ./tgabench [width height [longest run]]
+ * Images default to 4096x4096 with runs of up to 32 pixels. RLE and raw images of both pixel sizes
+ * are built in memory and each stage is timed on its own, best of several runs, next to a
+ * pixel at a time reference that checks the results.
+ */
+int main(int argc, char **argv)
+{
+	int width = argc > 2 ? atoi(argv[1]) : 4096;
+	int height = argc > 2 ? atoi(argv[2]) : 4096;
+	int maxRun = argc > 3 ? atoi(argv[3]) : 32;
+	unsigned long numPixels = (unsigned long)width * height;
+	unsigned char *pixels, *data;
+	unsigned long size;
+	double start, decode, swap, reference, referenceSwap;
+	int pixelSize, rle, i;
+	ImageTGA tga, ref;
+	Random random;
+	char name[64];
+
+	if (width < 1 || height < 1 || width > 32767 || height > 32767 || maxRun < 1)
+	{
+		fprintf(stderr, "Usage: %s [width height [longest run]]\n", argv[0]);
+		return 1;
+	}
+
+	InitRandomGenerationSeed(&random, 1);
+	printf("%dx%d, runs of up to %d pixels\n", width, height, maxRun);
+
+	for (pixelSize = 3; pixelSize <= 4; pixelSize++)
+	{
+		pixels = (unsigned char*)malloc(numPixels * pixelSize);
+		data = (unsigned char*)malloc(TestImageMaxSize(numPixels, pixelSize));
+		TestImagePixels(&random, pixels, numPixels, pixelSize, maxRun);
+
+		for (rle = 0; rle <= 1; rle++)
+		{
+			size = TestImageBuild(data, pixels, width, height, pixelSize, rle, 0);
+			TGAReadHeader(&tga, data);
+			TGAReadHeader(&ref, data);
+			decode = swap = reference = referenceSwap = 1e30;
+
+			for (i = 0; i < REPEATS; i++)
+			{
+				start = TimingNow();
+				if (!TGADecode(&tga, data, size))
+				{
+					fprintf(stderr, "Decoding failed\n");
+					return 1;
+				}
+				decode = TimingBest(decode, start);
+
+				start = TimingNow();
+				TGABGRtoRGB(&tga);
+				swap = TimingBest(swap, start);
+
+				start = TimingNow();
+				DecodeReference(&ref, data);
+				reference = TimingBest(reference, start);
+
+				start = TimingNow();
+				SwapReference(&ref);
+				referenceSwap = TimingBest(referenceSwap, start);
+
+				if (memcmp(tga.image, pixels, tga.imageSize) != 0 || memcmp(ref.image, pixels, tga.imageSize) != 0)
+				{
+					fprintf(stderr, "Decoded image is wrong\n");
+					return 1;
+				}
+				free(tga.image);
+				free(ref.image);
+			}
+
+			sprintf(name, "%d bit %s decode", pixelSize * 8, rle ? "RLE" : "raw");
+			Report(name, decode, tga.imageSize);
+			Report("  pixel at a time", reference, tga.imageSize);
+			if (rle)
+			{
+				sprintf(name, "%d bit swizzle", pixelSize * 8);
+				Report(name, swap, tga.imageSize);
+				Report("  pixel at a time", referenceSwap, tga.imageSize);
+			}
+		}
+
+		free(data);
+		free(pixels);
+	}
+
+	return 0;
+}
+
+/* Decodes a valid image a pixel at a time with a copy per pixel, as the loader once did. */
+void DecodeReference(ImageTGA *tga, unsigned char *data)
+{
+	short pixelSize = tga->bpp/8;
+	unsigned char *cur = &data[data[0] + 18];
+	unsigned long index = 0;
+	int numPixels, i;
+
+	tga->image = (unsigned char*)malloc(tga->imageSize);
+	if (tga->encoding == RAW_RGB_ENCODING)
+	{
+		for (; index < tga->imageSize; index += pixelSize, cur += pixelSize)
+			memcpy(&tga->image[index], cur, pixelSize);
+		return;
+	}
+
+	while (index < tga->imageSize)
+	{
+		numPixels = (*cur & 0x7F) + 1;
+		if (*cur++ & 0x80)
+		{
+			for (i = 0; i < numPixels; i++, index += pixelSize)
+				memcpy(&tga->image[index], cur, pixelSize);
+			cur += pixelSize;
+		}
+		else
+		{
+			for (i = 0; i < numPixels; i++, index += pixelSize, cur += pixelSize)
+				memcpy(&tga->image[index], cur, pixelSize);
+		}
+	}
+}
+
+/* Swaps red and blue a pixel at a time. */
+void SwapReference(ImageTGA *tga)
+{
+	short pixelSize = tga->bpp/8;
+	unsigned char temp;
+	unsigned long i;
+
+	for (i = 0; i < tga->imageSize; i += pixelSize)
+	{
+		temp = tga->image[i];
+		tga->image[i] = tga->image[i + 2];
+		tga->image[i + 2] = temp;
+	}
+}
+
+/* Prints a time and the throughput it gives. */
+void Report(char *name, double ms, unsigned long bytes)
+{
+	printf("%-22s %8.2f ms %8.0f MB/s\n", name, ms, bytes / (ms * 1e3));
+}
@@ -0,0 +1,172 @@
+
+#include "../ImageTGA.h"
+#include "TestImage.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* decoding larger images only repeats the same packets, and a mutated header could ask for gigabytes */
+#define MAX_IMAGE_SIZE (1 << 22)
+
+bool CheckDecode(unsigned char *data, unsigned long size, unsigned char *pixels);
+void Mutate(Random *random, unsigned char *data, unsigned long *size);
+bool DecodeMemory(unsigned char *data, unsigned long size);
+bool DecodeFile(char *file, unsigned char *data, unsigned long size, bool *accepted);
+
+/* Feeds mutated TGA files to the decoder; 'make fuzz' runs it under the address and undefined
+ * behaviour sanitizers, which stop it at the first bad read or write:
+ *     ./tgafuzz [iterations] [seed]
+ * Raw and RLE images of both pixel sizes are built in memory and must decode to the pixels they were
+ * made from. Copies with flipped bytes, rewritten headers, oversized packets or truncated data must
+ * then either decode or be rejected. Some go through TGALoad and TGAMap from a temporary file.
+ */
+int main(int argc, char **argv)
+{
+	int iterations = argc > 1 ? atoi(argv[1]) : 20000;
+	unsigned seed = argc > 2 ? (unsigned)atoi(argv[2]) : 1;
+	char file[] = "/tmp/tgafuzzXXXXXX";
+	unsigned char *pixels, *data, *mutated;
+	unsigned long size, mutatedSize;
+	int width, height, pixelSize, fd, i;
+	int decoded = 0, failed = 0;
+	bool accepted;
+	Random random;
+
+	fd = mkstemp(file);
+	if (fd < 0)
+	{
+		fprintf(stderr, "Cannot create %s\n", file);
+		return 1;
+	}
+	close(fd);
+
+	InitRandomGenerationSeed(&random, seed);
+	for (i = 0; i < iterations; i++)
+	{
+		/* mostly small images, so each run covers many headers and packet boundaries */
+		width = GetRandomInt(&random, 1, i % 50 == 0 ? 700 : 40);
+		height = GetRandomInt(&random, 1, 40);
+		pixelSize = GetRandomInt(&random, 3, 4);
+
+		pixels = (unsigned char*)malloc((unsigned long)width * height * pixelSize);
+		data = (unsigned char*)malloc(TestImageMaxSize((unsigned long)width * height, pixelSize));
+		TestImagePixels(&random, pixels, (unsigned long)width * height, pixelSize, GetRandomInt(&random, 1, 200));
+		size = TestImageBuild(data, pixels, width, height, pixelSize, i % 2, GetRandomInt(&random, 0, 3) * 7);
+
+		if (!CheckDecode(data, size, pixels))
+		{
+			fprintf(stderr, "Iteration %d: %dx%d %d bit %s image decoded wrongly\n", i, width, height, pixelSize * 8, i % 2 ? "RLE" : "raw");
+			failed++;
+		}
+
+		/* an exact size copy, so reading past the end is caught */
+		mutatedSize = size;
+		Mutate(&random, data, &mutatedSize);
+		mutated = (unsigned char*)malloc(mutatedSize);
+		memcpy(mutated, data, mutatedSize);
+
+		if (i % 64 != 0)
+			accepted = DecodeMemory(mutated, mutatedSize);
+		else if (!DecodeFile(file, mutated, mutatedSize, &accepted))
+		{
+			fprintf(stderr, "Iteration %d: TGALoad and TGAMap disagree\n", i);
+			failed++;
+		}
+		decoded += accepted;
+
+		free(mutated);
+		free(data);
+		free(pixels);
+	}
+
+	unlink(file);
+	printf("%d inputs, %d mutated inputs decoded, %d failures\n", iterations, decoded, failed);
+	return failed > 0;
+}
+
+/* Decodes an unmutated image and compares it with its pixels. */
+bool CheckDecode(unsigned char *data, unsigned long size, unsigned char *pixels)
+{
+	ImageTGA tga;
+	bool same;
+
+	tga.image = NULL;
+	tga.mapping = NULL;
+	if (!TGAReadHeader(&tga, data) || !TGADecode(&tga, data, size))
+	{
+		TGAFree(&tga);
+		return false;
+	}
+
+	TGABGRtoRGB(&tga);
+	same = memcmp(tga.image, pixels, tga.imageSize) == 0;
+	TGAFree(&tga);
+	return same;
+}
+
+/* Damages a file in one or more of the ways a corrupt or hostile file could be. */
+void Mutate(Random *random, unsigned char *data, unsigned long *size)
+{
+	int flips = GetRandomInt(random, 0, 8);
+	int i;
+
+	for (i = 0; i < flips; i++)
+		data[GetRandomInt(random, 0, (int)*size - 1)] = (unsigned char)GetRandomInt(random, 0, 255);
+
+	/* dimensions that don't match the data */
+	if (GetRandomInt(random, 0, 3) == 0)
+		for (i = 8; i < 16; i++)
+			data[i] = (unsigned char)GetRandomInt(random, 0, 255);
+
+	/* packets that run past the image: the first byte after the header starts an RLE packet */
+	if (GetRandomInt(random, 0, 3) == 0 && *size > 18u + data[0])
+		data[18 + data[0]] = GetRandomInt(random, 0, 1) ? 0xFF : 0x7F;
+
+	/* truncated file, sometimes inside the header */
+	if (GetRandomInt(random, 0, 2) == 0)
+		*size = GetRandomInt(random, 1, (int)*size);
+}
+
+/* Decodes a file held in memory, returning whether it was accepted. */
+bool DecodeMemory(unsigned char *data, unsigned long size)
+{
+	ImageTGA tga;
+	bool result = false;
+
+	tga.image = NULL;
+	tga.mapping = NULL;
+	if (size >= 18 && TGAReadHeader(&tga, data) && tga.imageSize <= MAX_IMAGE_SIZE)
+	{
+		result = TGADecode(&tga, data, size);
+		if (result)
+			TGABGRtoRGB(&tga);
+	}
+
+	TGAFree(&tga);
+	return result;
+}
+
+/* Writes a file and loads it with both TGALoad and TGAMap, returning whether they agree on accepting it. */
+bool DecodeFile(char *file, unsigned char *data, unsigned long size, bool *accepted)
+{
+	ImageTGA tga;
+	bool mapped;
+	FILE *out = fopen(file, "wb");
+
+	*accepted = false;
+	if (out == NULL)
+		return false;
+	fwrite(data, size, 1, out);
+	fclose(out);
+
+	if (size >= 18 && TGAReadHeader(&tga, data) && tga.imageSize > MAX_IMAGE_SIZE)
+		return true;
+
+	*accepted = TGALoad(&tga, file);
+	TGAFree(&tga);
+	mapped = TGAMap(&tga, file);
+	TGAFree(&tga);
+
+	return *accepted == mapped;
+}
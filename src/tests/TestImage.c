@@ -0,0 +1,106 @@
+
+#include "TestImage.h"
+#include <string.h>
+
+/* Writes one pixel in the file's BGR(A) order. */
+static unsigned char *WritePixel(unsigned char *cur, unsigned char *pixel, int pixelSize);
+
+/* Gets the number of pixels from the start that are the same colour, up to max. */
+static int RunLength(unsigned char *pixels, unsigned long numPixels, int pixelSize, int max);
+
+void TestImagePixels(Random *random, unsigned char *pixels, unsigned long numPixels, int pixelSize, int maxRun)
+{
+	unsigned long i = 0;
+	int run, j, k;
+
+	while (i < numPixels)
+	{
+		run = GetRandomInt(random, 1, maxRun);
+		for (j = 0; j < pixelSize; j++)
+			pixels[i * pixelSize + j] = (unsigned char)GetRandomInt(random, 0, 255);
+
+		for (k = 1; k < run && i + k < numPixels; k++)
+			memcpy(&pixels[(i + k) * pixelSize], &pixels[i * pixelSize], pixelSize);
+		i += k;
+	}
+}
+
+unsigned long TestImageMaxSize(unsigned long numPixels, int pixelSize)
+{
+	/* header, longest ID and a packet header per pixel at worst */
+	return 18 + 255 + numPixels * (pixelSize + 1);
+}
+
+unsigned long TestImageBuild(unsigned char *data, unsigned char *pixels, int width, int height, int pixelSize, bool rle, int idLength)
+{
+	unsigned long numPixels = (unsigned long)width * height;
+	unsigned long i = 0;
+	unsigned char *cur;
+	int run, j;
+
+	memset(data, 0, 18);
+	data[0] = (unsigned char)idLength;
+	data[2] = rle ? 10 : 2;
+	data[12] = (unsigned char)(width & 0xFF);
+	data[13] = (unsigned char)(width >> 8);
+	data[14] = (unsigned char)(height & 0xFF);
+	data[15] = (unsigned char)(height >> 8);
+	data[16] = (unsigned char)(pixelSize * 8);
+	data[17] = pixelSize == 4 ? 8 : 0;
+	memset(&data[18], 'i', idLength);
+	cur = &data[18 + idLength];
+
+	while (i < numPixels)
+	{
+		run = RunLength(&pixels[i * pixelSize], numPixels - i, pixelSize, 128);
+
+		if (!rle)
+		{
+			cur = WritePixel(cur, &pixels[i * pixelSize], pixelSize);
+			i++;
+		}
+		else if (run > 1)
+		{
+			*cur++ = (unsigned char)(0x80 | (run - 1));
+			cur = WritePixel(cur, &pixels[i * pixelSize], pixelSize);
+			i += run;
+		}
+		else
+		{
+			/* raw packet up to the next run */
+			for (run = 1; run < 128 && i + run < numPixels; run++)
+				if (RunLength(&pixels[(i + run) * pixelSize], numPixels - i - run, pixelSize, 2) > 1)
+					break;
+
+			*cur++ = (unsigned char)(run - 1);
+			for (j = 0; j < run; j++)
+				cur = WritePixel(cur, &pixels[(i + j) * pixelSize], pixelSize);
+			i += run;
+		}
+	}
+
+	return cur - data;
+}
+
+/* Writes one pixel in the file's BGR(A) order. */
+static unsigned char *WritePixel(unsigned char *cur, unsigned char *pixel, int pixelSize)
+{
+	cur[0] = pixel[2];
+	cur[1] = pixel[1];
+	cur[2] = pixel[0];
+	if (pixelSize == 4)
+		cur[3] = pixel[3];
+
+	return cur + pixelSize;
+}
+
+/* Gets the number of pixels from the start that are the same colour, up to max. */
+static int RunLength(unsigned char *pixels, unsigned long numPixels, int pixelSize, int max)
+{
+	int run = 1;
+
+	while (run < max && (unsigned long)run < numPixels && memcmp(&pixels[run * pixelSize], pixels, pixelSize) == 0)
+		run++;
+
+	return run;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file	TestImage.h
+ * @brief	Builds TGA files in memory for the decoder fuzz test and benchmark.
+ */
+
+#ifndef TESTIMAGE_H
+#define TESTIMAGE_H
+
+#include "../MathUtils.h"
+#include "../Boolean.h"
+
+/**
+ * @brief	Fills an image with random pixels in runs, so it has both RLE packet types.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	random		The generator.
+ * @param 	pixels		The pixels, in RGB(A) order.
+ * @param 	numPixels	The number of pixels.
+ * @param 	pixelSize	3 or 4.
+ * @param 	maxRun		The longest run of one colour.
+ */
+void TestImagePixels(Random *random, unsigned char *pixels, unsigned long numPixels, int pixelSize, int maxRun);
+
+/**
+ * @brief	Gets the most bytes a TGA file built by TestImageBuild can take.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	numPixels	The number of pixels.
+ * @param 	pixelSize	3 or 4.
+ * @return	The size in bytes.
+ */
+unsigned long TestImageMaxSize(unsigned long numPixels, int pixelSize);
+
+/**
+ * @brief	Writes an image as a TGA file.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	data		The file data, TestImageMaxSize bytes.
+ * @param 	pixels		The pixels, in RGB(A) order.
+ * @param 	width		The width.
+ * @param 	height		The height.
+ * @param 	pixelSize	3 or 4.
+ * @param 	rle			true for run length encoded data, false for raw.
+ * @param 	idLength	Length of the image ID field between the header and the pixels.
+ * @return	The size of the file in bytes.
+ */
+unsigned long TestImageBuild(unsigned char *data, unsigned char *pixels, int width, int height, int pixelSize, bool rle, int idLength);
+
+#endif
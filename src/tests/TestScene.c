@@ -0,0 +1,32 @@
+
+#include "TestScene.h"
+#include <string.h>
+
+void TestSceneDrop(Scene *scene, ShapeType shape, int count, Random *random)
+{
+	RigidbodyState states[MAX_OBJECTS];
+	Vector3 rotation;
+	float size;
+	int i;
+
+	memset(states, 0, sizeof(states));
+	for (i = 0; i < count; i++)
+	{
+		size = GetRandomFloat(random, 0.5f, 1);
+		states[i].position.x = GetRandomFloat(random, -1.2f, 1.2f);
+		states[i].position.y = GetRandomFloat(random, 5, 20);
+		states[i].position.z = GetRandomFloat(random, -1, 1);
+		rotation.x = GetRandomFloat(random, 0, 90);
+		rotation.y = GetRandomFloat(random, 0, 90);
+		rotation.z = GetRandomFloat(random, 0, 90);
+
+		states[i].shape = shape;
+		states[i].density = 3;
+		states[i].dimensions = Vec3New(size, size, size);
+		states[i].orientation = M3FromEuler(rotation);
+	}
+
+	scene->numObjects = 0;
+	SceneResetContacts(scene);
+	SceneSpawnRigidbodys(scene, states, count);
+}
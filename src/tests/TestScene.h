@@ -0,0 +1,23 @@
+/**
+ * @file	TestScene.h
+ * @brief	Scenes of dropped dice for the tests and benchmarks.
+ */
+
+#ifndef TESTSCENE_H
+#define TESTSCENE_H
+
+#include "../Scene.h"
+
+/**
+ * @brief	Replaces a scene's bodies with dice dropped from the demo's heights.
+ * @details	Sizes, positions and orientations are drawn as DemoCreateRigidbodys draws them.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	scene 	The scene.
+ * @param 	shape 	The shape of the dice.
+ * @param 	count 	The number of dice, at most MAX_OBJECTS.
+ * @param 	random	The generator.
+ */
+void TestSceneDrop(Scene *scene, ShapeType shape, int count, Random *random);
+
+#endif
@@ -0,0 +1,18 @@
+
+#include "Timing.h"
+#include <time.h>
+
+double TimingNow(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+double TimingBest(double best, double start)
+{
+	double time = TimingNow() - start;
+
+	return time < best ? time : best;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file	Timing.h
+ * @brief	Wall clock timing for the benchmarks.
+ */
+
+#ifndef TIMING_H
+#define TIMING_H
+
+/**
+ * @brief	Gets a monotonic time.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @return	The time in milliseconds.
+ */
+double TimingNow(void);
+
+/**
+ * @brief	Keeps the best of several timed runs.
+ * @details	Noise only ever makes a run slower, so the fastest is the most repeatable.
+ * @author	Matt Drage
+ * @date	19/10/2026
+ * @param 	best 	The best time so far, in milliseconds.
+ * @param 	start	When this run started, from TimingNow.
+ * @return	The better of best and this run's time.
+ */
+double TimingBest(double best, double start);
+
+#endif
@@ -0,0 +1,215 @@
+
+#include "../Trajectory.h"
+#include "../MathUtils.h"
+#include "TestScene.h"
+#include <stdio.h>
+#include <math.h>
+
+#define NUM_BODIES 8
+#define NUM_FRAMES 300
+#define JUMP_FRAME 100
+#define REMOVE_FRAME 200
+#define NUM_ORIENTATIONS 100000
+
+float OrientationError(Matrix3x3 a, Matrix3x3 b);
+float PackError(Random *random);
+bool PlaysBack(Trajectory *trajectory, int frame);
+void Check(bool passed, char *name);
+
+/* 15 bits over [-1/sqrt2, 1/sqrt2] per quaternion component, as the largest difference
+ * between elements of the rotation matrices */
+static const float MAX_ORIENTATION_ERROR = 2e-4f;
+
+/* what was recorded, frame by frame */
+static Vector3 positions[NUM_FRAMES][NUM_BODIES];
+static Matrix3x3 orientations[NUM_FRAMES][NUM_BODIES];
+static int numBodies[NUM_FRAMES];
+
+/* checks failed so far */
+static int failed = 0;
+
+/* Checks the trajectory format:
+ *     ./trajectorytest <trajectory file>
+ * Orientations are packed and unpacked, then 8 d8s are dropped and recorded settling for 300
+ * frames. On frame 100 one is lifted further than a delta can move it and on frame 200 one is
+ * removed, and both must start a keyframe. The file must be the promised size, and every frame,
+ * played from the start or sought to across keyframes, must be within 1/4096 of the recorded
+ * position on each axis and within the packing error of the orientation.
+ */
+int main(int argc, char **argv)
+{
+	const int seeks[] = { 150, 0, 63, 64, 65, 99, 100, 101, 170, 199, 200, 201, 299, 1, 264 };
+	static Scene scene;
+	Trajectory trajectory;
+	float error;
+	long size, expected;
+	int frame, i, key;
+	bool exact;
+	FILE *file;
+	Random random;
+
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s <trajectory file>\n", argv[0]);
+		return 1;
+	}
+
+	InitRandomGenerationSeed(&random, 1);
+	error = PackError(&random);
+	printf("largest packed orientation error %g\n", error);
+	Check(error <= MAX_ORIENTATION_ERROR, "orientation packing round trip");
+
+	SceneInit(&scene, 1);
+	TestSceneDrop(&scene, SHAPE_D8, NUM_BODIES, &random);
+	Check(TrajectoryCreate(&trajectory, argv[1], 1.0f / 200), "trajectory created");
+	for (frame = 0; frame < NUM_FRAMES; frame++)
+	{
+		/* a delta holds at most 8 units */
+		if (frame == JUMP_FRAME)
+			scene.objects[0].position.y += 10;
+		if (frame == REMOVE_FRAME)
+			SceneRemoveRigidbody(&scene, NUM_BODIES - 1);
+
+		SceneUpdate(&scene, 1.0f / 200);
+		numBodies[frame] = scene.numObjects;
+		for (i = 0; i < scene.numObjects; i++)
+		{
+			positions[frame][i] = scene.objects[i].position;
+			orientations[frame][i] = scene.objects[i].orientation;
+		}
+		TrajectoryRecord(&trajectory, &scene);
+	}
+	TrajectoryClose(&trajectory);
+
+	if (!TrajectoryOpen(&trajectory, argv[1]))
+	{
+		fprintf(stderr, "Cannot open %s\n", argv[1]);
+		return 1;
+	}
+
+	/* keyframes every interval, counted again from each forced one */
+	exact = trajectory.numFrames == NUM_FRAMES;
+	for (frame = 0, i = 0, key = 0; frame < NUM_FRAMES && exact; frame++)
+	{
+		if (frame == 0 || frame == JUMP_FRAME || frame == REMOVE_FRAME || frame - key == TRAJECTORY_KEYFRAME_INTERVAL)
+		{
+			key = frame;
+			exact = i < trajectory.numKeyframes && trajectory.keyframeFrames[i++] == frame;
+		}
+	}
+	Check(exact && i == trajectory.numKeyframes, "keyframes on the interval, a jump and a removal");
+
+	/* the header, then a type and body count and each body's keyframe or delta */
+	expected = 16;
+	for (frame = 0, key = 0; frame < NUM_FRAMES; frame++)
+	{
+		if (key < trajectory.numKeyframes && trajectory.keyframeFrames[key] == frame)
+		{
+			expected += 3 + numBodies[frame] * TRAJECTORY_KEYFRAME_BODY_SIZE;
+			key++;
+		}
+		else
+			expected += 3 + numBodies[frame] * TRAJECTORY_DELTA_BODY_SIZE;
+	}
+	file = fopen(argv[1], "rb");
+	size = file != NULL && fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+	if (file)
+		fclose(file);
+	printf("%ld bytes, %.1f per body per step\n", size, (double)size / (NUM_FRAMES * NUM_BODIES));
+	Check(size == expected, "12 bytes per body per delta step");
+
+	exact = true;
+	for (frame = 0; frame < NUM_FRAMES && exact; frame++)
+		exact = PlaysBack(&trajectory, frame);
+	Check(exact, "every frame played from the start");
+
+	exact = true;
+	for (i = 0; i < (int)(sizeof(seeks) / sizeof(seeks[0])) && exact; i++)
+		exact = TrajectorySeek(&trajectory, seeks[i]) && PlaysBack(&trajectory, seeks[i]);
+	Check(exact, "frames sought to across keyframes");
+	Check(!TrajectorySeek(&trajectory, NUM_FRAMES) && !TrajectorySeek(&trajectory, -1), "seek past the ends refused");
+
+	TrajectoryClose(&trajectory);
+	remove(argv[1]);
+	return failed > 0;
+}
+
+/* Gets the largest difference between elements of two rotation matrices. */
+float OrientationError(Matrix3x3 a, Matrix3x3 b)
+{
+	float error = 0;
+	int i, j;
+
+	for (i = 0; i < 3; i++)
+		for (j = 0; j < 3; j++)
+			error = fmaxf(error, fabsf(a.elements[i][j] - b.elements[i][j]));
+
+	return error;
+}
+
+/* Gets the largest orientation error of packing and unpacking random orientations, and those
+ * with a largest component of either sign in each place. */
+float PackError(Random *random)
+{
+	unsigned char data[6];
+	Matrix3x3 orientation;
+	float q[4], length, error = 0;
+	int i, j;
+
+	for (i = 0; i < NUM_ORIENTATIONS; i++)
+	{
+		if (i < 8)
+		{
+			for (j = 0; j < 4; j++)
+				q[j] = j == i / 2 ? (i % 2 ? -0.8f : 0.8f) : 0.3464f;
+		}
+		else
+		{
+			for (j = 0; j < 4; j++)
+				q[j] = GetRandomFloat(random, -1, 1);
+		}
+
+		length = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+		for (j = 0; j < 4; j++)
+			q[j] /= length;
+
+		orientation = M3FromQuaternion(q);
+		TrajectoryPackOrientation(orientation, data);
+		error = fmaxf(error, OrientationError(orientation, TrajectoryUnpackOrientation(data)));
+	}
+
+	return error;
+}
+
+/* true if the next frame played is the given recorded frame, within the quantisation error. */
+bool PlaysBack(Trajectory *trajectory, int frame)
+{
+	static Scene scene;
+	Vector3 position;
+	int i;
+
+	if (!TrajectoryPlay(trajectory, &scene) || scene.numObjects != numBodies[frame])
+		return false;
+
+	for (i = 0; i < scene.numObjects; i++)
+	{
+		position = scene.objects[i].position;
+		if (fabsf(position.x - positions[frame][i].x) > 1.0f / 4096 || fabsf(position.y - positions[frame][i].y) > 1.0f / 4096 ||
+			fabsf(position.z - positions[frame][i].z) > 1.0f / 4096 ||
+			OrientationError(scene.objects[i].orientation, orientations[frame][i]) > MAX_ORIENTATION_ERROR)
+		{
+			printf("frame %d body %d is off\n", frame, i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Reports a check. */
+void Check(bool passed, char *name)
+{
+	printf("%s %s\n", passed ? "ok" : "FAILED", name);
+	if (!passed)
+		failed++;
+}
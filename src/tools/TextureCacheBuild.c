@@ -0,0 +1,65 @@
+#include "../TextureCache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+
+int CompareNames(const void *a, const void *b);
+
+/* Builds <assets dir>/textures.cache from every TGA file in the directory.
+ * Run from the bin directory so cached paths match the ones the demo loads:
+ *     ./texcache Assets
+ */
+int main(int argc, char **argv)
+{
+	char cacheFile[1024];
+	char **files = NULL;
+	int numFiles = 0;
+	struct dirent *entry;
+	size_t length;
+	DIR *dir;
+
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s <assets directory>\n", argv[0]);
+		return 1;
+	}
+
+	dir = opendir(argv[1]);
+	if (dir == NULL)
+	{
+		fprintf(stderr, "Cannot open %s\n", argv[1]);
+		return 1;
+	}
+
+	while ((entry = readdir(dir)) != NULL)
+	{
+		length = strlen(entry->d_name);
+		if (length < 4 || strcmp(entry->d_name + length - 4, ".tga") != 0)
+			continue;
+
+		files = (char**)realloc(files, (numFiles + 1) * sizeof(char*));
+		files[numFiles] = (char*)malloc(strlen(argv[1]) + length + 2);
+		sprintf(files[numFiles], "%s/%s", argv[1], entry->d_name);
+		numFiles++;
+	}
+	closedir(dir);
+
+	/* stable order so rebuilding an unchanged directory gives an identical file */
+	qsort(files, numFiles, sizeof(char*), CompareNames);
+
+	snprintf(cacheFile, sizeof(cacheFile), "%s/textures.cache", argv[1]);
+	if (!TextureCacheBuild(cacheFile, files, numFiles))
+	{
+		fprintf(stderr, "Failed to build %s\n", cacheFile);
+		return 1;
+	}
+
+	printf("Cached %d textures in %s\n", numFiles, cacheFile);
+	return 0;
+}
+
+int CompareNames(const void *a, const void *b)
+{
+	return strcmp(*(char**)a, *(char**)b);
+}